@@ -0,0 +1,31 @@
+#include <iostream>
+#include <ctime>
+#include "../dw_stl/cow_vector.h"
+#include "../dw_stl/vector.h"
+
+int main()
+{
+    // 每次修改一个元素之后发布一份快照，上一份快照在修改时仍然被持有
+    dw_stl::cow_vector<int> cv(1000000, 1);
+    dw_stl::cow_vector<int> published = cv.snapshot();
+    double start = clock();
+    for (int i = 0; i < 10000; ++i)
+    {
+        cv.set(i * 97 % cv.size(), i);
+        published = cv.snapshot();
+    }
+    double end = clock();
+    std::cout << "cow_vector: " << (end - start) / CLOCKS_PER_SEC << "ms" << std::endl;
+
+    dw_stl::vector<int> v(1000000, 1);
+    dw_stl::vector<int> copy(v);
+    start = clock();
+    for (int i = 0; i < 10000; ++i)
+    {
+        v[i * 97 % v.size()] = i;
+        copy = v;
+    }
+    end = clock();
+    std::cout << "vector: " << (end - start) / CLOCKS_PER_SEC << "ms" << std::endl;
+    return 0;
+}
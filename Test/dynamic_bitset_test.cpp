@@ -0,0 +1,24 @@
+#include <iostream>
+#include <ctime>
+#include "../dw_stl/dynamic_bitset.h"
+
+int main()
+{
+    // 两个 1 亿行的可见性掩码，按位与之后统计并遍历可见的行
+    const size_t rows = 100000000;
+    double start = clock();
+    dw_stl::dynamic_bitset visible(rows), deleted(rows);
+    for (size_t i = 0; i < rows; i += 3)
+        visible.set(i);
+    for (size_t i = 0; i < rows; i += 7)
+        deleted.set(i);
+    visible.andnot(deleted);
+    size_t total = 0;
+    for (size_t pos = visible.find_first(); pos != dw_stl::dynamic_bitset::npos; pos = visible.find_next(pos))
+        ++total;
+    std::cout << visible.count() << " " << total << std::endl;
+    double end = clock();
+    double t = (end - start) / CLOCKS_PER_SEC;
+    std::cout << t << "ms" << std::endl;
+    return 0;
+}
@@ -0,0 +1,21 @@
+#include <iostream>
+#include <ctime>
+#include "../dw_stl/incremental_vector.h"
+
+int main()
+{
+    // 扩容之后旧空间中的元素随后续的 push_back 逐步迁移，统计处于迁移中的 push_back 次数
+    dw_stl::incremental_vector<int> v;
+    size_t migrating = 0;
+    double start = clock();
+    for (int i = 0; i < 50000000; ++i)
+    {
+        v.push_back(i);
+        migrating += v.migrating();
+    }
+    std::cout << v.size() << " " << migrating << std::endl;
+    double end = clock();
+    double total = (end - start) / CLOCKS_PER_SEC;
+    std::cout << total << "ms" << std::endl;
+    return 0;
+}
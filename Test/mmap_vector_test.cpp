@@ -0,0 +1,28 @@
+#include <iostream>
+#include <cstdio>
+#include <ctime>
+#include "../dw_stl/mmap_vector.h"
+
+int main()
+{
+    // 写入之后关闭，重新打开时直接映射文件，不需要重新构建
+    const char* path = "mmap_vector_test.bin";
+    double start = clock();
+    {
+        dw_stl::mmap_vector<int> v(path, dw_stl::mmap_vector_mode::create);
+        for (int i = 0; i < 50000000; ++i)
+            v.push_back(i);
+    }
+    long long sum = 0;
+    {
+        dw_stl::mmap_vector<int> v(path, dw_stl::mmap_vector_mode::read_only);
+        for (auto x : v)
+            sum += x;
+        std::cout << v.size() << " " << sum << std::endl;
+    }
+    double end = clock();
+    std::remove(path);
+    double total = (end - start) / CLOCKS_PER_SEC;
+    std::cout << total << "ms" << std::endl;
+    return 0;
+}
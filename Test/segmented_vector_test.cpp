@@ -0,0 +1,23 @@
+#include <iostream>
+#include <ctime>
+#include "../dw_stl/segmented_vector.h"
+
+int main()
+{
+    // 追加时不迁移已有的元素，之后按段遍历
+    dw_stl::segmented_vector<int> v;
+    double start = clock();
+    for (int i = 0; i < 50000000; ++i)
+        v.push_back(i);
+    long long sum = 0;
+    v.for_each_segment([&](const int* first, const int* last)
+    {
+        for (; first != last; ++first)
+            sum += *first;
+    });
+    std::cout << v.size() << " " << sum << std::endl;
+    double end = clock();
+    double total = (end - start) / CLOCKS_PER_SEC;
+    std::cout << total << "ms" << std::endl;
+    return 0;
+}
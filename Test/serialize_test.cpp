@@ -0,0 +1,33 @@
+#include <iostream>
+#include <cstdio>
+#include <ctime>
+#include "../dw_stl/serialize.h"
+
+int main()
+{
+    // 保存一个vector与一个deque，再读回来
+    const char* path = "serialize_test.bin";
+    dw_stl::vector<int> v;
+    dw_stl::deque<int> d;
+    for (int i = 0; i < 20000000; ++i)
+    {
+        v.push_back(i);
+        d.push_back(i);
+    }
+    double start = clock();
+    int fd = ::open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    dw_stl::save(fd, v);
+    dw_stl::save(fd, d);
+    ::lseek(fd, 0, SEEK_SET);
+    dw_stl::vector<int> v2;
+    dw_stl::deque<int> d2;
+    dw_stl::load(fd, v2);
+    dw_stl::load(fd, d2);
+    ::close(fd);
+    double end = clock();
+    std::cout << v2.size() << " " << d2.size() << " " << v2.back() + d2.back() << std::endl;
+    std::remove(path);
+    double total = (end - start) / CLOCKS_PER_SEC;
+    std::cout << total << "ms" << std::endl;
+    return 0;
+}
@@ -0,0 +1,28 @@
+#include <iostream>
+#include <ctime>
+#include "../dw_stl/small_vector.h"
+
+int main()
+{
+    // 大量元素个数很少的vector，元素都放在内部缓冲区中，不需要申请内存
+    size_t total_size = 0;
+    double start = clock();
+    for (int i = 0; i < 5000000; ++i)
+    {
+        dw_stl::small_vector<int, 8> v;
+        for (int j = 0; j < 8; ++j)
+            v.push_back(i + j);
+        total_size += v.size();
+    }
+    std::cout << total_size << std::endl;
+    dw_stl::small_vector<int, 8> v1;
+    for (int i = 0; i < 50000000; ++i)
+    {
+        v1.push_back(i);
+    }
+    std::cout << v1.size() << std::endl;
+    double end = clock();
+    double total = (end - start) / CLOCKS_PER_SEC;
+    std::cout << total << "ms" << std::endl;
+    return 0;
+}
@@ -0,0 +1,58 @@
+#include <iostream>
+#include <ctime>
+#include <memory>
+#include "../dw_stl/soa_vector.h"
+#include "../dw_stl/vector.h"
+
+struct record
+{
+    double f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11;
+};
+
+int main()
+{
+    // 每条记录12个字段，扫描时只读取其中的2个
+    const int n = 2000000;
+    dw_stl::vector<record> aos;
+    dw_stl::soa_vector<double, double, double, double, double, double,
+                       double, double, double, double, double, double> soa;
+    for (int i = 0; i < n; ++i)
+    {
+        const double d = i;
+        aos.push_back(record{d, d, d, d, d, d, d, d, d, d, d, d});
+        soa.emplace_back(d, d, d, d, d, d, d, d, d, d, d, d);
+    }
+
+    double sum = 0;
+    double start = clock();
+    for (int r = 0; r < 20; ++r)
+        for (int i = 0; i < n; ++i)
+            sum += aos[i].f3 * aos[i].f7;
+    double end = clock();
+    std::cout << "vector: " << (end - start) / CLOCKS_PER_SEC << "ms" << std::endl;
+
+    start = clock();
+    for (int r = 0; r < 20; ++r)
+    {
+        const double* a = soa.data<3>();
+        const double* b = soa.data<7>();
+        for (int i = 0; i < n; ++i)
+            sum -= a[i] * b[i];
+    }
+    end = clock();
+    std::cout << "soa_vector: " << (end - start) / CLOCKS_PER_SEC << "ms" << std::endl;
+    std::cout << sum << std::endl;
+
+    // 只能移动的列：扩容时整列迁移，不复制
+    dw_stl::soa_vector<int, std::unique_ptr<int>> owned;
+    start = clock();
+    for (int i = 0; i < n; ++i)
+        owned.emplace_back(i, std::unique_ptr<int>(new int(i)));
+    end = clock();
+    std::cout << "soa_vector<int, unique_ptr<int>>: " << (end - start) / CLOCKS_PER_SEC << "ms" << std::endl;
+    long long check = 0;
+    for (size_t i = 0; i < owned.size(); ++i)
+        check += owned.get<0>(i) - *owned.get<1>(i);
+    std::cout << check << std::endl;
+    return 0;
+}
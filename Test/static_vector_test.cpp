@@ -0,0 +1,21 @@
+#include <iostream>
+#include <ctime>
+#include "../dw_stl/static_vector.h"
+
+int main()
+{
+    // 容量固定的批次，整个过程不申请内存
+    size_t total_size = 0;
+    double start = clock();
+    for (int i = 0; i < 1000000; ++i)
+    {
+        dw_stl::static_vector<int, 64> batch;
+        while (batch.try_push_back(i) != nullptr) {}
+        total_size += batch.size();
+    }
+    std::cout << total_size << std::endl;
+    double end = clock();
+    double total = (end - start) / CLOCKS_PER_SEC;
+    std::cout << total << "ms" << std::endl;
+    return 0;
+}
@@ -45,5 +45,25 @@ namespace dw_stl
     {
         dw_stl::reverse_dispatch(first, last, iterator_category(first));
     }
+
+    /*****************************************************************************************/
+    // rotate
+    // 将[first, middle)内的元素与[middle, last)内的元素互换，返回原来的first移动之后的位置
+    // 用三次反转实现，只需要双向迭代器
+    /*****************************************************************************************/
+    template <class BidirectionalIter>
+    BidirectionalIter rotate(BidirectionalIter first, BidirectionalIter middle, BidirectionalIter last)
+    {
+        if (first == middle)
+            return last;
+        if (middle == last)
+            return first;
+        dw_stl::reverse(first, middle);
+        dw_stl::reverse(middle, last);
+        dw_stl::reverse(first, last);
+        auto result = first;
+        dw_stl::advance(result, dw_stl::distance(middle, last));
+        return result;
+    }
 }
 #endif
\ No newline at end of file
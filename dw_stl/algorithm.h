@@ -206,7 +206,7 @@ namespace dw_stl
     /*******************************************************************/
     // move_cat_dispatch的input_iterator_tag版本
     template <class InputIter, class OutputIter>
-    OutputIter move_cat_dispatch(InputIter first, OutputIter last, OutputIter result,
+    OutputIter move_cat_dispatch(InputIter first, InputIter last, OutputIter result,
                                   dw_stl::input_iterator_tag)
     {
         for (; first != last; ++first, ++result)
@@ -263,7 +263,7 @@ namespace dw_stl
                                                   BidirectionalIter2 result, dw_stl::bidirectional_iterator_tag)
     {
         while (first != last)
-            *--result = dw_stl::move(*last);
+            *--result = dw_stl::move(*--last);
         return result;
     }
 
@@ -389,7 +389,7 @@ namespace dw_stl
                     dw_stl::random_access_iterator_tag)
     {
         // 直接调用fill_n函数
-        fill_n(first, last - first, value);
+        dw_stl::fill_n(first, last - first, value);
     }
 
     // fill函数接口
@@ -0,0 +1,159 @@
+#ifndef DW_STL_ALIGNED_ALLOC_H_
+#define DW_STL_ALIGNED_ALLOC_H_
+
+/*
+这个头文件实现了按指定字节数对齐的内存分配，用于 SIMD 数据(AVX2 需要 32 字节，AVX-512 需要 64 字节)
+以及需要按缓存行隔离、避免伪共享(false sharing)的数据
+
+::operator new 只保证 alignof(std::max_align_t) 字节对齐，超过这个值时：
+    支持 C++17 aligned new 的编译器使用 ::operator new(bytes, std::align_val_t)
+    否则多申请一些空间，把原始指针保存在返回地址的前面
+
+实现了以下内容：
+aligned_alloc                       : 按字节分配与释放对齐的内存
+aligned_allocator<T, Align>         : 按 max(Align, alignof(T)) 字节对齐的分配器，可以作为容器的 Alloc 模板参数
+cacheline_aligned_allocator<T>      : 按缓存行对齐的分配器，例如 vector<float, cacheline_aligned_allocator<float>>
+cacheline_padded<T>                 : 独占一个缓存行的对象包装，例如每个线程一个计数器
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+#include "util.h"
+
+namespace dw_stl
+{
+    // 缓存行的字节数
+    #ifndef DW_STL_CACHELINE_SIZE
+    #define DW_STL_CACHELINE_SIZE 64
+    #endif
+
+    class aligned_alloc
+    {
+    public:
+        // ::operator new 默认保证的对齐字节数
+        static constexpr size_t default_align = alignof(std::max_align_t);
+
+        // alignment 必须是 2 的幂，释放时传入的 alignment 必须与分配时相同
+        static void* allocate(size_t bytes, size_t alignment);
+        static void  deallocate(void* ptr, size_t alignment) noexcept;
+
+        static constexpr bool is_over_aligned(size_t alignment) noexcept
+        { return alignment > default_align; }
+    };
+
+    inline void* aligned_alloc::allocate(size_t bytes, size_t alignment)
+    {
+        if (!is_over_aligned(alignment))
+            return ::operator new(bytes);
+#if defined(__cpp_aligned_new)
+        return ::operator new(bytes, static_cast<std::align_val_t>(alignment));
+#else
+        void* raw = ::operator new(bytes + alignment + sizeof(void*));
+        uintptr_t addr = reinterpret_cast<uintptr_t>(raw) + sizeof(void*);
+        addr = (addr + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+        reinterpret_cast<void**>(addr)[-1] = raw;
+        return reinterpret_cast<void*>(addr);
+#endif
+    }
+
+    inline void aligned_alloc::deallocate(void* ptr, size_t alignment) noexcept
+    {
+        if (ptr == nullptr)
+            return;
+        if (!is_over_aligned(alignment))
+        {
+            ::operator delete(ptr);
+            return;
+        }
+#if defined(__cpp_aligned_new)
+        ::operator delete(ptr, static_cast<std::align_val_t>(alignment));
+#else
+        ::operator delete(reinterpret_cast<void**>(ptr)[-1]);
+#endif
+    }
+
+    /*****************************************************************************************/
+    // 模板类 aligned_allocator
+    // 分配的每一块内存都按 max(Align, alignof(T)) 字节对齐，rebind 之后保持同样的 Align
+    /*****************************************************************************************/
+    template <class T, size_t Align = alignof(T)>
+    class aligned_allocator
+    {
+        static_assert((Align & (Align - 1)) == 0, "Align should be a power of 2");
+
+    public:
+        typedef T           value_type;
+        typedef T*          pointer;
+        typedef const T*    const_pointer;
+        typedef size_t      size_type;
+        typedef ptrdiff_t   difference_type;
+
+        typedef std::true_type  propagate_on_container_move_assignment;
+        typedef std::true_type  is_always_equal;
+
+        template <class U>
+        struct rebind
+        {
+            typedef aligned_allocator<U, Align> other;
+        };
+
+        // 实际使用的对齐字节数
+        static constexpr size_t alignment = Align > alignof(T) ? Align : alignof(T);
+
+        aligned_allocator() noexcept = default;
+        template <class U>
+        aligned_allocator(const aligned_allocator<U, Align>&) noexcept {}
+
+        static T* allocate(size_type n)
+        {
+            if (n == 0)
+                return nullptr;
+            return static_cast<T*>(aligned_alloc::allocate(n * sizeof(T), alignment));
+        }
+
+        static void deallocate(T* ptr, size_type)
+        {
+            aligned_alloc::deallocate(ptr, alignment);
+        }
+    };
+
+    template <class T, class U, size_t Align>
+    bool operator==(const aligned_allocator<T, Align>&, const aligned_allocator<U, Align>&) noexcept
+    {
+        return true;
+    }
+
+    template <class T, class U, size_t Align>
+    bool operator!=(const aligned_allocator<T, Align>&, const aligned_allocator<U, Align>&) noexcept
+    {
+        return false;
+    }
+
+    // 缓存行对齐的分配器，vector 与 deque 的缓冲区从缓存行的边界开始
+    template <class T>
+    using cacheline_aligned_allocator = aligned_allocator<T, DW_STL_CACHELINE_SIZE>;
+
+    /*****************************************************************************************/
+    // 模板类 cacheline_padded
+    // 对象按缓存行对齐并且大小是缓存行的整数倍，数组中相邻的两个对象不会位于同一个缓存行
+    /*****************************************************************************************/
+    template <class T>
+    struct alignas(DW_STL_CACHELINE_SIZE) cacheline_padded
+    {
+        T value;
+
+        cacheline_padded() = default;
+
+        cacheline_padded(const T& v) : value(v) {}
+        cacheline_padded(T&& v) : value(dw_stl::move(v)) {}
+
+        T&       operator*() noexcept       { return value; }
+        const T& operator*() const noexcept { return value; }
+        T*       operator->() noexcept       { return &value; }
+        const T* operator->() const noexcept { return &value; }
+    };
+}
+
+#endif
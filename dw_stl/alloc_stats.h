@@ -0,0 +1,393 @@
+#ifndef DW_STL_ALLOC_STATS_H_
+#define DW_STL_ALLOC_STATS_H_
+
+/*
+这个头文件实现了内存分配的统计，用于查找内存膨胀以及比较不同分配器的效果
+每一组统计记录 allocate / deallocate 的次数、当前占用字节数、峰值字节数、累计字节数，
+以及按 2 的幂划分的分配大小直方图，所有计数都是原子操作，可以在多线程中使用
+
+实现了以下内容：
+alloc_stats                           : 一组统计数据
+alloc_stats_registry                  : 所有统计的登记表，可以按名字查询，或者输出到文件
+alloc_tag::vector / deque / deque_map / priority_queue / other
+                                      : 统计的标签，每个标签对应一组统计
+tracking_allocator<T, Tag, Base>      : 把请求转发给 Base 并记录到 Tag 对应的统计中
+pmr::tracking_resource                : 把请求转发给上游资源并记录统计的 memory_resource
+
+例如：
+    dw_stl::vector<int, dw_stl::tracking_allocator<int, dw_stl::alloc_tag::vector>> v;
+    dw_stl::deque<int, dw_stl::tracking_allocator<int, dw_stl::alloc_tag::deque>> d;   // map 记在 deque_map 中
+    dw_stl::alloc_stats_registry::dump("alloc_stats.txt");
+*/
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <atomic>
+#include <mutex>
+
+#include "allocator.h"
+#include "allocator_traits.h"
+#include "memory_resource.h"
+
+namespace dw_stl
+{
+    // 直方图的桶数，第 i 个桶统计大小在 (2^(i-1), 2^i] 之间的请求，最后一个桶统计更大的请求
+    #ifndef DW_STL_ALLOC_STATS_BUCKETS
+    #define DW_STL_ALLOC_STATS_BUCKETS 32
+    #endif
+
+    /*****************************************************************************************/
+    // alloc_stats
+    /*****************************************************************************************/
+    class alloc_stats
+    {
+    public:
+        static constexpr size_t nbuckets = DW_STL_ALLOC_STATS_BUCKETS;
+
+        explicit alloc_stats(const char* name = "") noexcept
+            : name_(name)
+        {
+            reset();
+        }
+
+        alloc_stats(const alloc_stats&) = delete;
+        alloc_stats& operator=(const alloc_stats&) = delete;
+
+        const char* name() const noexcept { return name_; }
+
+        size_t allocate_count() const noexcept   { return allocs_.load(std::memory_order_relaxed); }
+        size_t deallocate_count() const noexcept { return deallocs_.load(std::memory_order_relaxed); }
+        size_t live_bytes() const noexcept       { return live_.load(std::memory_order_relaxed); }
+        size_t peak_bytes() const noexcept       { return peak_.load(std::memory_order_relaxed); }
+        size_t total_bytes() const noexcept      { return total_.load(std::memory_order_relaxed); }
+        size_t bucket_count(size_t i) const noexcept
+        { return i < nbuckets ? hist_[i].load(std::memory_order_relaxed) : 0; }
+
+        // 第 i 个桶的上界，最后一个桶没有上界
+        static size_t bucket_limit(size_t i) noexcept
+        { return static_cast<size_t>(1) << i; }
+
+        static size_t bucket_of(size_t bytes) noexcept
+        {
+            size_t i = 0;
+            while (i + 1 < nbuckets && bucket_limit(i) < bytes)
+                ++i;
+            return i;
+        }
+
+        void record_allocate(size_t bytes) noexcept
+        {
+            allocs_.fetch_add(1, std::memory_order_relaxed);
+            total_.fetch_add(bytes, std::memory_order_relaxed);
+            hist_[bucket_of(bytes)].fetch_add(1, std::memory_order_relaxed);
+            const size_t live = live_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+            size_t peak = peak_.load(std::memory_order_relaxed);
+            while (live > peak && !peak_.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+            {
+            }
+        }
+
+        void record_deallocate(size_t bytes) noexcept
+        {
+            deallocs_.fetch_add(1, std::memory_order_relaxed);
+            live_.fetch_sub(bytes, std::memory_order_relaxed);
+        }
+
+        // 清空计数，峰值从当前占用重新开始
+        void reset() noexcept
+        {
+            allocs_.store(0, std::memory_order_relaxed);
+            deallocs_.store(0, std::memory_order_relaxed);
+            total_.store(0, std::memory_order_relaxed);
+            peak_.store(live_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            for (size_t i = 0; i < nbuckets; ++i)
+                hist_[i].store(0, std::memory_order_relaxed);
+        }
+
+        // 以文本形式输出，直方图只输出非空的桶
+        void dump(std::FILE* out) const
+        {
+            std::fprintf(out, "[%s] allocs=%zu deallocs=%zu live=%zu peak=%zu total=%zu\n",
+                         name_, allocate_count(), deallocate_count(), live_bytes(), peak_bytes(), total_bytes());
+            for (size_t i = 0; i < nbuckets; ++i)
+            {
+                const size_t n = bucket_count(i);
+                if (n == 0)
+                    continue;
+                if (i + 1 < nbuckets)
+                    std::fprintf(out, "    <= %zu: %zu\n", bucket_limit(i), n);
+                else
+                    std::fprintf(out, "    >  %zu: %zu\n", bucket_limit(i - 1), n);
+            }
+        }
+
+    private:
+        const char*         name_;
+        std::atomic<size_t> allocs_;
+        std::atomic<size_t> deallocs_;
+        std::atomic<size_t> live_{0};
+        std::atomic<size_t> peak_;
+        std::atomic<size_t> total_;
+        std::atomic<size_t> hist_[nbuckets];
+
+        friend class alloc_stats_registry;
+        alloc_stats*        next_ = nullptr;   // 登记表中的下一组统计
+    };
+
+    /*****************************************************************************************/
+    // alloc_stats_registry
+    // 登记表只保存指针，登记的统计必须在程序结束前一直有效(标签的统计是不析构的静态对象)
+    /*****************************************************************************************/
+    class alloc_stats_registry
+    {
+    public:
+        static void add(alloc_stats& stats)
+        {
+            std::lock_guard<std::mutex> lock(mtx());
+            stats.next_ = head();
+            head() = &stats;
+        }
+
+        static void remove(alloc_stats& stats)
+        {
+            std::lock_guard<std::mutex> lock(mtx());
+            for (alloc_stats** cur = &head(); *cur != nullptr; cur = &(*cur)->next_)
+            {
+                if (*cur == &stats)
+                {
+                    *cur = stats.next_;
+                    stats.next_ = nullptr;
+                    return;
+                }
+            }
+        }
+
+        // 按名字查询，找不到时返回 nullptr
+        static const alloc_stats* find(const char* name)
+        {
+            std::lock_guard<std::mutex> lock(mtx());
+            for (alloc_stats* cur = head(); cur != nullptr; cur = cur->next_)
+            {
+                if (std::strcmp(cur->name(), name) == 0)
+                    return cur;
+            }
+            return nullptr;
+        }
+
+        static void dump(std::FILE* out)
+        {
+            std::lock_guard<std::mutex> lock(mtx());
+            for (alloc_stats* cur = head(); cur != nullptr; cur = cur->next_)
+                cur->dump(out);
+            std::fflush(out);
+        }
+
+        // 输出到文件，文件无法打开时返回 false
+        static bool dump(const char* path)
+        {
+            std::FILE* out = std::fopen(path, "w");
+            if (out == nullptr)
+                return false;
+            dump(out);
+            std::fclose(out);
+            return true;
+        }
+
+        static void reset_all()
+        {
+            std::lock_guard<std::mutex> lock(mtx());
+            for (alloc_stats* cur = head(); cur != nullptr; cur = cur->next_)
+                cur->reset();
+        }
+
+    private:
+        static std::mutex& mtx()
+        {
+            static std::mutex* m = new std::mutex;
+            return *m;
+        }
+
+        static alloc_stats*& head()
+        {
+            static alloc_stats* h = nullptr;
+            return h;
+        }
+    };
+
+    /*****************************************************************************************/
+    // 统计标签
+    // 标签是一个提供 name() 的类型，可以通过 map_tag 指定容器辅助结构(deque 的 map)使用的标签
+    /*****************************************************************************************/
+    namespace alloc_tag
+    {
+        struct other          { static const char* name() { return "other"; } };
+        struct vector         { static const char* name() { return "vector"; } };
+        struct deque_map      { static const char* name() { return "deque map"; } };
+        struct deque
+        {
+            static const char* name() { return "deque blocks"; }
+            typedef deque_map map_tag;
+        };
+        struct priority_queue { static const char* name() { return "priority_queue"; } };
+    }
+
+    namespace alloc_detail
+    {
+        template <class Tag, class = void>
+        struct map_tag_of { typedef Tag type; };
+        template <class Tag>
+        struct map_tag_of<Tag, void_t<typename Tag::map_tag>> { typedef typename Tag::map_tag type; };
+    }
+
+    // 每个标签对应的统计，第一次使用时登记，不会析构
+    template <class Tag>
+    alloc_stats& tag_stats()
+    {
+        static alloc_stats* stats = []
+        {
+            alloc_stats* p = new alloc_stats(Tag::name());
+            alloc_stats_registry::add(*p);
+            return p;
+        }();
+        return *stats;
+    }
+
+    /*****************************************************************************************/
+    // 模板类 tracking_allocator
+    // 所有请求转发给 Base，并记录到 tag_stats<Tag>() 中
+    /*****************************************************************************************/
+    template <class T, class Tag = alloc_tag::other, class Base = dw_stl::allocator<T>>
+    class tracking_allocator : private dw_stl::allocator_holder<Base>
+    {
+        template <class, class, class> friend class tracking_allocator;
+
+        typedef dw_stl::allocator_holder<Base> holder_base;
+        typedef dw_stl::allocator_traits<Base> base_traits;
+
+    public:
+        typedef T                                       value_type;
+        typedef typename base_traits::pointer           pointer;
+        typedef typename base_traits::const_pointer     const_pointer;
+        typedef typename base_traits::size_type         size_type;
+        typedef typename base_traits::difference_type   difference_type;
+
+        typedef typename base_traits::propagate_on_container_copy_assignment propagate_on_container_copy_assignment;
+        typedef typename base_traits::propagate_on_container_move_assignment propagate_on_container_move_assignment;
+        typedef typename base_traits::propagate_on_container_swap            propagate_on_container_swap;
+        typedef typename base_traits::is_always_equal                        is_always_equal;
+
+        template <class U>
+        struct rebind
+        {
+            typedef tracking_allocator<U, Tag, typename base_traits::template rebind_alloc<U>> other;
+        };
+
+        // 容器的辅助结构记录到 Tag::map_tag 中
+        template <class U>
+        struct rebind_map
+        {
+            typedef tracking_allocator<U, typename alloc_detail::map_tag_of<Tag>::type,
+                                       typename base_traits::template rebind_alloc<U>> other;
+        };
+
+        tracking_allocator() = default;
+        explicit tracking_allocator(const Base& base) : holder_base(base) {}
+        template <class U, class Tag2, class Base2>
+        tracking_allocator(const tracking_allocator<U, Tag2, Base2>& rhs)
+            : holder_base(Base(rhs.base()))
+        {
+        }
+
+        const Base& base() const noexcept { return this->alloc(); }
+
+        static alloc_stats& stats() { return tag_stats<Tag>(); }
+
+        pointer allocate(size_type n)
+        {
+            pointer p = base_traits::allocate(this->alloc(), n);
+            stats().record_allocate(n * sizeof(T));
+            return p;
+        }
+
+        void deallocate(pointer ptr, size_type n)
+        {
+            if (ptr == nullptr)
+                return;
+            stats().record_deallocate(n * sizeof(T));
+            base_traits::deallocate(this->alloc(), ptr, n);
+        }
+
+        tracking_allocator select_on_container_copy_construction() const
+        {
+            return tracking_allocator(base_traits::select_on_container_copy_construction(this->alloc()));
+        }
+    };
+
+    template <class T, class U, class Tag1, class Tag2, class Base1, class Base2>
+    bool operator==(const tracking_allocator<T, Tag1, Base1>& lhs, const tracking_allocator<U, Tag2, Base2>& rhs)
+    {
+        return lhs.base() == rhs.base();
+    }
+
+    template <class T, class U, class Tag1, class Tag2, class Base1, class Base2>
+    bool operator!=(const tracking_allocator<T, Tag1, Base1>& lhs, const tracking_allocator<U, Tag2, Base2>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+namespace pmr
+{
+    /*****************************************************************************************/
+    // tracking_resource
+    // 把请求转发给上游资源，统计保存在资源对象中，存在期间登记在 alloc_stats_registry 中
+    /*****************************************************************************************/
+    class tracking_resource : public memory_resource
+    {
+    public:
+        explicit tracking_resource(const char* name, memory_resource* upstream = get_default_resource())
+            : stats_(name), upstream_(upstream)
+        {
+            alloc_stats_registry::add(stats_);
+        }
+
+        ~tracking_resource()
+        {
+            alloc_stats_registry::remove(stats_);
+        }
+
+        tracking_resource(const tracking_resource&) = delete;
+        tracking_resource& operator=(const tracking_resource&) = delete;
+
+        memory_resource*   upstream_resource() const noexcept { return upstream_; }
+        const alloc_stats& stats() const noexcept { return stats_; }
+        alloc_stats&       stats() noexcept { return stats_; }
+
+    private:
+        void* do_allocate(size_t bytes, size_t alignment) override
+        {
+            void* p = upstream_->allocate(bytes, alignment);
+            stats_.record_allocate(bytes);
+            return p;
+        }
+
+        void do_deallocate(void* ptr, size_t bytes, size_t alignment) override
+        {
+            // 与 tracking_allocator 相同，nullptr 不计入统计
+            if (ptr == nullptr)
+                return;
+            stats_.record_deallocate(bytes);
+            upstream_->deallocate(ptr, bytes, alignment);
+        }
+
+        bool do_is_equal(const memory_resource& other) const noexcept override
+        { return this == &other; }
+
+    private:
+        alloc_stats      stats_;
+        memory_resource* upstream_;
+    };
+}
+}
+
+#endif
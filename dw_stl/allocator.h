@@ -18,8 +18,21 @@ construct
 destroy
 */
 
+#include <cstring>
+
 #include "construct.h"
 #include "util.h"
+#include "aligned_alloc.h"
+
+// 定义 DW_STL_USE_POOL_ALLOC 之后，小块内存使用 pool_alloc.h 中的内存池分配
+#ifdef DW_STL_USE_POOL_ALLOC
+#include "pool_alloc.h"
+#endif
+
+// 定义 DW_STL_USE_LARGE_ALLOC 之后，大块内存使用 large_alloc.h 中的 mmap 分配，并且可以用 mremap 扩容
+#ifdef DW_STL_USE_LARGE_ALLOC
+#include "large_alloc.h"
+#endif
 
 namespace dw_stl
 {
@@ -37,6 +50,21 @@ namespace dw_stl
         typedef size_t          size_type;
         typedef ptrdiff_t       difference_type;
 
+        // allocator没有状态，任意两个allocator都可以互相释放对方分配的内存
+        typedef std::true_type  propagate_on_container_move_assignment;
+        typedef std::true_type  is_always_equal;
+
+        // 将allocator<T>转换为allocator<U>, deque用它来分配map
+        template <class U>
+        struct rebind
+        {
+            typedef allocator<U> other;
+        };
+
+        allocator() noexcept = default;
+        template <class U>
+        allocator(const allocator<U>&) noexcept {}
+
         // 分配空间
         static T*   allocate();
         static T*   allocate(size_type n);
@@ -45,6 +73,18 @@ namespace dw_stl
         static void deallocate(T* ptr);
         static void deallocate(T* ptr, size_type n);
 
+        // 分配至少n个单元，n改为实际分配的单元数(大块内存按页取整，内存池按大小等级取整)
+        static T*   allocate_at_least(size_type& n);
+
+        // 分配n个内容为零的单元，大块内存由mmap得到，本身就是零，不需要再清零
+        static T*   allocate_zeroed(size_type n);
+
+#ifdef DW_STL_USE_LARGE_ALLOC
+        // 将ptr指向的old_n个单元扩充或缩小为new_n个单元，内容按字节保留
+        // 只有新旧两块内存都是大块内存时才能完成，否则返回nullptr，原来的内存不变
+        static T*   reallocate(T* ptr, size_type old_n, size_type new_n);
+#endif
+
         // 构造函数
         static void construct(T* ptr);
         static void construct(T* ptr, const T& value);
@@ -63,36 +103,125 @@ namespace dw_stl
     template <class T>
     T* allocator<T>::allocate()
     {
-        return static_cast<T*>(::operator new(sizeof(T)));
+#ifdef DW_STL_USE_POOL_ALLOC
+        return pool_allocator<T>::allocate(1);
+#else
+        return static_cast<T*>(aligned_alloc::allocate(sizeof(T), alignof(T)));
+#endif
     }
 
-    // 分配n个类型的T的内存
+    // 分配n个类型的T的内存，alignof(T)超过::operator new默认的对齐字节数时按alignof(T)对齐
     template <class T>
     T* allocator<T>::allocate(size_type n)
     {
         if (n == 0)
             return nullptr;
-        return static_cast<T*>(::operator new(n * sizeof(T)));
+#ifdef DW_STL_USE_LARGE_ALLOC
+        if (large_alloc::is_large(n * sizeof(T)))
+            return static_cast<T*>(large_alloc::allocate(n * sizeof(T)));
+#endif
+#ifdef DW_STL_USE_POOL_ALLOC
+        return pool_allocator<T>::allocate(n);
+#else
+        return static_cast<T*>(aligned_alloc::allocate(n * sizeof(T), alignof(T)));
+#endif
+    }
+
+    template <class T>
+    T* allocator<T>::allocate_at_least(size_type& n)
+    {
+        if (n == 0)
+            return nullptr;
+#ifdef DW_STL_USE_LARGE_ALLOC
+        if (large_alloc::is_large(n * sizeof(T)))
+        {
+            T* ptr = static_cast<T*>(large_alloc::allocate(n * sizeof(T)));
+            n = large_alloc::good_size(n * sizeof(T)) / sizeof(T);
+            return ptr;
+        }
+#endif
+#ifdef DW_STL_USE_POOL_ALLOC
+        return pool_allocator<T>::allocate_at_least(n);
+#else
+        return static_cast<T*>(aligned_alloc::allocate(n * sizeof(T), alignof(T)));
+#endif
+    }
+
+    template <class T>
+    T* allocator<T>::allocate_zeroed(size_type n)
+    {
+        if (n == 0)
+            return nullptr;
+#ifdef DW_STL_USE_LARGE_ALLOC
+        if (large_alloc::is_large(n * sizeof(T)))
+            return static_cast<T*>(large_alloc::allocate_zeroed(n * sizeof(T)));
+#endif
+        T* ptr = allocate(n);
+        std::memset(static_cast<void*>(ptr), 0, n * sizeof(T));
+        return ptr;
     }
 
     /********************************************/
     // 释放ptr指向的单元
     /*********************************************/
+    // 使用内存池时，不带大小的版本只能释放allocate()分配的一个单元
     template <class T>
     void allocator<T>::deallocate(T* ptr)
     {
         if (ptr == nullptr)
             return;
-        ::operator delete(ptr);
+#ifdef DW_STL_USE_POOL_ALLOC
+        pool_allocator<T>::deallocate(ptr, 1);
+#else
+        aligned_alloc::deallocate(ptr, alignof(T));
+#endif
     }
 
+    // 释放时的n必须与分配时相同，用来判断内存是由哪一种方式分配的
     template <class T>
-    void allocator<T>::deallocate(T* ptr, size_type )
+    void allocator<T>::deallocate(T* ptr, size_type n)
     {
         if (ptr == nullptr)
             return;
+#ifdef DW_STL_USE_LARGE_ALLOC
+        if (large_alloc::is_large(n * sizeof(T)))
+        {
+            large_alloc::deallocate(ptr, n * sizeof(T));
+            return;
+        }
+#endif
+#ifdef DW_STL_USE_POOL_ALLOC
+        pool_allocator<T>::deallocate(ptr, n);
+#else
+        (void)n;
         // operator不会调用构造函数，因此需要首先销毁对象才能调用delete
-        ::operator delete(ptr);
+        aligned_alloc::deallocate(ptr, alignof(T));
+#endif
+    }
+
+#ifdef DW_STL_USE_LARGE_ALLOC
+    // 重新映射大块内存，不需要复制数据
+    template <class T>
+    T* allocator<T>::reallocate(T* ptr, size_type old_n, size_type new_n)
+    {
+        if (ptr == nullptr || !large_alloc::is_large(old_n * sizeof(T)) ||
+            !large_alloc::is_large(new_n * sizeof(T)))
+            return nullptr;
+        return static_cast<T*>(large_alloc::reallocate(ptr, old_n * sizeof(T), new_n * sizeof(T)));
+    }
+#endif
+
+    // allocator没有状态，总是相等的
+    template <class T, class U>
+    bool operator==(const allocator<T>&, const allocator<U>&) noexcept
+    {
+        return true;
+    }
+
+    template <class T, class U>
+    bool operator!=(const allocator<T>&, const allocator<U>&) noexcept
+    {
+        return false;
     }
 
     /********************************************
@@ -112,6 +241,13 @@ namespace dw_stl
         dw_stl::construct(ptr, value);
     }
 
+    // 构造对象，移动构造函数
+    template <class T>
+    void allocator<T>::construct(T* ptr, T&& value)
+    {
+        dw_stl::construct(ptr, dw_stl::move(value));
+    }
+
     // 构造对象，参数为构造函数的参数
     template <class T>
     template <class ...Args>
@@ -0,0 +1,383 @@
+#ifndef DW_STL_ALLOCATOR_TRAITS_H_
+#define DW_STL_ALLOCATOR_TRAITS_H_
+
+/*
+这个头文件实现了分配器萃取器 allocator_traits
+容器不再直接调用 allocator<T> 的静态函数，而是通过 allocator_traits 访问分配器，
+这样用户可以传入自定义的(有状态的)分配器，例如内存池、arena 等
+
+实现了以下内容：
+allocator_traits<Alloc>      : 萃取分配器的型别，提供 allocate, deallocate, construct, destroy 等接口
+                               以及 rebind_alloc 和三种传播(propagate)规则
+                               allocate_at_least 返回分配器实际分配的单元数，reallocate 由分配器改变一块内存的大小
+                               allocate_zeroed 分配内容为零的空间(calloc、新映射的页面不需要再清零)
+allocator_holder<Alloc>      : 容器保存分配器对象的基类，空分配器不占用空间(空基类优化)
+uses_allocator<T, Alloc>     : 判断类型 T 是否可以使用分配器 Alloc
+alloc_on_copy / alloc_on_move / alloc_on_swap : 根据传播规则处理容器赋值与交换时的分配器
+*/
+
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <utility>
+
+#include "type_traits.h"
+#include "construct.h"
+#include "util.h"
+
+namespace dw_stl
+{
+    namespace alloc_detail
+    {
+        // 萃取 Alloc::pointer，没有的话使用 value_type*
+        template <class Alloc, class T, class = void>
+        struct pointer_of { typedef T* type; };
+        template <class Alloc, class T>
+        struct pointer_of<Alloc, T, void_t<typename Alloc::pointer>>
+        { typedef typename Alloc::pointer type; };
+
+        template <class Alloc, class T, class = void>
+        struct const_pointer_of { typedef const T* type; };
+        template <class Alloc, class T>
+        struct const_pointer_of<Alloc, T, void_t<typename Alloc::const_pointer>>
+        { typedef typename Alloc::const_pointer type; };
+
+        template <class Alloc, class = void>
+        struct size_type_of { typedef size_t type; };
+        template <class Alloc>
+        struct size_type_of<Alloc, void_t<typename Alloc::size_type>>
+        { typedef typename Alloc::size_type type; };
+
+        template <class Alloc, class = void>
+        struct difference_type_of { typedef ptrdiff_t type; };
+        template <class Alloc>
+        struct difference_type_of<Alloc, void_t<typename Alloc::difference_type>>
+        { typedef typename Alloc::difference_type type; };
+
+        // 三种传播规则，默认都不传播
+        template <class Alloc, class = void>
+        struct pocca : std::false_type {};
+        template <class Alloc>
+        struct pocca<Alloc, void_t<typename Alloc::propagate_on_container_copy_assignment>>
+            : Alloc::propagate_on_container_copy_assignment {};
+
+        template <class Alloc, class = void>
+        struct pocma : std::false_type {};
+        template <class Alloc>
+        struct pocma<Alloc, void_t<typename Alloc::propagate_on_container_move_assignment>>
+            : Alloc::propagate_on_container_move_assignment {};
+
+        template <class Alloc, class = void>
+        struct pocs : std::false_type {};
+        template <class Alloc>
+        struct pocs<Alloc, void_t<typename Alloc::propagate_on_container_swap>>
+            : Alloc::propagate_on_container_swap {};
+
+        // 没有状态的分配器总是相等的
+        template <class Alloc, class = void>
+        struct always_equal : std::is_empty<Alloc> {};
+        template <class Alloc>
+        struct always_equal<Alloc, void_t<typename Alloc::is_always_equal>>
+            : Alloc::is_always_equal {};
+
+        // rebind：优先使用 Alloc::rebind<U>::other，否则替换 Alloc<T, Args...> 的第一个模板参数
+        template <class Alloc, class U>
+        struct replace_first_arg {};
+        template <template <class, class...> class Templ, class T, class... Args, class U>
+        struct replace_first_arg<Templ<T, Args...>, U> { typedef Templ<U, Args...> type; };
+
+        template <class Alloc, class U, class = void>
+        struct rebind_of : replace_first_arg<Alloc, U> {};
+        template <class Alloc, class U>
+        struct rebind_of<Alloc, U, void_t<typename Alloc::template rebind<U>::other>>
+        { typedef typename Alloc::template rebind<U>::other type; };
+
+        // 容器的辅助结构(例如 deque 的中控器 map)使用的分配器：优先使用 Alloc::rebind_map<U>::other，
+        // 分配器可以借此把辅助结构与元素区分开，否则与 rebind 相同
+        template <class Alloc, class U, class = void>
+        struct rebind_map_of : rebind_of<Alloc, U> {};
+        template <class Alloc, class U>
+        struct rebind_map_of<Alloc, U, void_t<typename Alloc::template rebind_map<U>::other>>
+        { typedef typename Alloc::template rebind_map<U>::other type; };
+
+        // 检测分配器是否提供了 construct / destroy / max_size / select_on_container_copy_construction
+        template <class Void, class Alloc, class T, class... Args>
+        struct has_construct_impl : std::false_type {};
+        template <class Alloc, class T, class... Args>
+        struct has_construct_impl<void_t<decltype(std::declval<Alloc&>().construct(
+            std::declval<T*>(), std::declval<Args>()...))>, Alloc, T, Args...> : std::true_type {};
+        template <class Alloc, class T, class... Args>
+        struct has_construct : has_construct_impl<void, Alloc, T, Args...> {};
+
+        template <class Alloc, class T, class = void>
+        struct has_destroy : std::false_type {};
+        template <class Alloc, class T>
+        struct has_destroy<Alloc, T, void_t<decltype(std::declval<Alloc&>().destroy(std::declval<T*>()))>>
+            : std::true_type {};
+
+        template <class Alloc, class T, class = void>
+        struct has_range_destroy : std::false_type {};
+        template <class Alloc, class T>
+        struct has_range_destroy<Alloc, T, void_t<decltype(std::declval<Alloc&>().destroy(
+            std::declval<T*>(), std::declval<T*>()))>> : std::true_type {};
+
+        // 检测分配器是否提供了 reallocate(ptr, old_n, new_n)
+        template <class Alloc, class T, class = void>
+        struct has_reallocate : std::false_type {};
+        template <class Alloc, class T>
+        struct has_reallocate<Alloc, T, void_t<decltype(std::declval<Alloc&>().reallocate(
+            std::declval<T*>(), std::declval<size_t>(), std::declval<size_t>()))>> : std::true_type {};
+
+        // 检测分配器是否提供了 allocate_at_least(n)，n 为引用参数，返回时改为实际分配的单元数
+        template <class Alloc, class T, class = void>
+        struct has_allocate_at_least : std::false_type {};
+        template <class Alloc, class T>
+        struct has_allocate_at_least<Alloc, T, void_t<decltype(std::declval<Alloc&>().allocate_at_least(
+            std::declval<size_t&>()))>> : std::true_type {};
+
+        // 检测分配器是否提供了 allocate_zeroed(n)
+        template <class Alloc, class = void>
+        struct has_allocate_zeroed : std::false_type {};
+        template <class Alloc>
+        struct has_allocate_zeroed<Alloc, void_t<decltype(std::declval<Alloc&>().allocate_zeroed(
+            std::declval<size_t>()))>> : std::true_type {};
+
+        template <class Alloc, class = void>
+        struct has_max_size : std::false_type {};
+        template <class Alloc>
+        struct has_max_size<Alloc, void_t<decltype(std::declval<const Alloc&>().max_size())>>
+            : std::true_type {};
+
+        template <class Alloc, class = void>
+        struct has_select : std::false_type {};
+        template <class Alloc>
+        struct has_select<Alloc, void_t<decltype(
+            std::declval<const Alloc&>().select_on_container_copy_construction())>> : std::true_type {};
+    }
+
+    // 模板类 allocator_traits
+    // 容器通过它来使用分配器，分配器只需要提供 value_type, allocate, deallocate 即可
+    template <class Alloc>
+    struct allocator_traits
+    {
+        typedef Alloc                                                         allocator_type;
+        typedef typename Alloc::value_type                                    value_type;
+        typedef typename alloc_detail::pointer_of<Alloc, value_type>::type       pointer;
+        typedef typename alloc_detail::const_pointer_of<Alloc, value_type>::type const_pointer;
+        typedef typename alloc_detail::size_type_of<Alloc>::type                 size_type;
+        typedef typename alloc_detail::difference_type_of<Alloc>::type           difference_type;
+
+        typedef alloc_detail::pocca<Alloc>          propagate_on_container_copy_assignment;
+        typedef alloc_detail::pocma<Alloc>          propagate_on_container_move_assignment;
+        typedef alloc_detail::pocs<Alloc>           propagate_on_container_swap;
+        typedef alloc_detail::always_equal<Alloc>   is_always_equal;
+
+        template <class U>
+        using rebind_alloc = typename alloc_detail::rebind_of<Alloc, U>::type;
+        template <class U>
+        using rebind_traits = allocator_traits<rebind_alloc<U>>;
+        template <class U>
+        using rebind_map_alloc = typename alloc_detail::rebind_map_of<Alloc, U>::type;
+
+        // 分配与释放空间
+        static pointer allocate(Alloc& a, size_type n)
+        { return a.allocate(n); }
+
+        static void deallocate(Alloc& a, pointer ptr, size_type n)
+        { a.deallocate(ptr, n); }
+
+        // 分配至少 n 个单元，n 改为实际可以使用的单元数(例如 malloc_usable_size 或者内存池的大小等级)，
+        // 之后用这个 n 释放；分配器没有提供 allocate_at_least 时与 allocate 相同
+        static pointer allocate_at_least(Alloc& a, size_type& n)
+        { return allocate_at_least_dispatch(alloc_detail::has_allocate_at_least<Alloc, value_type>{}, a, n); }
+
+        // 分配 n 个单元并且每个字节都为零，分配器没有提供 allocate_zeroed 时分配之后用 memset 清零
+        static pointer allocate_zeroed(Alloc& a, size_type n)
+        { return allocate_zeroed_dispatch(alloc_detail::has_allocate_zeroed<Alloc>{}, a, n); }
+
+        // 分配器是否能够在不复制元素的情况下改变一块内存的大小
+        typedef alloc_detail::has_reallocate<Alloc, value_type> can_reallocate;
+
+        // 将 ptr 指向的 old_n 个单元改为 new_n 个单元，内容按字节保留(只适用于可平凡复制的类型)
+        // 分配器不支持或者无法完成时返回 nullptr，此时原来的内存不变
+        static pointer reallocate(Alloc& a, pointer ptr, size_type old_n, size_type new_n)
+        { return reallocate_dispatch(can_reallocate{}, a, ptr, old_n, new_n); }
+
+        // 构造对象，分配器没有提供 construct 时使用 dw_stl::construct
+        template <class T, class... Args>
+        static void construct(Alloc& a, T* ptr, Args&& ...args)
+        {
+            construct_dispatch(alloc_detail::has_construct<Alloc, T, Args...>{},
+                               a, ptr, dw_stl::forward<Args>(args)...);
+        }
+
+        // 析构对象，分配器没有提供 destroy 时使用 dw_stl::destroy
+        template <class T>
+        static void destroy(Alloc& a, T* ptr)
+        { destroy_dispatch(alloc_detail::has_destroy<Alloc, T>{}, a, ptr); }
+
+        // 析构 [first, last) 上的对象，容器内部批量析构时使用
+        template <class T>
+        static void destroy(Alloc& a, T* first, T* last)
+        {
+            range_destroy_dispatch(alloc_detail::has_range_destroy<Alloc, T>{},
+                                   alloc_detail::has_destroy<Alloc, T>{}, a, first, last);
+        }
+
+        static size_type max_size(const Alloc& a) noexcept
+        { return max_size_dispatch(alloc_detail::has_max_size<Alloc>{}, a); }
+
+        // 拷贝构造容器时使用的分配器
+        static Alloc select_on_container_copy_construction(const Alloc& a)
+        { return select_dispatch(alloc_detail::has_select<Alloc>{}, a); }
+
+    private:
+        static pointer allocate_at_least_dispatch(std::true_type, Alloc& a, size_type& n)
+        { return a.allocate_at_least(n); }
+        static pointer allocate_at_least_dispatch(std::false_type, Alloc& a, size_type& n)
+        { return a.allocate(n); }
+
+        static pointer allocate_zeroed_dispatch(std::true_type, Alloc& a, size_type n)
+        { return a.allocate_zeroed(n); }
+        static pointer allocate_zeroed_dispatch(std::false_type, Alloc& a, size_type n)
+        {
+            pointer ptr = a.allocate(n);
+            if (n != 0 && ptr != nullptr)
+                std::memset(static_cast<void*>(ptr), 0, n * sizeof(value_type));
+            return ptr;
+        }
+
+        static pointer reallocate_dispatch(std::true_type, Alloc& a, pointer ptr, size_type old_n, size_type new_n)
+        { return a.reallocate(ptr, old_n, new_n); }
+        static pointer reallocate_dispatch(std::false_type, Alloc&, pointer, size_type, size_type)
+        { return nullptr; }
+
+        template <class T, class... Args>
+        static void construct_dispatch(std::true_type, Alloc& a, T* ptr, Args&& ...args)
+        { a.construct(ptr, dw_stl::forward<Args>(args)...); }
+        template <class T, class... Args>
+        static void construct_dispatch(std::false_type, Alloc&, T* ptr, Args&& ...args)
+        { dw_stl::construct(ptr, dw_stl::forward<Args>(args)...); }
+
+        template <class T>
+        static void destroy_dispatch(std::true_type, Alloc& a, T* ptr)
+        { a.destroy(ptr); }
+        template <class T>
+        static void destroy_dispatch(std::false_type, Alloc&, T* ptr)
+        { dw_stl::destroy(ptr); }
+
+        template <class T, class HasDestroy>
+        static void range_destroy_dispatch(std::true_type, HasDestroy, Alloc& a, T* first, T* last)
+        { a.destroy(first, last); }
+        template <class T>
+        static void range_destroy_dispatch(std::false_type, std::true_type, Alloc& a, T* first, T* last)
+        {
+            for (; first != last; ++first)
+                a.destroy(first);
+        }
+        template <class T>
+        static void range_destroy_dispatch(std::false_type, std::false_type, Alloc&, T* first, T* last)
+        { dw_stl::destroy(first, last); }
+
+        static size_type max_size_dispatch(std::true_type, const Alloc& a)
+        { return a.max_size(); }
+        static size_type max_size_dispatch(std::false_type, const Alloc&)
+        { return std::numeric_limits<size_type>::max() / sizeof(value_type); }
+
+        static Alloc select_dispatch(std::true_type, const Alloc& a)
+        { return a.select_on_container_copy_construction(); }
+        static Alloc select_dispatch(std::false_type, const Alloc& a)
+        { return a; }
+    };
+
+    /*****************************************************************************************/
+    // allocator_holder
+    // 容器私有继承 allocator_holder 来保存分配器，空分配器利用空基类优化，不会增加容器的大小
+    /*****************************************************************************************/
+    // std::is_final 是 C++14 才有的，这里直接使用编译器内建的 __is_final
+    template <class Alloc, bool = std::is_empty<Alloc>::value && !__is_final(Alloc)>
+    class allocator_holder : private Alloc
+    {
+    public:
+        allocator_holder() = default;
+        explicit allocator_holder(const Alloc& a) : Alloc(a) {}
+        explicit allocator_holder(Alloc&& a) : Alloc(dw_stl::move(a)) {}
+
+        Alloc&       alloc() noexcept       { return *this; }
+        const Alloc& alloc() const noexcept { return *this; }
+    };
+
+    template <class Alloc>
+    class allocator_holder<Alloc, false>
+    {
+    private:
+        Alloc alloc_;
+
+    public:
+        allocator_holder() = default;
+        explicit allocator_holder(const Alloc& a) : alloc_(a) {}
+        explicit allocator_holder(Alloc&& a) : alloc_(dw_stl::move(a)) {}
+
+        Alloc&       alloc() noexcept       { return alloc_; }
+        const Alloc& alloc() const noexcept { return alloc_; }
+    };
+
+    /*****************************************************************************************/
+    // 容器赋值和交换时，根据传播规则处理分配器
+    /*****************************************************************************************/
+    template <class Alloc>
+    void alloc_on_copy_dispatch(Alloc& lhs, const Alloc& rhs, std::true_type) { lhs = rhs; }
+    template <class Alloc>
+    void alloc_on_copy_dispatch(Alloc&, const Alloc&, std::false_type) {}
+
+    template <class Alloc>
+    void alloc_on_copy(Alloc& lhs, const Alloc& rhs)
+    {
+        alloc_on_copy_dispatch(lhs, rhs,
+            typename allocator_traits<Alloc>::propagate_on_container_copy_assignment{});
+    }
+
+    template <class Alloc>
+    void alloc_on_move_dispatch(Alloc& lhs, Alloc& rhs, std::true_type) { lhs = dw_stl::move(rhs); }
+    template <class Alloc>
+    void alloc_on_move_dispatch(Alloc&, Alloc&, std::false_type) {}
+
+    template <class Alloc>
+    void alloc_on_move(Alloc& lhs, Alloc& rhs)
+    {
+        alloc_on_move_dispatch(lhs, rhs,
+            typename allocator_traits<Alloc>::propagate_on_container_move_assignment{});
+    }
+
+    template <class Alloc>
+    void alloc_on_swap_dispatch(Alloc& lhs, Alloc& rhs, std::true_type) { dw_stl::swap(lhs, rhs); }
+    template <class Alloc>
+    void alloc_on_swap_dispatch(Alloc&, Alloc&, std::false_type) {}
+
+    template <class Alloc>
+    void alloc_on_swap(Alloc& lhs, Alloc& rhs)
+    {
+        alloc_on_swap_dispatch(lhs, rhs,
+            typename allocator_traits<Alloc>::propagate_on_container_swap{});
+    }
+
+    // 判断两个分配器分配的内存能否互相释放
+    template <class Alloc>
+    bool alloc_equal(const Alloc& lhs, const Alloc& rhs)
+    {
+        return allocator_traits<Alloc>::is_always_equal::value || lhs == rhs;
+    }
+
+    /*****************************************************************************************/
+    // uses_allocator
+    // 判断类型 T 是否拥有可以由 Alloc 转换而来的 allocator_type，容器适配器用它来转发分配器
+    /*****************************************************************************************/
+    template <class T, class Alloc, class = void>
+    struct uses_allocator : std::false_type {};
+
+    template <class T, class Alloc>
+    struct uses_allocator<T, Alloc, void_t<typename T::allocator_type>>
+        : std::is_convertible<Alloc, typename T::allocator_type> {};
+}
+
+#endif
@@ -58,6 +58,9 @@ namespace dw_stl
         }
     }
 
+    template <class Ty>
+    void destroy(Ty* pointer);
+
     // 销毁迭代器指向的对象, 如果是内置类型的话，就不用析构
     template <class ForwardIterator>
     void destroy_cat(ForwardIterator , ForwardIterator, std::true_type) {}
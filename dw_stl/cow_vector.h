@@ -0,0 +1,665 @@
+#ifndef DW_STL_COW_VECTOR_H_
+#define DW_STL_COW_VECTOR_H_
+
+/*
+这个头文件用于实现模板类 cow_vector<T>，写时复制(copy-on-write)的 vector
+
+很少修改、经常被多个线程读取的数据(配置、路由表等)每次发布都要用 vector(const vector&) 复制全部元素，
+cow_vector 的复制与 snapshot() 只增加一次引用计数，真正的复制推迟到写入的时候，并且只复制被写入的那一块：
+    元素保存在大小相同的块(chunk)中，每块约 DW_STL_COW_VECTOR_CHUNK_BYTES 字节，元素个数是 2 的幂
+    块的指针保存在一张表(table)中，表与每一块都有各自的原子引用计数
+    snapshot() 与复制构造函数共享同一张表，O(1)
+    写入时表被共享则先复制表(只复制块的指针，O(n / 块的大小))，写入的块被共享则再复制这一块，其余的块仍然共享
+    没有共享时写入与 vector 一样直接修改，不复制
+
+线程安全：与 shared_ptr 相同，共享存储的不同 cow_vector 对象可以在不同的线程中同时使用(包括一个线程写入，其他线程读取各自的快照)，
+同一个对象不能在一个线程写入的同时被其他线程访问；把快照交给其他线程时需要调用者自己同步(例如通过互斥量或者 atomic 的 shared_ptr)
+
+读取操作(operator[]、at、迭代器)都是 const 的，修改元素使用 set(n, value) 或者 make_mutable(n)，
+make_mutable 返回的引用在下一次 snapshot()/复制之后不能再用于写入，否则会修改快照中的元素
+迭代器只有 const_iterator，for_each_chunk(f) 按块把连续的元素交给 f，比逐个元素的迭代器更快
+
+复制构造时复制 rhs 的分配器，与 rhs 共享存储；赋值与交换按分配器的传播规则处理，
+分配器不传播并且不相等时赋值不能共享存储，改为用自己的分配器复制全部元素
+
+异常保证：
+    dw_stl::cow_vector<T> 满足基本异常保证，并对以下函数做强异常安全保证：
+        emplace_back
+        push_back
+        set
+*/
+
+#include <atomic>
+#include <initializer_list>
+
+#include "iterator.h"
+#include "util.h"
+#include "exceptdef.h"
+#include "allocator.h"
+#include "allocator_traits.h"
+#include "algorithm.h"
+#include "uninitialized.h"
+#include "vector.h"
+
+namespace dw_stl
+{
+    // cow_vector每块的大致字节数
+    #ifndef DW_STL_COW_VECTOR_CHUNK_BYTES
+    #define DW_STL_COW_VECTOR_CHUNK_BYTES 4096
+    #endif
+
+    // 每块的元素个数为 2^shift
+    template <class T>
+    struct cow_chunk_layout
+    {
+        static constexpr size_t floor_log2(size_t n, size_t s = 0)
+        { return (size_t(2) << s) > n ? s : floor_log2(n, s + 1); }
+
+        static constexpr size_t shift = floor_log2(sizeof(T) < DW_STL_COW_VECTOR_CHUNK_BYTES
+                                                   ? DW_STL_COW_VECTOR_CHUNK_BYTES / sizeof(T) : 1);
+        static constexpr size_t size = size_t(1) << shift;
+        static constexpr size_t mask = size - 1;
+    };
+
+    // 一块元素：引用计数、已经构造的元素个数以及元素的空间
+    template <class T>
+    struct cow_chunk
+    {
+        typedef cow_chunk_layout<T> layout;
+
+        std::atomic<long> refs;
+        size_t            count;
+        typename std::aligned_storage<sizeof(T) * layout::size, alignof(T)>::type storage;
+
+        cow_chunk() noexcept : refs(1), count(0) {}
+
+        T*       data() noexcept       { return reinterpret_cast<T*>(&storage); }
+        const T* data() const noexcept { return reinterpret_cast<const T*>(&storage); }
+    };
+
+    /*****************************************************************************************/
+    // cow_vector 的迭代器，只能读取，保存块的指针数组与下标
+    /*****************************************************************************************/
+    template <class T>
+    struct cow_vector_iterator : public iterator<random_access_iterator_tag, T>
+    {
+        typedef cow_vector_iterator          self;
+        typedef cow_chunk_layout<T>          layout;
+        typedef T                            value_type;
+        typedef const T*                     pointer;
+        typedef const T&                     reference;
+        typedef size_t                       size_type;
+        typedef ptrdiff_t                    difference_type;
+        typedef const cow_chunk<T>* const*   map_pointer;
+
+        map_pointer map;      // 块的指针数组
+        size_type   index;    // 元素的下标
+
+        cow_vector_iterator() noexcept : map(nullptr), index(0) {}
+        cow_vector_iterator(map_pointer m, size_type i) noexcept : map(m), index(i) {}
+
+        reference operator*()  const { return map[index >> layout::shift]->data()[index & layout::mask]; }
+        pointer   operator->() const { return &**this; }
+        reference operator[](difference_type n) const { return *(*this + n); }
+
+        self& operator++() noexcept { ++index; return *this; }
+        self  operator++(int) noexcept { self tmp = *this; ++index; return tmp; }
+        self& operator--() noexcept { --index; return *this; }
+        self  operator--(int) noexcept { self tmp = *this; --index; return tmp; }
+
+        self& operator+=(difference_type n) noexcept { index += n; return *this; }
+        self& operator-=(difference_type n) noexcept { index -= n; return *this; }
+        self  operator+(difference_type n) const noexcept { return self(map, index + n); }
+        self  operator-(difference_type n) const noexcept { return self(map, index - n); }
+
+        difference_type operator-(const self& x) const noexcept
+        { return static_cast<difference_type>(index) - static_cast<difference_type>(x.index); }
+
+        // 重载比较操作符
+        bool operator==(const self& rhs) const noexcept { return index == rhs.index; }
+        bool operator< (const self& rhs) const noexcept { return index < rhs.index; }
+        bool operator!=(const self& rhs) const noexcept { return !(*this == rhs); }
+        bool operator> (const self& rhs) const noexcept { return rhs < *this; }
+        bool operator<=(const self& rhs) const noexcept { return !(rhs < *this); }
+        bool operator>=(const self& rhs) const noexcept { return !(*this < rhs); }
+    };
+
+    // 模板类cow_vector
+    // 模板参数T代表数据类型，Alloc代表分配器类型
+    // 块与表使用由Alloc rebind得到的分配器分配
+    template <class T, class Alloc = dw_stl::allocator<T>>
+    class cow_vector : private dw_stl::allocator_holder<Alloc>
+    {
+        static_assert(std::is_same<T, typename Alloc::value_type>::value,
+                      "The value_type of Alloc should be same with T");
+    public:
+        typedef Alloc                                    allocator_type;
+        typedef dw_stl::allocator_traits<Alloc>          alloc_traits;
+
+        typedef T                                        value_type;
+        typedef T*                                       pointer;
+        typedef const T*                                 const_pointer;
+        typedef T&                                       reference;
+        typedef const T&                                 const_reference;
+        typedef typename alloc_traits::size_type         size_type;
+        typedef typename alloc_traits::difference_type   difference_type;
+
+        typedef cow_vector_iterator<T>                   const_iterator;
+        typedef const_iterator                           iterator;
+        typedef dw_stl::reverse_iterator<const_iterator> const_reverse_iterator;
+        typedef const_reverse_iterator                   reverse_iterator;
+
+        allocator_type get_allocator() const { return this->alloc(); }
+
+        // 每块的元素个数
+        static constexpr size_type chunk_size = cow_chunk_layout<T>::size;
+
+    private:
+        typedef dw_stl::allocator_holder<Alloc>                                holder_base;
+        typedef cow_chunk_layout<T>                                            layout;
+        typedef cow_chunk<T>                                                   chunk;
+        typedef typename alloc_traits::template rebind_alloc<chunk>            chunk_allocator;
+        typedef typename alloc_traits::template rebind_map_alloc<chunk*>       map_allocator;
+
+        // 块的指针表，size为全部元素的个数
+        struct table
+        {
+            std::atomic<long>              refs;
+            size_type                      size;
+            vector<chunk*, map_allocator>  chunks;
+
+            explicit table(const map_allocator& a) : refs(1), size(0), chunks(a) {}
+        };
+
+        typedef typename alloc_traits::template rebind_map_alloc<table>        table_allocator;
+        typedef dw_stl::allocator_traits<chunk_allocator>                      chunk_traits;
+        typedef dw_stl::allocator_traits<table_allocator>                      table_traits;
+
+        table* tab_;    // 没有元素时可以为 nullptr
+
+    public:
+        // 构造、复制、移动、析构函数
+        cow_vector() noexcept : tab_(nullptr) {}
+
+        explicit cow_vector(const allocator_type& alloc) noexcept
+            : holder_base(alloc), tab_(nullptr) {}
+
+        explicit cow_vector(size_type n, const allocator_type& alloc = allocator_type())
+            : cow_vector(n, value_type(), alloc) {}
+
+        cow_vector(size_type n, const value_type& value, const allocator_type& alloc = allocator_type())
+            : holder_base(alloc), tab_(nullptr)
+        {
+            try
+            {
+                reserve(n);
+                for (; n > 0; --n)
+                    emplace_back(value);
+            }
+            catch (...)
+            {
+                release();
+                throw;
+            }
+        }
+
+        template <class Iter, typename std::enable_if<
+            dw_stl::is_input_iterator<Iter>::value, int>::type = 0>
+        cow_vector(Iter first, Iter last, const allocator_type& alloc = allocator_type())
+            : holder_base(alloc), tab_(nullptr)
+        {
+            try
+            {
+                for (; first != last; ++first)
+                    emplace_back(*first);
+            }
+            catch (...)
+            {
+                release();
+                throw;
+            }
+        }
+
+        cow_vector(std::initializer_list<value_type> ilist, const allocator_type& alloc = allocator_type())
+            : cow_vector(ilist.begin(), ilist.end(), alloc) {}
+
+        // 复制只共享存储，O(1)
+        cow_vector(const cow_vector& rhs) noexcept
+            : holder_base(rhs.alloc()), tab_(rhs.tab_)
+        {
+            if (tab_ != nullptr)
+                tab_->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        cow_vector(cow_vector&& rhs) noexcept
+            : holder_base(dw_stl::move(rhs.alloc())), tab_(rhs.tab_)
+        {
+            rhs.tab_ = nullptr;
+        }
+
+        // 分配器传播或者相等时共享rhs的存储，否则复制元素
+        cow_vector& operator=(const cow_vector& rhs)
+        {
+            if (this == &rhs)
+                return *this;
+            if (alloc_traits::propagate_on_container_copy_assignment::value ||
+                dw_stl::alloc_equal(this->alloc(), rhs.alloc()))
+            {
+                table* t = rhs.tab_;
+                if (t != nullptr)
+                    t->refs.fetch_add(1, std::memory_order_relaxed);
+                release();
+                dw_stl::alloc_on_copy(this->alloc(), rhs.alloc());
+                tab_ = t;
+            }
+            else
+                copy_from(rhs);
+            return *this;
+        }
+
+        // 分配器传播或者相等时接管rhs的存储，否则复制元素(rhs的块可能仍然被快照共享，不能移动其中的元素)
+        cow_vector& operator=(cow_vector&& rhs)
+            noexcept(alloc_traits::propagate_on_container_move_assignment::value ||
+                     alloc_traits::is_always_equal::value)
+        {
+            if (this == &rhs)
+                return *this;
+            if (alloc_traits::propagate_on_container_move_assignment::value ||
+                dw_stl::alloc_equal(this->alloc(), rhs.alloc()))
+            {
+                release();
+                dw_stl::alloc_on_move(this->alloc(), rhs.alloc());
+                tab_ = rhs.tab_;
+                rhs.tab_ = nullptr;
+            }
+            else
+            {
+                copy_from(rhs);
+                rhs.clear();
+            }
+            return *this;
+        }
+
+        cow_vector& operator=(std::initializer_list<value_type> ilist)
+        {
+            cow_vector tmp(ilist, this->alloc());
+            swap(tmp);
+            return *this;
+        }
+
+        ~cow_vector()
+        { release(); }
+
+    public:
+        // 与当前内容相同的快照，O(1)，之后对*this的修改不会影响快照
+        cow_vector snapshot() const noexcept
+        { return cow_vector(*this); }
+
+        // 存储是否没有与其他对象共享
+        bool unique() const noexcept
+        { return tab_ == nullptr || tab_->refs.load(std::memory_order_acquire) == 1; }
+
+        // 迭代器相关操作
+        const_iterator begin() const noexcept
+        { return const_iterator(map(), 0); }
+        const_iterator end() const noexcept
+        { return const_iterator(map(), size()); }
+        const_iterator cbegin() const noexcept
+        { return begin(); }
+        const_iterator cend() const noexcept
+        { return end(); }
+
+        const_reverse_iterator rbegin() const noexcept
+        { return const_reverse_iterator(end()); }
+        const_reverse_iterator rend() const noexcept
+        { return const_reverse_iterator(begin()); }
+
+        // 容量相关操作
+        bool empty() const noexcept
+        { return size() == 0; }
+        size_type size() const noexcept
+        { return tab_ == nullptr ? 0 : tab_->size; }
+        size_type max_size() const noexcept
+        { return alloc_traits::max_size(this->alloc()); }
+        size_type capacity() const noexcept
+        { return tab_ == nullptr ? 0 : tab_->chunks.capacity() * chunk_size; }
+
+        // 块的数目
+        size_type chunk_count() const noexcept
+        { return tab_ == nullptr ? 0 : tab_->chunks.size(); }
+
+        // 预留块的指针表，不分配块
+        void reserve(size_type n)
+        {
+            THROW_LENGTH_ERROR_IF(n > max_size(), "n can not larger than max_size() in cow_vector<T>::reserve(n)");
+            if (n == 0)
+                return;
+            make_table_unique();
+            tab_->chunks.reserve((n + chunk_size - 1) / chunk_size);
+        }
+
+        // 访问元素相关操作，只读
+        const_reference operator[](size_type n) const
+        {
+            DW_STL_DEBUG(n < size());
+            return tab_->chunks[n >> layout::shift]->data()[n & layout::mask];
+        }
+
+        const_reference at(size_type n) const
+        {
+            THROW_OUT_OF_RANGE_IF(!(n < size()), "cow_vector<T>::at() subscript out of range");
+            return (*this)[n];
+        }
+
+        const_reference front() const
+        {
+            DW_STL_DEBUG(!empty());
+            return (*this)[0];
+        }
+        const_reference back() const
+        {
+            DW_STL_DEBUG(!empty());
+            return (*this)[size() - 1];
+        }
+
+        // 依次对每块调用 f(const T* data, size_type n)
+        template <class F>
+        void for_each_chunk(F f) const
+        {
+            if (tab_ == nullptr)
+                return;
+            for (size_type k = 0; k < tab_->chunks.size(); ++k)
+                f(static_cast<const T*>(tab_->chunks[k]->data()), tab_->chunks[k]->count);
+        }
+
+        // 修改元素相关操作
+        // 返回可以写入的引用，元素所在的块被共享时先复制这一块
+        reference make_mutable(size_type n)
+        {
+            DW_STL_DEBUG(n < size());
+            make_table_unique();
+            return make_chunk_unique(n >> layout::shift)->data()[n & layout::mask];
+        }
+
+        void set(size_type n, const value_type& value)
+        {
+            THROW_OUT_OF_RANGE_IF(!(n < size()), "cow_vector<T>::set() subscript out of range");
+            make_mutable(n) = value;
+        }
+        void set(size_type n, value_type&& value)
+        {
+            THROW_OUT_OF_RANGE_IF(!(n < size()), "cow_vector<T>::set() subscript out of range");
+            make_mutable(n) = dw_stl::move(value);
+        }
+
+        // 修改容器相关操作
+        template <class... Args>
+        void emplace_back(Args&& ...args);
+
+        void push_back(const value_type& value)
+        { emplace_back(value); }
+        void push_back(value_type&& value)
+        { emplace_back(dw_stl::move(value)); }
+
+        void pop_back();
+
+        void resize(size_type new_size)
+        { resize(new_size, value_type()); }
+        void resize(size_type new_size, const value_type& value);
+
+        // 存储被共享时只放弃共享，不析构元素
+        void clear() noexcept
+        { release(); }
+
+        void swap(cow_vector& rhs) noexcept
+        {
+            if (this != &rhs)
+            {
+                dw_stl::alloc_on_swap(this->alloc(), rhs.alloc());
+                dw_stl::swap(tab_, rhs.tab_);
+            }
+        }
+
+    private:
+        typename const_iterator::map_pointer map() const noexcept
+        {
+            return tab_ == nullptr ? nullptr
+                : const_cast<typename const_iterator::map_pointer>(tab_->chunks.data());
+        }
+
+        chunk* new_chunk()
+        {
+            chunk_allocator a(this->alloc());
+            chunk* c = chunk_traits::allocate(a, 1);
+            chunk_traits::construct(a, c);
+            return c;
+        }
+
+        // 减少块的引用计数，变为 0 时析构其中的元素并释放
+        void release_chunk(chunk* c) noexcept
+        {
+            if (c->refs.fetch_sub(1, std::memory_order_acq_rel) != 1)
+                return;
+            alloc_traits::destroy(this->alloc(), c->data(), c->data() + c->count);
+            chunk_allocator a(this->alloc());
+            chunk_traits::destroy(a, c);
+            chunk_traits::deallocate(a, c, 1);
+        }
+
+        // 放弃对表的引用，最后一个引用释放表以及表中的块
+        void release() noexcept
+        {
+            if (tab_ == nullptr)
+                return;
+            if (tab_->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                for (size_type k = 0; k < tab_->chunks.size(); ++k)
+                    release_chunk(tab_->chunks[k]);
+                table_allocator a(this->alloc());
+                table_traits::destroy(a, tab_);
+                table_traits::deallocate(a, tab_, 1);
+            }
+            tab_ = nullptr;
+        }
+
+        // 用自己的分配器复制rhs的全部元素，替换原来的内容
+        void copy_from(const cow_vector& rhs)
+        {
+            cow_vector tmp(this->alloc());
+            tmp.reserve(rhs.size());
+            rhs.for_each_chunk([&tmp](const T* data, size_type n)
+            {
+                for (size_type i = 0; i < n; ++i)
+                    tmp.push_back(data[i]);
+            });
+            release();
+            tab_ = tmp.tab_;
+            tmp.tab_ = nullptr;
+        }
+
+        // 保证表没有被共享：没有表时新建一张，被共享时复制块的指针
+        void make_table_unique();
+        // 保证第k块没有被共享，返回这一块，调用前表已经没有被共享
+        chunk* make_chunk_unique(size_type k);
+    };
+
+    /*****************************************************************************************/
+
+    template <class T, class Alloc>
+    constexpr typename cow_vector<T, Alloc>::size_type cow_vector<T, Alloc>::chunk_size;
+
+    template <class T, class Alloc>
+    void cow_vector<T, Alloc>::make_table_unique()
+    {
+        if (unique() && tab_ != nullptr)
+            return;
+        table_allocator a(this->alloc());
+        table* t = table_traits::allocate(a, 1);
+        try
+        {
+            table_traits::construct(a, t, map_allocator(this->alloc()));
+        }
+        catch (...)
+        {
+            table_traits::deallocate(a, t, 1);
+            throw;
+        }
+        if (tab_ != nullptr)
+        {
+            try
+            {
+                t->chunks.reserve(tab_->chunks.capacity());
+                t->chunks.assign(tab_->chunks.begin(), tab_->chunks.end());
+            }
+            catch (...)
+            {
+                table_traits::destroy(a, t);
+                table_traits::deallocate(a, t, 1);
+                throw;
+            }
+            t->size = tab_->size;
+            for (size_type k = 0; k < t->chunks.size(); ++k)
+                t->chunks[k]->refs.fetch_add(1, std::memory_order_relaxed);
+            release();
+        }
+        tab_ = t;
+    }
+
+    template <class T, class Alloc>
+    typename cow_vector<T, Alloc>::chunk*
+    cow_vector<T, Alloc>::make_chunk_unique(size_type k)
+    {
+        chunk* old = tab_->chunks[k];
+        if (old->refs.load(std::memory_order_acquire) == 1)
+            return old;
+        chunk* c = new_chunk();
+        try
+        {
+            dw_stl::uninitialized_copy(old->data(), old->data() + old->count, c->data());
+        }
+        catch (...)
+        {
+            chunk_allocator a(this->alloc());
+            chunk_traits::destroy(a, c);
+            chunk_traits::deallocate(a, c, 1);
+            throw;
+        }
+        c->count = old->count;
+        tab_->chunks[k] = c;
+        release_chunk(old);
+        return c;
+    }
+
+    // 在尾部就地构造元素，最后一块已满时追加一块
+    template <class T, class Alloc>
+    template <class... Args>
+    void cow_vector<T, Alloc>::emplace_back(Args&& ...args)
+    {
+        THROW_LENGTH_ERROR_IF(size() == max_size(), "cow_vector<T> size too big");
+        make_table_unique();
+        const size_type n = tab_->size;
+        chunk* c;
+        if ((n & layout::mask) == 0)
+        {
+            tab_->chunks.reserve(tab_->chunks.size() + 1);
+            c = new_chunk();
+            try
+            {
+                alloc_traits::construct(this->alloc(), c->data(), dw_stl::forward<Args>(args)...);
+            }
+            catch (...)
+            {
+                release_chunk(c);
+                throw;
+            }
+            tab_->chunks.push_back(c);
+        }
+        else
+        {
+            c = make_chunk_unique(n >> layout::shift);
+            alloc_traits::construct(this->alloc(), c->data() + c->count, dw_stl::forward<Args>(args)...);
+        }
+        ++c->count;
+        ++tab_->size;
+    }
+
+    // 删除尾部元素，最后一块变空时释放这一块
+    template <class T, class Alloc>
+    void cow_vector<T, Alloc>::pop_back()
+    {
+        DW_STL_DEBUG(!empty());
+        make_table_unique();
+        const size_type k = tab_->chunks.size() - 1;
+        if (tab_->chunks[k]->count == 1)
+        {
+            // 只剩一个元素的块直接放弃，不需要先复制
+            release_chunk(tab_->chunks[k]);
+            tab_->chunks.pop_back();
+        }
+        else
+        {
+            chunk* c = make_chunk_unique(k);
+            --c->count;
+            alloc_traits::destroy(this->alloc(), c->data() + c->count);
+        }
+        --tab_->size;
+    }
+
+    template <class T, class Alloc>
+    void cow_vector<T, Alloc>::resize(size_type new_size, const value_type& value)
+    {
+        if (new_size == size())
+            return;
+        if (new_size == 0)
+        {
+            clear();
+            return;
+        }
+        make_table_unique();
+        while (tab_->size > new_size)
+            pop_back();
+        if (tab_->size < new_size)
+        {
+            // value 可能是容器中的元素，复制块之后会失效
+            const value_type value_copy = value;
+            reserve(new_size);
+            while (tab_->size < new_size)
+                emplace_back(value_copy);
+        }
+    }
+
+    /****************************************************************************/
+    // 重载比较操作符
+    template <class T, class Alloc>
+    bool operator==(const cow_vector<T, Alloc>& lhs, const cow_vector<T, Alloc>& rhs)
+    {
+        return lhs.size() == rhs.size() &&
+            dw_stl::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+
+    template <class T, class Alloc>
+    bool operator!=(const cow_vector<T, Alloc>& lhs, const cow_vector<T, Alloc>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    template <class T, class Alloc>
+    bool operator<(const cow_vector<T, Alloc>& lhs, const cow_vector<T, Alloc>& rhs)
+    {
+        return dw_stl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+
+    // 重载dw_stl的swap
+    template <class T, class Alloc>
+    void swap(cow_vector<T, Alloc>& lhs, cow_vector<T, Alloc>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+
+    // cow_vector只保存表的指针，可以按字节移动
+    template <class T, class Alloc>
+    struct is_trivially_relocatable<cow_vector<T, Alloc>>
+        : is_trivially_relocatable<Alloc> {};
+}
+
+#endif
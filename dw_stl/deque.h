@@ -12,14 +12,22 @@ dw_stl::deque<T> 满足基本异常保证，部分函数无异常保证，并对
    * push_front
    * push_back
    * insert
+
+缓冲区回收：
+pop_front、pop_back、erase、clear 释放的缓冲区先放入每个 deque 自己的缓存，create_buffer 优先从缓存中取，
+作为 queue 的底层容器时头部释放的缓冲区会在尾部重新使用，稳定之后不再调用分配器。
+缓存最多保存 DW_STL_DEQUE_SPARE_BLOCKS 个缓冲区，可以用 set_spare_limit 修改，shrink_to_fit 会把缓存还给分配器。
 */
 
+#include <cstring>
 #include <initializer_list>
 
 #include "iterator.h"
 #include "memory.h"
 #include "util.h"
 #include "exceptdef.h"
+#include "allocator_traits.h"
+#include "algo.h"
 
 namespace dw_stl
 {
@@ -39,6 +47,11 @@ namespace dw_stl
     #define DEQUE_MAP_INIT_SIZE 8
     #endif
 
+    // 每个 deque 默认最多缓存的空闲缓冲区个数
+    #ifndef DW_STL_DEQUE_SPARE_BLOCKS
+    #define DW_STL_DEQUE_SPARE_BLOCKS 4
+    #endif
+
     template <class T>
     struct deque_buf_size
     {
@@ -91,7 +104,8 @@ namespace dw_stl
         deque_iterator(const const_iterator& rhs)
             :cur(rhs.cur), first(rhs.first), last(rhs.last), node(rhs.node) {}
 
-        self& operator=(const iterator& rhs)
+        // const_iterator 也需要自己的复制赋值，iterator 通过上面的构造函数转换之后赋值
+        self& operator=(const self& rhs)
         {
             if (this != &rhs)
             {
@@ -202,23 +216,27 @@ namespace dw_stl
     };
 
     // 模板类deque
-    // 模板参数代表数据类型
-    template <class T>
-    class deque
+    // 模板参数T代表数据类型，Alloc代表分配器类型，默认使用dw_stl::allocator<T>
+    // 中控器map使用由Alloc rebind得到的分配器分配
+    template <class T, class Alloc = dw_stl::allocator<T>>
+    class deque : private dw_stl::allocator_holder<Alloc>
     {
+        static_assert(std::is_same<T, typename Alloc::value_type>::value,
+                      "The value_type of Alloc should be same with T");
     public:
         // deque的型别定义
-        typedef dw_stl::allocator<T>                      allocator_type;
-        typedef dw_stl::allocator<T>                      data_allocator;
-        typedef dw_stl::allocator<T*>                     map_allocator;
-
-        typedef typename allocator_type::value_type      value_type;
-        typedef typename allocator_type::pointer         pointer;
-        typedef typename allocator_type::const_pointer   const_pointer;
-        typedef typename allocator_type::reference       reference;
-        typedef typename allocator_type::const_reference const_reference;
-        typedef typename allocator_type::size_type       size_type;
-        typedef typename allocator_type::difference_type difference_type;
+        typedef Alloc                                                  allocator_type;
+        typedef dw_stl::allocator_traits<Alloc>                        alloc_traits;
+        typedef typename alloc_traits::template rebind_map_alloc<T*>   map_allocator;
+        typedef dw_stl::allocator_traits<map_allocator>                map_traits;
+
+        typedef T                                        value_type;
+        typedef T*                                       pointer;
+        typedef const T*                                 const_pointer;
+        typedef T&                                       reference;
+        typedef const T&                                 const_reference;
+        typedef typename alloc_traits::size_type         size_type;
+        typedef typename alloc_traits::difference_type   difference_type;
         // 中控器map指针
         typedef pointer*                                 map_pointer;
         typedef const_pointer*                           const_map_pointer;
@@ -228,58 +246,90 @@ namespace dw_stl
         typedef dw_stl::reverse_iterator<iterator>        reverse_iterator;
         typedef dw_stl::reverse_iterator<const_iterator>  const_reverse_iterator;
 
-        allocator_type get_allocator() { return allocator_type(); }
+        allocator_type get_allocator() const { return this->alloc(); }
 
         static const size_type buffer_size = deque_buf_size<T>::value;
 
     private:
+        typedef dw_stl::allocator_holder<Alloc>          holder_base;
+
         // 用以下四个指针来实现一个，使其表现出线性容器的特性
         iterator       begin_;     // 指向第一个节点
         iterator       end_;       // 指向最后一个节点
         map_pointer    map_;       // 指向一块map，map中的每个元素都是一个指针，指向一个缓冲区
         size_type      map_size_;  // map内指针的数目
 
+        // 空闲缓冲区的缓存，用缓冲区开头的空间串成单链表
+        pointer        spare_ = nullptr;
+        size_type      spare_count_ = 0;
+        size_type      spare_limit_ = DW_STL_DEQUE_SPARE_BLOCKS;
+
     public:
         // 构造、复制、移动、析构函数
 
         deque() 
         { 
-            fill_init(0, value_type()); 
+            map_init(0); 
+        }
+
+        explicit deque(const allocator_type& alloc)
+            :holder_base(alloc)
+        {
+            map_init(0);
         }
 
-        explicit deque(size_type n)
+        explicit deque(size_type n, const allocator_type& alloc = allocator_type())
+            :holder_base(alloc)
         { 
             fill_init(n, value_type()); 
         }
 
-        deque(size_type n, const value_type& value)
+        deque(size_type n, const value_type& value, const allocator_type& alloc = allocator_type())
+            :holder_base(alloc)
         { 
             fill_init(n, value); 
         }
 
         template <class InputIter, typename std::enable_if<dw_stl::is_input_iterator<InputIter>::value, int>::type = 0>
-        deque(InputIter first, InputIter last)
+        deque(InputIter first, InputIter last, const allocator_type& alloc = allocator_type())
+            :holder_base(alloc)
         { 
             copy_init(first, last, iterator_category(first)); 
         }
 
-        deque(std::initializer_list<value_type> ilist)
+        deque(std::initializer_list<value_type> ilist, const allocator_type& alloc = allocator_type())
+            :holder_base(alloc)
         {
             copy_init(ilist.begin(), ilist.end(), dw_stl::forward_iterator_tag());
         }
 
+        // 拷贝构造时由分配器决定新容器使用的分配器
         deque(const deque& rhs)
+            :holder_base(alloc_traits::select_on_container_copy_construction(rhs.alloc()))
         {
             copy_init(rhs.begin(), rhs.end(), dw_stl::forward_iterator_tag());
         }
+
+        deque(const deque& rhs, const allocator_type& alloc)
+            :holder_base(alloc)
+        {
+            copy_init(rhs.begin(), rhs.end(), dw_stl::forward_iterator_tag());
+        }
+
         deque(deque&& rhs) noexcept
-            :begin_(dw_stl::move(rhs.begin_)),
+            :holder_base(dw_stl::move(rhs.alloc())),
+            begin_(dw_stl::move(rhs.begin_)),
             end_(dw_stl::move(rhs.end_)),
             map_(rhs.map_),
-            map_size_(rhs.map_size_)
+            map_size_(rhs.map_size_),
+            spare_(rhs.spare_),
+            spare_count_(rhs.spare_count_),
+            spare_limit_(rhs.spare_limit_)
         {
             rhs.map_ = nullptr;
             rhs.map_size_ = 0;
+            rhs.spare_ = nullptr;
+            rhs.spare_count_ = 0;
         }
 
         deque& operator=(const deque& rhs);
@@ -287,21 +337,14 @@ namespace dw_stl
 
         deque& operator=(std::initializer_list<value_type> ilist)
         {
-            deque tmp(ilist);
+            deque tmp(ilist, this->alloc());
             swap(tmp);
             return *this;
         }
 
         ~deque()
         {
-            if (map_ != nullptr)
-            {
-                clear();
-                data_allocator::deallocate(*begin_.node, buffer_size);
-                *begin_.node = nullptr;
-                map_allocator::deallocate(map_, map_size_);
-                map_ = nullptr;
-            }
+            release();
         }
 
         public:
@@ -343,15 +386,20 @@ namespace dw_stl
         void resize(size_type new_size, const value_type& value);
         void shrink_to_fit() noexcept;
 
+        // 空闲缓冲区缓存的当前个数与上限，上限为 0 时不缓存
+        size_type spare_blocks() const noexcept { return spare_count_; }
+        size_type spare_limit() const noexcept  { return spare_limit_; }
+        void set_spare_limit(size_type n) noexcept;
+
         // 访问元素相关操作 
         reference operator[](size_type n)
         {
-            dw_stl_DEBUG(n < size());
+            DW_STL_DEBUG(n < size());
             return begin_[n];
         }
         const_reference operator[](size_type n) const
         {
-            dw_stl_DEBUG(n < size());
+            DW_STL_DEBUG(n < size());
             return begin_[n];
         }
 
@@ -368,22 +416,22 @@ namespace dw_stl
 
         reference front()
         {
-            dw_stl_DEBUG(!empty());
+            DW_STL_DEBUG(!empty());
             return *begin();
         }
         const_reference front() const
         {
-            dw_stl_DEBUG(!empty());
+            DW_STL_DEBUG(!empty());
             return *begin();
         }
         reference back()
         {
-            dw_stl_DEBUG(!empty());
+            DW_STL_DEBUG(!empty());
             return *(end() - 1);
         }
         const_reference back() const
         {
-            dw_stl_DEBUG(!empty());
+            DW_STL_DEBUG(!empty());
             return *(end() - 1);
         }
 
@@ -445,6 +493,30 @@ namespace dw_stl
             insert_dispatch(position, first, last, iterator_category(first)); 
         }
 
+        // 批量插入[first, last)
+        // 前向迭代器一次申请好需要的缓冲区，再逐个缓冲区复制，来源是指针并且元素可以平凡复制时整块复制；
+        // 输入迭代器逐个插入到离position较近的一端，再旋转到position处
+        template <class Iter, typename std::enable_if<dw_stl::is_input_iterator<Iter>::value, int>::type = 0>
+        iterator insert_range(iterator position, Iter first, Iter last)
+        {
+            const size_type elems_before = position - begin_;
+            insert_dispatch(position, first, last, iterator_category(first));
+            return begin_ + elems_before;
+        }
+
+        template <class Range, typename std::enable_if<dw_stl::is_range<Range>::value, int>::type = 0>
+        iterator insert_range(iterator position, const Range& r)
+        { return insert_range(position, r.begin(), r.end()); }
+
+        // 在尾部追加[first, last)
+        template <class Iter, typename std::enable_if<dw_stl::is_input_iterator<Iter>::value, int>::type = 0>
+        void append_range(Iter first, Iter last)
+        { insert_dispatch(end_, first, last, iterator_category(first)); }
+
+        template <class Range, typename std::enable_if<dw_stl::is_range<Range>::value, int>::type = 0>
+        void append_range(const Range& r)
+        { append_range(r.begin(), r.end()); }
+
         // erase、clear
 
         iterator erase(iterator position);
@@ -463,6 +535,28 @@ namespace dw_stl
         void create_buffer(map_pointer nstart, map_pointer nfinish);
         void destroy_buffer(map_pointer nstart, map_pointer nfinish);
 
+        // 单个缓冲区的分配与释放，优先使用空闲缓冲区的缓存
+        pointer allocate_block();
+        void deallocate_block(pointer block) noexcept;
+        void release_spare() noexcept;
+        // 释放 map 中不在使用范围内的缓冲区
+        void free_unused_nodes() noexcept;
+
+        // 中控器map的分配与释放, 使用rebind_map得到的map_allocator
+        map_pointer allocate_map(size_type n)
+        {
+            map_allocator ma(this->alloc());
+            return map_traits::allocate(ma, n);
+        }
+        void deallocate_map(map_pointer mp, size_type n)
+        {
+            map_allocator ma(this->alloc());
+            map_traits::deallocate(ma, mp, n);
+        }
+
+        // 析构所有元素并释放全部的空间
+        void release();
+
         // 初始化
         void map_init(size_type nelem);
         void fill_init(size_type n, const value_type& value);
@@ -488,9 +582,23 @@ namespace dw_stl
         void insert_dispatch(iterator, InputIter, InputIter, input_iterator_tag);
         template <class ForwardIter>
         void insert_dispatch(iterator, ForwardIter, ForwardIter, forward_iterator_tag);
+        // 把[first, first + n)逐个缓冲区复制到end_开始的未初始化空间，调用前已经申请好缓冲区
+        template <class ForwardIter>
+        void copy_to_back(ForwardIter first, size_type n);
+
+        // 元素可以按字节迁移时，插入和删除整块移动元素，不需要逐个移动构造和析构
+        typedef dw_stl::is_trivially_relocatable<T>                  can_relocate;
+        typedef typename std::aligned_storage<sizeof(T), alignof(T)>::type raw_storage;
+
+        // 按缓冲区分段迁移[first, last)，relocate_forward迁移到result开始的位置(result不在first之后)，
+        // relocate_backward迁移到以result结尾的位置(result不在last之前)
+        iterator relocate_forward(iterator first, iterator last, iterator result);
+        iterator relocate_backward(iterator first, iterator last, iterator result);
+        void     destroy_range(iterator first, iterator last);
 
         // 重分配
         void require_capacity(size_type n, bool front);
+        bool recenter_map(size_type need, bool front);
         void reallocate_map_at_front(size_type need);
         void reallocate_map_at_back(size_type need);
 
@@ -499,43 +607,71 @@ namespace dw_stl
     /*****************************************************************************************/
 
     // 拷贝赋值运算符
-    template <class T>
-    deque<T>& deque<T>::operator=(const deque& rhs)
+    template <class T, class Alloc>
+    deque<T, Alloc>& deque<T, Alloc>::operator=(const deque& rhs)
     {
     if (this != &rhs)
     {
+        // 如果分配器需要传播且两个分配器不相等，原来的空间只能由原来的分配器释放
+        if (alloc_traits::propagate_on_container_copy_assignment::value &&
+            !dw_stl::alloc_equal(this->alloc(), rhs.alloc()))
+        {
+            release();
+            dw_stl::alloc_on_copy(this->alloc(), rhs.alloc());
+            map_init(0);
+        }
         const auto len = size();
         if (len >= rhs.size())
         {
-            erase(dw_stl::copy(rhs.begin_, rhs.end_, begin_), end_);
+            erase(dw_stl::copy(rhs.begin(), rhs.end(), begin_), end_);
         }
         else
         {
-            iterator mid = rhs.begin() + static_cast<difference_type>(len);
-            dw_stl::copy(rhs.begin_, mid, begin_);
-            insert(end_, mid, rhs.end_);
+            const_iterator mid = rhs.begin() + static_cast<difference_type>(len);
+            dw_stl::copy(rhs.begin(), mid, begin_);
+            insert(end_, mid, rhs.end());
         }
     }
     return *this;
     }
 
     // 移动赋值运算符(右值引用)
-    template <class T>
-    deque<T>& deque<T>::operator=(deque&& rhs)
+    template <class T, class Alloc>
+    deque<T, Alloc>& deque<T, Alloc>::operator=(deque&& rhs)
     {
-        clear();
-        begin_ = dw_stl::move(rhs.begin_);
-        end_ = dw_stl::move(rhs.end_);
-        map_ = rhs.map_;
-        map_size_ = rhs.map_size_;
-        rhs.map_ = nullptr;
-        rhs.map_size_ = 0;
+        if (this == &rhs)
+            return *this;
+        if (alloc_traits::propagate_on_container_move_assignment::value ||
+            dw_stl::alloc_equal(this->alloc(), rhs.alloc()))
+        {
+            // 先释放自己的空间，再接管rhs的空间
+            release();
+            dw_stl::alloc_on_move(this->alloc(), rhs.alloc());
+            begin_ = dw_stl::move(rhs.begin_);
+            end_ = dw_stl::move(rhs.end_);
+            map_ = rhs.map_;
+            map_size_ = rhs.map_size_;
+            spare_ = rhs.spare_;
+            spare_count_ = rhs.spare_count_;
+            rhs.map_ = nullptr;
+            rhs.map_size_ = 0;
+            rhs.spare_ = nullptr;
+            rhs.spare_count_ = 0;
+        }
+        else
+        {
+            // 分配器不相等且不传播，只能逐个移动元素
+            clear();
+            for (auto it = rhs.begin_; it != rhs.end_; ++it)
+                emplace_back(dw_stl::move(*it));
+            rhs.clear();
+        }
         return *this;
     }
 
     // 重置容器大小
-    template <class T>
-    void deque<T>::resize(size_type new_size, const value_type& value)
+    template <class T, class Alloc>
+    void deque<T, Alloc>::resize(size_type new_size, const value_type& value)
     {
         const auto len = size();
         if (new_size < len)
@@ -548,32 +684,37 @@ namespace dw_stl
         }
     }
 
-    // 减小容器容量
-    template <class T>
-    void deque<T>::shrink_to_fit() noexcept
+    // 减小容器容量，同时把缓存的空闲缓冲区还给分配器
+    template <class T, class Alloc>
+    void deque<T, Alloc>::shrink_to_fit() noexcept
     {
-        // 至少会留下头部缓冲区
-        for (auto cur = map_; cur < begin_.node; ++cur)
-        {
-            data_allocator::deallocate(*cur, buffer_size);
-            *cur = nullptr;
-        }
-        for (auto cur = end_.node + 1; cur < map_ + map_size_; ++cur)
+        free_unused_nodes();
+        release_spare();
+    }
+
+    // 修改空闲缓冲区缓存的上限，多出的缓冲区立即释放
+    template <class T, class Alloc>
+    void deque<T, Alloc>::set_spare_limit(size_type n) noexcept
+    {
+        spare_limit_ = n;
+        while (spare_count_ > spare_limit_)
         {
-            data_allocator::deallocate(*cur, buffer_size);
-            *cur = nullptr;
+            pointer block = spare_;
+            std::memcpy(&spare_, block, sizeof(pointer));
+            --spare_count_;
+            alloc_traits::deallocate(this->alloc(), block, buffer_size);
         }
     }
 
     // 在头部就地构建元素(emplace_front, 减少一次拷贝构造)
-    template <class T>
+    template <class T, class Alloc>
     template <class ...Args>
-    void deque<T>::emplace_front(Args&& ...args)
+    void deque<T, Alloc>::emplace_front(Args&& ...args)
     {
         // 如果容量够
         if (begin_.cur != begin_.first)
         {
-            data_allocator::construct(begin_.cur - 1, dw_stl::forward<Args>(args)...);
+            alloc_traits::construct(this->alloc(), begin_.cur - 1, dw_stl::forward<Args>(args)...);
             --begin_.cur;
         }
         // 如果容量不够
@@ -583,7 +724,7 @@ namespace dw_stl
             try
             {
                 --begin_;
-                data_allocator::construct(begin_.cur, dw_stl::forward<Args>(args)...);
+                alloc_traits::construct(this->alloc(), begin_.cur, dw_stl::forward<Args>(args)...);
             }
             catch (...)
             {
@@ -594,13 +735,13 @@ namespace dw_stl
     }
 
     // 在尾部就地构建元素
-    template <class T>
+    template <class T, class Alloc>
     template <class ...Args>
-    void deque<T>::emplace_back(Args&& ...args)
+    void deque<T, Alloc>::emplace_back(Args&& ...args)
     {
         if (end_.cur != end_.last - 1)
         {
-            data_allocator::construct(end_.cur, dw_stl::forward<Args>(args)...);
+            alloc_traits::construct(this->alloc(), end_.cur, dw_stl::forward<Args>(args)...);
             ++end_.cur;
         }
         // 容量不够，申请容量
@@ -608,15 +749,15 @@ namespace dw_stl
         {
             // false表示在尾部申请容量
             require_capacity(1, false);
-            data_allocator::construct(end_.cur, dw_stl::forward<Args>(args)...);
+            alloc_traits::construct(this->alloc(), end_.cur, dw_stl::forward<Args>(args)...);
             ++end_;
         }
     }
 
     // 在pos位置就地构建元素
-    template <class T>
+    template <class T, class Alloc>
     template <class ...Args>
-    typename deque<T>::iterator deque<T>::emplace(iterator pos, Args&& ...args)
+    typename deque<T, Alloc>::iterator deque<T, Alloc>::emplace(iterator pos, Args&& ...args)
     {
         if (pos.cur == begin_.cur)
         {
@@ -632,12 +773,12 @@ namespace dw_stl
     }
 
     // 在头部插入元素
-    template <class T>
-    void deque<T>::push_front(const value_type& value)
+    template <class T, class Alloc>
+    void deque<T, Alloc>::push_front(const value_type& value)
     {
         if (begin_.cur != begin_.first)
         {
-            data_allocator::construct(begin_.cur - 1, value);
+            alloc_traits::construct(this->alloc(), begin_.cur - 1, value);
             --begin_.cur;
         }
         else
@@ -646,7 +787,7 @@ namespace dw_stl
             try
             {
                 --begin_;
-                data_allocator::construct(begin_.cur, value);
+                alloc_traits::construct(this->alloc(), begin_.cur, value);
             }
             catch (...)
             {
@@ -657,63 +798,63 @@ namespace dw_stl
     }
 
     // 在尾部插入元素
-    template <class T>
-    void deque<T>::push_back(const value_type& value)
+    template <class T, class Alloc>
+    void deque<T, Alloc>::push_back(const value_type& value)
     {
         if (end_.cur != end_.last - 1)
         {
-            data_allocator::construct(end_.cur, value);
+            alloc_traits::construct(this->alloc(), end_.cur, value);
             ++end_.cur;
         }
         else
         {
             require_capacity(1, false);
-            data_allocator::construct(end_.cur, value);
+            alloc_traits::construct(this->alloc(), end_.cur, value);
             ++end_;
         }
     }
 
     // 弹出头部元素
-    template <class T>
-    void deque<T>::pop_front()
+    template <class T, class Alloc>
+    void deque<T, Alloc>::pop_front()
     {
         DW_STL_DEBUG(!empty());
         if (begin_.cur != begin_.last - 1)
         {
-            data_allocator::destroy(begin_.cur);
+            alloc_traits::destroy(this->alloc(), begin_.cur);
             ++begin_.cur;
         }
         else
         {
-            data_allocator::destroy(begin_.cur);
+            alloc_traits::destroy(this->alloc(), begin_.cur);
             ++begin_;
             destroy_buffer(begin_.node - 1, begin_.node - 1);
         }
     }
 
     // 弹出尾部元素
-    template <class T>
-    void deque<T>::pop_back()
+    template <class T, class Alloc>
+    void deque<T, Alloc>::pop_back()
     {
         DW_STL_DEBUG(!empty());
         // 如果没到达头部
         if (end_.cur != end_.first)
         {
             --end_.cur;
-            data_allocator::destroy(end_.cur);
+            alloc_traits::destroy(this->alloc(), end_.cur);
         }
         // 如果到达最后一个buffer的尾部
         else
         {
             --end_;
-            data_allocator::destroy(end_.cur);
+            alloc_traits::destroy(this->alloc(), end_.cur);
             destroy_buffer(end_.node + 1, end_.node + 1);
         }
     }
 
     // 在position处插入元素
-    template <class T>
-    typename deque<T>::iterator deque<T>::insert(iterator position, const value_type& value)
+    template <class T, class Alloc>
+    typename deque<T, Alloc>::iterator deque<T, Alloc>::insert(iterator position, const value_type& value)
     {
         if (position.cur == begin_.cur)
         {
@@ -734,8 +875,8 @@ namespace dw_stl
     }
 
     // 右值引用版本
-    template <class T>
-    typename deque<T>::iterator deque<T>::insert(iterator position, value_type&& value)
+    template <class T, class Alloc>
+    typename deque<T, Alloc>::iterator deque<T, Alloc>::insert(iterator position, value_type&& value)
     {
         if (position.cur == begin_.cur)
         {
@@ -756,8 +897,8 @@ namespace dw_stl
     }
 
     // 在position位置插入n个元素
-    template <class T>
-    void deque<T>::insert(iterator position, size_type n, const value_type& value)
+    template <class T, class Alloc>
+    void deque<T, Alloc>::insert(iterator position, size_type n, const value_type& value)
     {
         if (position.cur == begin_.cur)
         {
@@ -780,29 +921,34 @@ namespace dw_stl
     }
 
     // 删除position处的元素
-    template <class T>
-    typename deque<T>::iterator deque<T>::erase(iterator position)
+    template <class T, class Alloc>
+    typename deque<T, Alloc>::iterator deque<T, Alloc>::erase(iterator position)
     {
+        if (can_relocate::value)
+            return erase(position, position + 1);
         auto next = position;
         ++next;
         const size_type elems_before = position - begin_;
         if (elems_before < (size() / 2))
         {
-            dw_stl::copy_backward(begin_, position, next);
+            dw_stl::move_backward(begin_, position, next);
             pop_front();
         }
         else
         {
-            dw_stl::copy(next, end_, position);
+            dw_stl::move(next, end_, position);
             pop_back();
         }
         return begin_ + elems_before;
     }
 
     // 删除[first, last)上的元素
-    template <class T>
-    typename deque<T>::iterator deque<T>::erase(iterator first, iterator last)
+    template <class T, class Alloc>
+    typename deque<T, Alloc>::iterator deque<T, Alloc>::erase(iterator first, iterator last)
     {
+        // 空区间直接返回，避免元素移动赋值给自己
+        if (first == last)
+            return first;
         if (first == begin_ && last == end_)
         {
             clear();
@@ -814,16 +960,35 @@ namespace dw_stl
             const size_type elems_before = first - begin_;
             if (elems_before < ((size() - len) / 2))
             {
-                dw_stl::copy_backward(begin_, first, last);
                 auto new_begin = begin_ + len;
-                data_allocator::destroy(begin_.cur, new_begin.cur);
+                if (can_relocate::value)
+                {
+                    // 析构被删除的元素，前面的元素整块后移
+                    destroy_range(first, last);
+                    relocate_backward(begin_, first, last);
+                }
+                else
+                {
+                    dw_stl::move_backward(begin_, first, last);
+                    destroy_range(begin_, new_begin);
+                }
+                destroy_buffer(begin_.node, new_begin.node - 1);
                 begin_ = new_begin;
             }
             else
             {
-                dw_stl::copy(last, end_, first);
                 auto new_end = end_ - len;
-                data_allocator::destroy(new_end.cur, end_.cur);
+                if (can_relocate::value)
+                {
+                    destroy_range(first, last);
+                    relocate_forward(last, end_, first);
+                }
+                else
+                {
+                    dw_stl::move(last, end_, first);
+                    destroy_range(new_end, end_);
+                }
+                destroy_buffer(new_end.node + 1, end_.node);
                 end_ = new_end;
             }
             return begin_ + elems_before;
@@ -831,13 +996,13 @@ namespace dw_stl
     }
 
     // 清空deque
-    template <class T>
-    void deque<T>::clear()
+    template <class T, class Alloc>
+    void deque<T, Alloc>::clear()
     {
         // clear会保留头部的缓冲区
         for (map_pointer cur = begin_.node + 1; cur < end_.node; ++cur)
         {
-            data_allocator::destroy(*cur, *cur + buffer_size);
+            alloc_traits::destroy(this->alloc(), *cur, *cur + buffer_size);
         }
         if (begin_.node != end_.node)
         { 
@@ -849,47 +1014,54 @@ namespace dw_stl
         {
             dw_stl::destroy(begin_.cur, end_.cur);
         }
-        shrink_to_fit();
+        free_unused_nodes();
+        // 释放除头部以外的缓冲区
+        if (begin_.node != end_.node)
+            destroy_buffer(begin_.node + 1, end_.node);
         end_ = begin_;
     }
 
     // 交换deque, 实际只是交换两个deque内部的迭代器
-    template <class T>
-    void deque<T>::swap(deque& rhs) noexcept
+    template <class T, class Alloc>
+    void deque<T, Alloc>::swap(deque& rhs) noexcept
     {
         if (this != &rhs)
         {
+            dw_stl::alloc_on_swap(this->alloc(), rhs.alloc());
             dw_stl::swap(begin_, rhs.begin_);
             dw_stl::swap(end_, rhs.end_);
             dw_stl::swap(map_, rhs.map_);
             dw_stl::swap(map_size_, rhs.map_size_);
+            dw_stl::swap(spare_, rhs.spare_);
+            dw_stl::swap(spare_count_, rhs.spare_count_);
+            dw_stl::swap(spare_limit_, rhs.spare_limit_);
         }
     }
 
     /*****************************************************************************************/
     // 实现上述接口的一些辅助函数
 
-    template <class T>
-    typename deque<T>::map_pointer
-    deque<T>::create_map(size_type size)
+    template <class T, class Alloc>
+    typename deque<T, Alloc>::map_pointer
+    deque<T, Alloc>::create_map(size_type size)
     {
         map_pointer mp = nullptr;
-        mp = map_allocator::allocate(size);
+        mp = allocate_map(size);
         for (size_type i = 0; i < size; ++i)
             *(mp + i) = nullptr;
         return mp;
     }
 
     // create_buffer函数
-    template <class T>
-    void deque<T>::create_buffer(map_pointer nstart, map_pointer nfinish)
+    template <class T, class Alloc>
+    void deque<T, Alloc>::create_buffer(map_pointer nstart, map_pointer nfinish)
     {
         map_pointer cur;
         try
         {
             for (cur = nstart; cur <= nfinish; ++cur)
             {
-                *cur = data_allocator::allocate(buffer_size);
+                *cur = allocate_block();
             }
         }
         // 异常发生时退回到函数调用之前的状态
@@ -898,27 +1070,106 @@ namespace dw_stl
             while (cur != nstart)
             {
                 --cur;
-                data_allocator::deallocate(*cur, buffer_size);
+                deallocate_block(*cur);
                 *cur = nullptr;
             }
             throw;
         }
     }
 
+    // allocate_block 函数, 缓存不为空时取出第一个缓冲区
+    template <class T, class Alloc>
+    typename deque<T, Alloc>::pointer deque<T, Alloc>::allocate_block()
+    {
+        if (spare_ != nullptr)
+        {
+            pointer block = spare_;
+            // 缓冲区不一定按指针对齐，用 memcpy 读写链表指针
+            std::memcpy(&spare_, block, sizeof(pointer));
+            --spare_count_;
+            return block;
+        }
+        return alloc_traits::allocate(this->alloc(), buffer_size);
+    }
+
+    // deallocate_block 函数, 缓存未满时放入缓存
+    template <class T, class Alloc>
+    void deque<T, Alloc>::deallocate_block(pointer block) noexcept
+    {
+        if (spare_count_ < spare_limit_)
+        {
+            std::memcpy(static_cast<void*>(block), &spare_, sizeof(pointer));
+            spare_ = block;
+            ++spare_count_;
+            return;
+        }
+        alloc_traits::deallocate(this->alloc(), block, buffer_size);
+    }
+
+    // release_spare 函数, 释放缓存中的全部缓冲区
+    template <class T, class Alloc>
+    void deque<T, Alloc>::release_spare() noexcept
+    {
+        while (spare_ != nullptr)
+        {
+            pointer block = spare_;
+            std::memcpy(&spare_, block, sizeof(pointer));
+            alloc_traits::deallocate(this->alloc(), block, buffer_size);
+        }
+        spare_count_ = 0;
+    }
+
+    // free_unused_nodes 函数, 至少会留下头部缓冲区
+    template <class T, class Alloc>
+    void deque<T, Alloc>::free_unused_nodes() noexcept
+    {
+        // 没有分配缓冲区的节点为 nullptr，不交给分配器
+        for (auto cur = map_; cur < begin_.node; ++cur)
+        {
+            if (*cur == nullptr)
+                continue;
+            alloc_traits::deallocate(this->alloc(), *cur, buffer_size);
+            *cur = nullptr;
+        }
+        for (auto cur = end_.node + 1; cur < map_ + map_size_; ++cur)
+        {
+            if (*cur == nullptr)
+                continue;
+            alloc_traits::deallocate(this->alloc(), *cur, buffer_size);
+            *cur = nullptr;
+        }
+    }
+
+    // release 函数, 析构所有元素并释放缓冲区与map
+    template <class T, class Alloc>
+    void deque<T, Alloc>::release()
+    {
+        if (map_ != nullptr)
+        {
+            clear();
+            alloc_traits::deallocate(this->alloc(), *begin_.node, buffer_size);
+            *begin_.node = nullptr;
+            deallocate_map(map_, map_size_);
+            map_ = nullptr;
+            map_size_ = 0;
+        }
+        release_spare();
+    }
+
     // destroy_buffer 函数
-    template <class T>
-    void deque<T>::destroy_buffer(map_pointer nstart, map_pointer nfinish)
+    template <class T, class Alloc>
+    void deque<T, Alloc>::destroy_buffer(map_pointer nstart, map_pointer nfinish)
     {
         for (map_pointer n = nstart; n <= nfinish; ++n)
         {
-            data_allocator::deallocate(*n, buffer_size);
+            deallocate_block(*n);
             *n = nullptr;
         }
     }
 
     // map_init函数, 初始化map
-    template <class T>
-    void deque<T>::map_init(size_type nElem)
+    template <class T, class Alloc>
+    void deque<T, Alloc>::map_init(size_type nElem)
     {
         // 需要分配的缓冲区个数
         const size_type nNode = nElem / buffer_size + 1;  
@@ -943,7 +1194,7 @@ namespace dw_stl
         }
         catch (...)
         {
-            map_allocator::deallocate(map_, map_size_);
+            deallocate_map(map_, map_size_);
             map_ = nullptr;
             map_size_ = 0;
             throw;
@@ -955,8 +1206,8 @@ namespace dw_stl
     }
 
     // fill_init 函数
-    template <class T>
-    void deque<T>::fill_init(size_type n, const value_type& value)
+    template <class T, class Alloc>
+    void deque<T, Alloc>::fill_init(size_type n, const value_type& value)
     {
         map_init(n);
         if (n != 0)
@@ -970,20 +1221,20 @@ namespace dw_stl
     }
 
     // copy_init 函数
-    template <class T>
+    template <class T, class Alloc>
     template <class InputIter>
-    void deque<T>::
+    void deque<T, Alloc>::
     copy_init(InputIter first, InputIter last, input_iterator_tag)
     {
-        const size_type n = dw_stl::distance(first, last);
-        map_init(n);
+        // 输入迭代器只能遍历一次，不能先求出元素个数
+        map_init(0);
         for (; first != last; ++first)
             emplace_back(*first);
     }
 
-    template <class T>
+    template <class T, class Alloc>
     template <class ForwardIter>
-    void deque<T>::copy_init(ForwardIter first, ForwardIter last, forward_iterator_tag)
+    void deque<T, Alloc>::copy_init(ForwardIter first, ForwardIter last, forward_iterator_tag)
     {
         const size_type n = dw_stl::distance(first, last);
         map_init(n);
@@ -998,8 +1249,8 @@ namespace dw_stl
     }
 
     // fill_assign 函数
-    template <class T>
-    void deque<T>::fill_assign(size_type n, const value_type& value)
+    template <class T, class Alloc>
+    void deque<T, Alloc>::fill_assign(size_type n, const value_type& value)
     {
         if (n > size())
         {
@@ -1014,9 +1265,9 @@ namespace dw_stl
     }
 
     // copy_assign 函数
-    template <class T>
+    template <class T, class Alloc>
     template <class InputIter>
-    void deque<T>::copy_assign(InputIter first, InputIter last, input_iterator_tag)
+    void deque<T, Alloc>::copy_assign(InputIter first, InputIter last, input_iterator_tag)
     {
         auto first1 = begin();
         auto last1 = end();
@@ -1034,9 +1285,9 @@ namespace dw_stl
         }
     }
 
-    template <class T>
+    template <class T, class Alloc>
     template <class ForwardIter>
-    void deque<T>::copy_assign(ForwardIter first, ForwardIter last, forward_iterator_tag)
+    void deque<T, Alloc>::copy_assign(ForwardIter first, ForwardIter last, forward_iterator_tag)
     {  
         const size_type len1 = size();
         const size_type len2 = dw_stl::distance(first, last);
@@ -1054,18 +1305,50 @@ namespace dw_stl
     }
 
     // insert_aux 函数
-    template <class T>
+    template <class T, class Alloc>
     template <class... Args>
-    typename deque<T>::iterator
-    deque<T>::insert_aux(iterator position, Args&& ...args)
+    typename deque<T, Alloc>::iterator
+    deque<T, Alloc>::insert_aux(iterator position, Args&& ...args)
     {
         const size_type elems_before = position - begin_;
+        if (can_relocate::value)
+        {
+            // 先在临时空间构造新元素，整块挪动一侧的元素之后把新元素迁移到空出的位置
+            raw_storage buf;
+            auto tmp = reinterpret_cast<T*>(&buf);
+            alloc_traits::construct(this->alloc(), tmp, dw_stl::forward<Args>(args)...);
+            const bool front = elems_before < (size() / 2);
+            try
+            {
+                require_capacity(1, front);
+            }
+            catch (...)
+            {
+                alloc_traits::destroy(this->alloc(), tmp);
+                throw;
+            }
+            if (front)
+            {
+                auto new_begin = begin_ - 1;
+                relocate_forward(begin_, begin_ + elems_before, new_begin);
+                begin_ = new_begin;
+            }
+            else
+            {
+                auto new_end = end_ + 1;
+                relocate_backward(begin_ + elems_before, end_, new_end);
+                end_ = new_end;
+            }
+            position = begin_ + elems_before;
+            dw_stl::uninitialized_relocate(tmp, tmp + 1, position.cur);
+            return position;
+        }
         value_type value_copy = value_type(dw_stl::forward<Args>(args)...);
         // 如果前半段需要移动的元素少，则在前半段插入
         if (elems_before < (size() / 2))
         { 
             // 在前半段插入
-            emplace_front(front());
+            emplace_front(dw_stl::move(front()));
             auto front1 = begin_;
             ++front1;
             auto front2 = front1;
@@ -1073,26 +1356,26 @@ namespace dw_stl
             position = begin_ + elems_before;
             auto pos = position;
             ++pos;
-            dw_stl::copy(front2, pos, front1);
+            dw_stl::move(front2, pos, front1);
         }
         else
         { 
             // 否则在后半段插入
-            emplace_back(back());
+            emplace_back(dw_stl::move(back()));
             auto back1 = end_;
             --back1;
             auto back2 = back1;
             --back2;
             position = begin_ + elems_before;
-            dw_stl::copy_backward(position, back2, back1);
+            dw_stl::move_backward(position, back2, back1);
         }
         *position = dw_stl::move(value_copy);
         return position;
     }
 
     // fill_insert函数, 在positon处填入n个元素value
-    template <class T>
-    void deque<T>::fill_insert(iterator position, size_type n, const value_type& value)
+    template <class T, class Alloc>
+    void deque<T, Alloc>::fill_insert(iterator position, size_type n, const value_type& value)
     {
         const size_type elems_before = position - begin_;
         const size_type len = size();
@@ -1165,9 +1448,9 @@ namespace dw_stl
     }
 
     // copy_insert, 在位置position处复制其他迭代器的元素
-    template <class T>
+    template <class T, class Alloc>
     template <class ForwardIter>
-    void deque<T>::copy_insert(iterator position, ForwardIter first, ForwardIter last, size_type n)
+    void deque<T, Alloc>::copy_insert(iterator position, ForwardIter first, ForwardIter last, size_type n)
     {
         const size_type elems_before = position - begin_;
         auto len = size();
@@ -1243,34 +1526,52 @@ namespace dw_stl
     }
 
     // insert_dispatch函数
-    template <class T>
+    template <class T, class Alloc>
     template <class InputIter>
-    void deque<T>::insert_dispatch(iterator position, InputIter first, InputIter last, input_iterator_tag)
+    void deque<T, Alloc>::insert_dispatch(iterator position, InputIter first, InputIter last, input_iterator_tag)
     {
-        if (last <= first)  return;
-        const size_type n = dw_stl::distance(first, last);
+        // 输入迭代器只能遍历一次，先逐个插入到离position较近的一端，再旋转到position处
         const size_type elems_before = position - begin_;
-        if (elems_before < (size() / 2))
+        const size_type old_size = size();
+        if (elems_before < old_size / 2)
         {
-            require_capacity(n, true);
+            size_type n = 0;
+            try
+            {
+                for (; first != last; ++first, ++n)
+                    emplace_front(*first);
+            }
+            catch (...)
+            {
+                for (; n > 0; --n)
+                    pop_front();
+                throw;
+            }
+            // 插入到头部的元素顺序相反
+            dw_stl::reverse(begin_, begin_ + n);
+            dw_stl::rotate(begin_, begin_ + n, begin_ + (n + elems_before));
         }
         else
         {
-            require_capacity(n, false);
-        }
-        position = begin_ + elems_before;
-        auto cur = --last;
-        for (size_type i = 0; i < n; ++i, --cur)
-        {
-            insert(position, *cur);
+            try
+            {
+                for (; first != last; ++first)
+                    emplace_back(*first);
+            }
+            catch (...)
+            {
+                erase(begin_ + old_size, end_);
+                throw;
+            }
+            dw_stl::rotate(begin_ + elems_before, begin_ + old_size, end_);
         }
     }
 
-    template <class T>
+    template <class T, class Alloc>
     template <class ForwardIter>
-    void deque<T>::insert_dispatch(iterator position, ForwardIter first, ForwardIter last, forward_iterator_tag)
+    void deque<T, Alloc>::insert_dispatch(iterator position, ForwardIter first, ForwardIter last, forward_iterator_tag)
     {
-        if (last <= first)  return;
+        if (first == last)  return;
         const size_type n = dw_stl::distance(first, last);
         if (position.cur == begin_.cur)
         {
@@ -1294,7 +1595,7 @@ namespace dw_stl
             auto new_end = end_ + n;
             try
             {
-                dw_stl::uninitialized_copy(first, last, end_);
+                copy_to_back(first, n);
                 end_ = new_end;
             }
             catch (...)
@@ -1310,13 +1611,40 @@ namespace dw_stl
         }
     }
 
+    // copy_to_back函数，每一段在缓冲区内是连续的，失败时析构已经构造的元素
+    template <class T, class Alloc>
+    template <class ForwardIter>
+    void deque<T, Alloc>::copy_to_back(ForwardIter first, size_type n)
+    {
+        auto cur = end_;
+        try
+        {
+            while (n > 0)
+            {
+                const size_type len = dw_stl::min(n, static_cast<size_type>(cur.last - cur.cur));
+                auto next = first;
+                dw_stl::advance(next, len);
+                dw_stl::uninitialized_copy(first, next, cur.cur);
+                first = next;
+                cur += len;
+                n -= len;
+            }
+        }
+        catch (...)
+        {
+            destroy_range(end_, cur);
+            throw;
+        }
+    }
+
     // require_capacity函数, 申请额外的内存
-    template <class T>
-    void deque<T>::require_capacity(size_type n, bool front)
+    template <class T, class Alloc>
+    void deque<T, Alloc>::require_capacity(size_type n, bool front)
     {
         if (front && (static_cast<size_type>(begin_.cur - begin_.first) < n))
         {
-            const size_type need_buffer = (n - (begin_.cur - begin_.first)) / buffer_size + 1;
+            // 向上取整，多申请的缓冲区不在使用范围内，之后会被覆盖
+            const size_type need_buffer = (n - (begin_.cur - begin_.first) + buffer_size - 1) / buffer_size;
             if (need_buffer > static_cast<size_type>(begin_.node - map_))
             {
                 reallocate_map_at_front(need_buffer);
@@ -1326,7 +1654,7 @@ namespace dw_stl
         }
         else if (!front && (static_cast<size_type>(end_.last - end_.cur - 1) < n))
         {
-            const size_type need_buffer = (n - (end_.last - end_.cur - 1)) / buffer_size + 1;
+            const size_type need_buffer = (n - (end_.last - end_.cur - 1) + buffer_size - 1) / buffer_size;
             if (need_buffer > static_cast<size_type>((map_ + map_size_) - end_.node - 1))
             {
                 reallocate_map_at_back(need_buffer);
@@ -1336,10 +1664,102 @@ namespace dw_stl
         }
     }
 
+    // relocate_forward函数，从前往后逐段迁移，每一段在源和目标所在的缓冲区内都是连续的
+    template <class T, class Alloc>
+    typename deque<T, Alloc>::iterator
+    deque<T, Alloc>::relocate_forward(iterator first, iterator last, iterator result)
+    {
+        difference_type n = last - first;
+        while (n > 0)
+        {
+            const difference_type len = dw_stl::min(n, dw_stl::min<difference_type>(first.last - first.cur,
+                                                                                     result.last - result.cur));
+            dw_stl::uninitialized_relocate(first.cur, first.cur + len, result.cur);
+            first += len;
+            result += len;
+            n -= len;
+        }
+        return result;
+    }
+
+    // relocate_backward函数，从后往前逐段迁移
+    template <class T, class Alloc>
+    typename deque<T, Alloc>::iterator
+    deque<T, Alloc>::relocate_backward(iterator first, iterator last, iterator result)
+    {
+        difference_type n = last - first;
+        while (n > 0)
+        {
+            // 位于缓冲区头部时，这一段属于前一个缓冲区
+            const difference_type bsize = static_cast<difference_type>(buffer_size);
+            pointer lend = last.cur == last.first ? *(last.node - 1) + bsize : last.cur;
+            pointer rend = result.cur == result.first ? *(result.node - 1) + bsize : result.cur;
+            const difference_type llen = last.cur == last.first ? bsize : last.cur - last.first;
+            const difference_type rlen = result.cur == result.first ? bsize : result.cur - result.first;
+            const difference_type len = dw_stl::min(n, dw_stl::min(llen, rlen));
+            dw_stl::uninitialized_relocate(lend - len, lend, rend - len);
+            last -= len;
+            result -= len;
+            n -= len;
+        }
+        return result;
+    }
+
+    // destroy_range函数，逐个缓冲区析构[first, last)上的元素
+    template <class T, class Alloc>
+    void deque<T, Alloc>::destroy_range(iterator first, iterator last)
+    {
+        while (first.node != last.node)
+        {
+            alloc_traits::destroy(this->alloc(), first.cur, first.last);
+            first.set_node(first.node + 1);
+            first.cur = first.first;
+        }
+        alloc_traits::destroy(this->alloc(), first.cur, last.cur);
+    }
+
+    // recenter_map函数，map 的大小超过需要的两倍时，把使用中的节点移到 map 中间，不重新分配 map
+    // 作为队列使用时节点不断向一端移动，这样 map 不会无限增长
+    template <class T, class Alloc>
+    bool deque<T, Alloc>::recenter_map(size_type need_buffer, bool front)
+    {
+        const size_type old_buffer = end_.node - begin_.node + 1;
+        const size_type new_buffer = old_buffer + need_buffer;
+        if (map_size_ <= 2 * new_buffer)
+            return false;
+        // 使用范围之外残留的缓冲区先放回缓存
+        for (auto cur = map_; cur < begin_.node; ++cur)
+        {
+            if (*cur != nullptr)
+                deallocate_block(*cur);
+        }
+        for (auto cur = end_.node + 1; cur < map_ + map_size_; ++cur)
+        {
+            if (*cur != nullptr)
+                deallocate_block(*cur);
+        }
+        auto begin = map_ + (map_size_ - new_buffer) / 2;
+        auto mid = front ? begin + need_buffer : begin;
+        std::memmove(mid, begin_.node, old_buffer * sizeof(pointer));
+        for (auto cur = map_; cur < mid; ++cur)
+            *cur = nullptr;
+        for (auto cur = mid + old_buffer; cur < map_ + map_size_; ++cur)
+            *cur = nullptr;
+        begin_ = iterator(*mid + (begin_.cur - begin_.first), mid);
+        end_ = iterator(*(mid + old_buffer - 1) + (end_.cur - end_.first), mid + old_buffer - 1);
+        if (front)
+            create_buffer(begin, mid - 1);
+        else
+            create_buffer(mid + old_buffer, mid + new_buffer - 1);
+        return true;
+    }
+
     // reallocate_map_at_front函数，在头部扩充内存
-    template <class T>
-    void deque<T>::reallocate_map_at_front(size_type need_buffer)
+    template <class T, class Alloc>
+    void deque<T, Alloc>::reallocate_map_at_front(size_type need_buffer)
     {
+        if (recenter_map(need_buffer, true))
+            return;
         const size_type new_map_size = dw_stl::max(map_size_ << 1,
                                                     map_size_ + need_buffer + DEQUE_MAP_INIT_SIZE);
         map_pointer new_map = create_map(new_map_size);
@@ -1351,11 +1771,10 @@ namespace dw_stl
         auto mid = begin + need_buffer;
         auto end = mid + old_buffer;
         create_buffer(begin, mid - 1);
-        for (auto begin1 = mid, begin2 = begin_.node; begin1 != end; ++begin1, ++begin2)
-            *begin1 = *begin2;
+        dw_stl::uninitialized_relocate(begin_.node, end_.node + 1, mid);
 
         // 更新数据
-        map_allocator::deallocate(map_, map_size_);
+        deallocate_map(map_, map_size_);
         map_ = new_map;
         map_size_ = new_map_size;
         begin_ = iterator(*mid + (begin_.cur - begin_.first), mid);
@@ -1363,9 +1782,11 @@ namespace dw_stl
     }
 
     // reallocate_map_at_back函数，在尾部扩充内存
-    template <class T>
-    void deque<T>::reallocate_map_at_back(size_type need_buffer)
+    template <class T, class Alloc>
+    void deque<T, Alloc>::reallocate_map_at_back(size_type need_buffer)
     {
+        if (recenter_map(need_buffer, false))
+            return;
         const size_type new_map_size = dw_stl::max(map_size_ << 1,
                                                     map_size_ + need_buffer + DEQUE_MAP_INIT_SIZE);
         map_pointer new_map = create_map(new_map_size);
@@ -1376,12 +1797,11 @@ namespace dw_stl
         auto begin = new_map + ((new_map_size - new_buffer) / 2);
         auto mid = begin + old_buffer;
         auto end = mid + need_buffer;
-        for (auto begin1 = begin, begin2 = begin_.node; begin1 != mid; ++begin1, ++begin2)
-            *begin1 = *begin2;
+        dw_stl::uninitialized_relocate(begin_.node, end_.node + 1, begin);
         create_buffer(mid, end - 1);
 
         // 更新数据
-        map_allocator::deallocate(map_, map_size_);
+        deallocate_map(map_, map_size_);
         map_ = new_map;
         map_size_ = new_map_size;
         begin_ = iterator(*begin + (begin_.cur - begin_.first), begin);
@@ -1389,49 +1809,54 @@ namespace dw_stl
     }
 
     // 重载比较操作符
-    template <class T>
-    bool operator==(const deque<T>& lhs, const deque<T>& rhs)
+    template <class T, class Alloc>
+    bool operator==(const deque<T, Alloc>& lhs, const deque<T, Alloc>& rhs)
     {
         return lhs.size() == rhs.size() && 
             dw_stl::equal(lhs.begin(), lhs.end(), rhs.begin());
     }
 
-    template <class T>
-    bool operator<(const deque<T>& lhs, const deque<T>& rhs)
+    template <class T, class Alloc>
+    bool operator<(const deque<T, Alloc>& lhs, const deque<T, Alloc>& rhs)
     {
         return dw_stl::lexicographical_compare(
             lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
     }
 
-    template <class T>
-    bool operator!=(const deque<T>& lhs, const deque<T>& rhs)
+    template <class T, class Alloc>
+    bool operator!=(const deque<T, Alloc>& lhs, const deque<T, Alloc>& rhs)
     {
         return !(lhs == rhs);
     }
 
-    template <class T>
-    bool operator>(const deque<T>& lhs, const deque<T>& rhs)
+    template <class T, class Alloc>
+    bool operator>(const deque<T, Alloc>& lhs, const deque<T, Alloc>& rhs)
     {
         return rhs < lhs;
     }
 
-    template <class T>
-    bool operator<=(const deque<T>& lhs, const deque<T>& rhs)
+    template <class T, class Alloc>
+    bool operator<=(const deque<T, Alloc>& lhs, const deque<T, Alloc>& rhs)
     {
         return !(rhs < lhs);
     }
 
-    template <class T>
-    bool operator>=(const deque<T>& lhs, const deque<T>& rhs)
+    template <class T, class Alloc>
+    bool operator>=(const deque<T, Alloc>& lhs, const deque<T, Alloc>& rhs)
     {
         return !(lhs < rhs);
     }
 
     // 重载swap函数
-    template <class T>
-    void swap(deque<T>& lhs, deque<T>& rhs)
+    template <class T, class Alloc>
+    void swap(deque<T, Alloc>& lhs, deque<T, Alloc>& rhs)
     {
         lhs.swap(rhs);
     }
+
+    // deque的迭代器指向堆上的map和缓冲区，不指向deque对象本身，分配器可以按字节迁移时deque也可以
+    template <class T, class Alloc>
+    struct is_trivially_relocatable<deque<T, Alloc>> : is_trivially_relocatable<Alloc> {};
 }
-#endif
\ No newline at end of file
+
+#endif
@@ -0,0 +1,597 @@
+#ifndef DW_STL_DYNAMIC_BITSET_H_
+#define DW_STL_DYNAMIC_BITSET_H_
+
+/*
+这个头文件用于实现 dynamic_bitset，代替被放弃的 vector<bool>
+
+每一位只占一个比特，按 64 位的字(block)保存在 vector<uint64_t> 中，第 i 位在第 i / 64 个字的第 i % 64 位：
+    接口与 vector 类似：push_back、pop_back、resize、reserve、operator[] 等，非 const 的 operator[] 返回代理对象 reference
+    最后一个字中超过 size() 的位总是为零，因此 count、any、find_first 等函数不需要再屏蔽多余的位
+    &=、|=、^=、andnot 按字批量计算，定义了 __AVX2__ 时(例如 -mavx2)每次处理 256 位
+    count 使用 popcount 指令(需要 -mpopcnt 或者 -march=native，否则由编译器用查表实现)
+    find_first / find_next 跳过全零的字，用 ctz 指令定位
+    rank(pos) 为 [0, pos) 中 1 的个数，select(k) 为第 k 个(从 0 开始)1 的位置，都要扫描前面的字；
+    需要反复查询时使用 bitset_rank_index，建立索引之后 rank 为 O(1)，select 为 O(log n)
+
+实现了以下内容：
+dynamic_bitset          : 可以增长的位集合
+bitset_rank_index       : dynamic_bitset 的 rank / select 索引，位集合改变之后需要重新建立
+*/
+
+#include <cstdint>
+#include <initializer_list>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define DW_STL_BITSET_AVX2 1
+#endif
+
+#include "vector.h"
+#include "exceptdef.h"
+
+namespace dw_stl
+{
+    namespace bitset_detail
+    {
+        typedef uint64_t block_type;
+
+        inline size_t popcount(block_type x) noexcept
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return static_cast<size_t>(__builtin_popcountll(x));
+#else
+            x = x - ((x >> 1) & 0x5555555555555555ULL);
+            x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+            x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+            return static_cast<size_t>((x * 0x0101010101010101ULL) >> 56);
+#endif
+        }
+
+        // 最低的 1 的位置，x 不能为零
+        inline size_t ctz(block_type x) noexcept
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return static_cast<size_t>(__builtin_ctzll(x));
+#else
+            size_t n = 0;
+            while ((x & 1) == 0)
+            {
+                x >>= 1;
+                ++n;
+            }
+            return n;
+#endif
+        }
+
+        // x 中第 k 个(从 0 开始)1 的位置，k 必须小于 popcount(x)
+        inline size_t select_in_block(block_type x, size_t k) noexcept
+        {
+            for (; k > 0; --k)
+                x &= x - 1;
+            return ctz(x);
+        }
+
+        // [0, n) 个字中 1 的个数，用四个累加器减少依赖
+        inline size_t count_blocks(const block_type* p, size_t n) noexcept
+        {
+            size_t c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+            size_t i = 0;
+            for (; i + 4 <= n; i += 4)
+            {
+                c0 += popcount(p[i]);
+                c1 += popcount(p[i + 1]);
+                c2 += popcount(p[i + 2]);
+                c3 += popcount(p[i + 3]);
+            }
+            for (; i < n; ++i)
+                c0 += popcount(p[i]);
+            return c0 + c1 + c2 + c3;
+        }
+
+        // 按字批量计算 dst = op(dst, src)，定义了 __AVX2__ 时每次处理四个字
+        struct and_op
+        {
+            static block_type apply(block_type a, block_type b) noexcept { return a & b; }
+#ifdef DW_STL_BITSET_AVX2
+            static __m256i apply(__m256i a, __m256i b) noexcept { return _mm256_and_si256(a, b); }
+#endif
+        };
+
+        struct or_op
+        {
+            static block_type apply(block_type a, block_type b) noexcept { return a | b; }
+#ifdef DW_STL_BITSET_AVX2
+            static __m256i apply(__m256i a, __m256i b) noexcept { return _mm256_or_si256(a, b); }
+#endif
+        };
+
+        struct xor_op
+        {
+            static block_type apply(block_type a, block_type b) noexcept { return a ^ b; }
+#ifdef DW_STL_BITSET_AVX2
+            static __m256i apply(__m256i a, __m256i b) noexcept { return _mm256_xor_si256(a, b); }
+#endif
+        };
+
+        // a & ~b
+        struct andnot_op
+        {
+            static block_type apply(block_type a, block_type b) noexcept { return a & ~b; }
+#ifdef DW_STL_BITSET_AVX2
+            static __m256i apply(__m256i a, __m256i b) noexcept { return _mm256_andnot_si256(b, a); }
+#endif
+        };
+
+        template <class Op>
+        void apply_blocks(block_type* dst, const block_type* src, size_t n) noexcept
+        {
+            size_t i = 0;
+#ifdef DW_STL_BITSET_AVX2
+            for (; i + 4 <= n; i += 4)
+            {
+                const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+                const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), Op::apply(a, b));
+            }
+#endif
+            for (; i < n; ++i)
+                dst[i] = Op::apply(dst[i], src[i]);
+        }
+    }
+
+    class dynamic_bitset
+    {
+    public:
+        typedef bitset_detail::block_type   block_type;
+        typedef size_t                      size_type;
+        typedef bool                        value_type;
+        typedef bool                        const_reference;
+
+        static constexpr size_type bits_per_block = 64;
+        static constexpr size_type npos = static_cast<size_type>(-1);
+
+        // 非 const 的 operator[] 返回的代理对象
+        class reference
+        {
+        public:
+            reference(block_type& block, size_type bit) noexcept
+                : block_(&block), mask_(block_type(1) << bit) {}
+
+            reference& operator=(bool value) noexcept
+            {
+                if (value)
+                    *block_ |= mask_;
+                else
+                    *block_ &= ~mask_;
+                return *this;
+            }
+            reference& operator=(const reference& rhs) noexcept
+            { return *this = static_cast<bool>(rhs); }
+
+            operator bool() const noexcept { return (*block_ & mask_) != 0; }
+            bool operator~() const noexcept { return (*block_ & mask_) == 0; }
+
+            reference& flip() noexcept
+            {
+                *block_ ^= mask_;
+                return *this;
+            }
+
+        private:
+            block_type* block_;
+            block_type  mask_;
+        };
+
+    public:
+        // 构造、复制、移动函数
+        dynamic_bitset() noexcept : blocks_(), size_(0) {}
+
+        // n 位全部为 value，全零时直接使用清零的内存
+        explicit dynamic_bitset(size_type n, bool value = false)
+            : blocks_(blocks_for(n), value ? ~block_type(0) : block_type(0)), size_(n)
+        { trim(); }
+
+        dynamic_bitset(std::initializer_list<bool> ilist)
+            : blocks_(), size_(0)
+        {
+            reserve(ilist.size());
+            for (bool b : ilist)
+                push_back(b);
+        }
+
+        dynamic_bitset(const dynamic_bitset&) = default;
+        dynamic_bitset& operator=(const dynamic_bitset&) = default;
+
+        dynamic_bitset(dynamic_bitset&& rhs) noexcept
+            : blocks_(dw_stl::move(rhs.blocks_)), size_(rhs.size_)
+        { rhs.size_ = 0; }
+
+        dynamic_bitset& operator=(dynamic_bitset&& rhs) noexcept
+        {
+            if (this == &rhs)
+                return *this;
+            blocks_ = dw_stl::move(rhs.blocks_);
+            size_ = rhs.size_;
+            rhs.size_ = 0;
+            return *this;
+        }
+
+        // 容量相关操作
+        bool      empty() const noexcept { return size_ == 0; }
+        size_type size() const noexcept { return size_; }
+        size_type capacity() const noexcept { return blocks_.capacity() * bits_per_block; }
+        size_type num_blocks() const noexcept { return blocks_.size(); }
+        size_type max_size() const noexcept { return blocks_.max_size(); }
+
+        void reserve(size_type n) { blocks_.reserve(blocks_for(n)); }
+        void shrink_to_fit() { blocks_.shrink_to_fit(); }
+
+        // 底层的字，最后一个字中超过 size() 的位为零
+        block_type*       data() noexcept { return blocks_.data(); }
+        const block_type* data() const noexcept { return blocks_.data(); }
+
+        // 访问元素
+        bool operator[](size_type pos) const noexcept
+        {
+            DW_STL_DEBUG(pos < size_);
+            return (blocks_[block_index(pos)] >> bit_index(pos)) & 1;
+        }
+        reference operator[](size_type pos) noexcept
+        {
+            DW_STL_DEBUG(pos < size_);
+            return reference(blocks_[block_index(pos)], bit_index(pos));
+        }
+
+        bool test(size_type pos) const
+        {
+            THROW_OUT_OF_RANGE_IF(!(pos < size_), "dynamic_bitset::test() subscript out of range");
+            return (*this)[pos];
+        }
+
+        bool front() const noexcept { return (*this)[0]; }
+        bool back() const noexcept { return (*this)[size_ - 1]; }
+
+        // 修改单个位
+        dynamic_bitset& set(size_type pos, bool value = true) noexcept
+        {
+            (*this)[pos] = value;
+            return *this;
+        }
+        dynamic_bitset& reset(size_type pos) noexcept
+        { return set(pos, false); }
+        dynamic_bitset& flip(size_type pos) noexcept
+        {
+            (*this)[pos].flip();
+            return *this;
+        }
+
+        // 修改全部的位
+        dynamic_bitset& set() noexcept;
+        dynamic_bitset& reset() noexcept;
+        dynamic_bitset& flip() noexcept;
+
+        // 在尾部增加、删除
+        void push_back(bool value)
+        {
+            if (bit_index(size_) == 0)
+                blocks_.push_back(block_type(value));
+            else if (value)
+                blocks_.back() |= block_type(1) << bit_index(size_);
+            ++size_;
+        }
+
+        void pop_back() noexcept
+        {
+            DW_STL_DEBUG(!empty());
+            --size_;
+            if (bit_index(size_) == 0)
+                blocks_.pop_back();
+            else
+                blocks_.back() &= ~(block_type(1) << bit_index(size_));
+        }
+
+        void resize(size_type n, bool value = false);
+        void clear() noexcept
+        {
+            blocks_.clear();
+            size_ = 0;
+        }
+
+        // 按字批量计算，两个位集合的大小必须相同
+        dynamic_bitset& operator&=(const dynamic_bitset& rhs) noexcept
+        { return apply<bitset_detail::and_op>(rhs); }
+        dynamic_bitset& operator|=(const dynamic_bitset& rhs) noexcept
+        { return apply<bitset_detail::or_op>(rhs); }
+        dynamic_bitset& operator^=(const dynamic_bitset& rhs) noexcept
+        { return apply<bitset_detail::xor_op>(rhs); }
+        // *this &= ~rhs，不需要先求出 ~rhs
+        dynamic_bitset& andnot(const dynamic_bitset& rhs) noexcept
+        { return apply<bitset_detail::andnot_op>(rhs); }
+
+        dynamic_bitset operator~() const
+        {
+            dynamic_bitset tmp(*this);
+            tmp.flip();
+            return tmp;
+        }
+
+        // 统计与查找
+        size_type count() const noexcept
+        { return bitset_detail::count_blocks(blocks_.data(), blocks_.size()); }
+        bool any() const noexcept;
+        bool none() const noexcept { return !any(); }
+        bool all() const noexcept;
+
+        // 第一个 1 的位置，没有时返回 npos
+        size_type find_first() const noexcept
+        { return find_from_block(0); }
+        // pos 之后的第一个 1 的位置，没有时返回 npos
+        size_type find_next(size_type pos) const noexcept;
+
+        // [0, pos) 中 1 的个数，pos 可以等于 size()
+        size_type rank(size_type pos) const noexcept;
+        // 第 k 个(从 0 开始)1 的位置，没有时返回 npos
+        size_type select(size_type k) const noexcept;
+
+        void swap(dynamic_bitset& rhs) noexcept
+        {
+            blocks_.swap(rhs.blocks_);
+            dw_stl::swap(size_, rhs.size_);
+        }
+
+        bool operator==(const dynamic_bitset& rhs) const noexcept
+        { return size_ == rhs.size_ && blocks_ == rhs.blocks_; }
+        bool operator!=(const dynamic_bitset& rhs) const noexcept
+        { return !(*this == rhs); }
+
+    private:
+        static size_type block_index(size_type pos) noexcept { return pos / bits_per_block; }
+        static size_type bit_index(size_type pos) noexcept { return pos % bits_per_block; }
+        static size_type blocks_for(size_type n) noexcept
+        { return (n + bits_per_block - 1) / bits_per_block; }
+
+        // 把最后一个字中超过 size() 的位清零
+        void trim() noexcept
+        {
+            if (bit_index(size_) != 0)
+                blocks_.back() &= (block_type(1) << bit_index(size_)) - 1;
+        }
+
+        template <class Op>
+        dynamic_bitset& apply(const dynamic_bitset& rhs) noexcept
+        {
+            DW_STL_DEBUG(size_ == rhs.size_);
+            bitset_detail::apply_blocks<Op>(blocks_.data(), rhs.blocks_.data(), blocks_.size());
+            return *this;
+        }
+
+        size_type find_from_block(size_type first) const noexcept;
+
+    private:
+        vector<block_type> blocks_;    // 保存位的字
+        size_type          size_;      // 位的个数
+    };
+
+    /*****************************************************************************************/
+
+    inline dynamic_bitset& dynamic_bitset::set() noexcept
+    {
+        dw_stl::fill(blocks_.begin(), blocks_.end(), ~block_type(0));
+        trim();
+        return *this;
+    }
+
+    inline dynamic_bitset& dynamic_bitset::reset() noexcept
+    {
+        dw_stl::fill(blocks_.begin(), blocks_.end(), block_type(0));
+        return *this;
+    }
+
+    inline dynamic_bitset& dynamic_bitset::flip() noexcept
+    {
+        for (auto& b : blocks_)
+            b = ~b;
+        trim();
+        return *this;
+    }
+
+    // 改变位的个数，新增的位为 value
+    inline void dynamic_bitset::resize(size_type n, bool value)
+    {
+        const block_type fill = value ? ~block_type(0) : block_type(0);
+        if (n > size_ && value && bit_index(size_) != 0)
+            blocks_.back() |= ~((block_type(1) << bit_index(size_)) - 1);
+        blocks_.resize(blocks_for(n), fill);
+        size_ = n;
+        trim();
+    }
+
+    inline bool dynamic_bitset::any() const noexcept
+    {
+        for (auto b : blocks_)
+        {
+            if (b != 0)
+                return true;
+        }
+        return false;
+    }
+
+    inline bool dynamic_bitset::all() const noexcept
+    {
+        const size_type full = size_ / bits_per_block;
+        for (size_type i = 0; i < full; ++i)
+        {
+            if (blocks_[i] != ~block_type(0))
+                return false;
+        }
+        return bit_index(size_) == 0 ||
+            blocks_.back() == (block_type(1) << bit_index(size_)) - 1;
+    }
+
+    // 从第 first 个字开始查找第一个 1
+    inline dynamic_bitset::size_type dynamic_bitset::find_from_block(size_type first) const noexcept
+    {
+        const size_type n = blocks_.size();
+        for (size_type i = first; i < n; ++i)
+        {
+            if (blocks_[i] != 0)
+                return i * bits_per_block + bitset_detail::ctz(blocks_[i]);
+        }
+        return npos;
+    }
+
+    inline dynamic_bitset::size_type dynamic_bitset::find_next(size_type pos) const noexcept
+    {
+        if (pos == npos || pos + 1 >= size_)
+            return npos;
+        ++pos;
+        const size_type i = block_index(pos);
+        // 屏蔽掉当前字中 pos 之前的位
+        const block_type rest = blocks_[i] & (~block_type(0) << bit_index(pos));
+        if (rest != 0)
+            return i * bits_per_block + bitset_detail::ctz(rest);
+        return find_from_block(i + 1);
+    }
+
+    inline dynamic_bitset::size_type dynamic_bitset::rank(size_type pos) const noexcept
+    {
+        DW_STL_DEBUG(pos <= size_);
+        const size_type i = block_index(pos);
+        size_type result = bitset_detail::count_blocks(blocks_.data(), i);
+        if (bit_index(pos) != 0)
+            result += bitset_detail::popcount(blocks_[i] & ((block_type(1) << bit_index(pos)) - 1));
+        return result;
+    }
+
+    inline dynamic_bitset::size_type dynamic_bitset::select(size_type k) const noexcept
+    {
+        const size_type n = blocks_.size();
+        for (size_type i = 0; i < n; ++i)
+        {
+            const size_type c = bitset_detail::popcount(blocks_[i]);
+            if (k < c)
+                return i * bits_per_block + bitset_detail::select_in_block(blocks_[i], k);
+            k -= c;
+        }
+        return npos;
+    }
+
+    // 重载比较操作符与二元运算
+    inline dynamic_bitset operator&(const dynamic_bitset& lhs, const dynamic_bitset& rhs)
+    {
+        dynamic_bitset tmp(lhs);
+        tmp &= rhs;
+        return tmp;
+    }
+
+    inline dynamic_bitset operator|(const dynamic_bitset& lhs, const dynamic_bitset& rhs)
+    {
+        dynamic_bitset tmp(lhs);
+        tmp |= rhs;
+        return tmp;
+    }
+
+    inline dynamic_bitset operator^(const dynamic_bitset& lhs, const dynamic_bitset& rhs)
+    {
+        dynamic_bitset tmp(lhs);
+        tmp ^= rhs;
+        return tmp;
+    }
+
+    // 重载dw_stl的swap
+    inline void swap(dynamic_bitset& lhs, dynamic_bitset& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+
+    /*****************************************************************************************/
+    // bitset_rank_index
+    // 每 512 位(8 个字)记录一次前面 1 的个数，额外占用的空间为位集合的 1/8
+    /*****************************************************************************************/
+    class bitset_rank_index
+    {
+    public:
+        typedef dynamic_bitset::size_type  size_type;
+        typedef dynamic_bitset::block_type block_type;
+
+        static constexpr size_type blocks_per_super = 8;
+        static constexpr size_type bits_per_super = blocks_per_super * dynamic_bitset::bits_per_block;
+
+        // 引用 bits，bits 改变或者销毁之后索引失效
+        explicit bitset_rank_index(const dynamic_bitset& bits)
+            : bits_(&bits), super_()
+        { rebuild(); }
+
+        // 位集合改变之后重新建立索引
+        void rebuild();
+
+        // [0, pos) 中 1 的个数
+        size_type rank(size_type pos) const noexcept;
+        // 第 k 个(从 0 开始)1 的位置，没有时返回 npos
+        size_type select(size_type k) const noexcept;
+
+        // 1 的总数
+        size_type count() const noexcept { return super_.back(); }
+
+    private:
+        const dynamic_bitset* bits_;
+        vector<size_type>     super_;   // super_[j] 为前 j * 512 位中 1 的个数，最后一项为总数
+    };
+
+    inline void bitset_rank_index::rebuild()
+    {
+        const block_type* p = bits_->data();
+        const size_type n = bits_->num_blocks();
+        super_.clear();
+        super_.reserve(n / blocks_per_super + 2);
+        size_type total = 0;
+        super_.push_back(0);
+        for (size_type i = 0; i < n; i += blocks_per_super)
+        {
+            const size_type len = n - i < blocks_per_super ? n - i : blocks_per_super;
+            total += bitset_detail::count_blocks(p + i, len);
+            super_.push_back(total);
+        }
+    }
+
+    inline bitset_rank_index::size_type bitset_rank_index::rank(size_type pos) const noexcept
+    {
+        DW_STL_DEBUG(pos <= bits_->size());
+        const size_type s = pos / bits_per_super;
+        const size_type first = s * blocks_per_super;
+        const size_type last = pos / dynamic_bitset::bits_per_block;
+        const block_type* p = bits_->data();
+        size_type result = super_[s] + bitset_detail::count_blocks(p + first, last - first);
+        const size_type bit = pos % dynamic_bitset::bits_per_block;
+        if (bit != 0)
+            result += bitset_detail::popcount(p[last] & ((block_type(1) << bit) - 1));
+        return result;
+    }
+
+    inline bitset_rank_index::size_type bitset_rank_index::select(size_type k) const noexcept
+    {
+        if (k >= count())
+            return dynamic_bitset::npos;
+        // 二分查找最后一个 super_[s] <= k 的 s
+        size_type lo = 0, hi = super_.size() - 1;
+        while (hi - lo > 1)
+        {
+            const size_type mid = lo + (hi - lo) / 2;
+            if (super_[mid] <= k)
+                lo = mid;
+            else
+                hi = mid;
+        }
+        k -= super_[lo];
+        const block_type* p = bits_->data();
+        for (size_type i = lo * blocks_per_super; ; ++i)
+        {
+            const size_type c = bitset_detail::popcount(p[i]);
+            if (k < c)
+                return i * dynamic_bitset::bits_per_block + bitset_detail::select_in_block(p[i], k);
+            k -= c;
+        }
+    }
+}
+
+#endif
@@ -91,6 +91,8 @@ namespace dw_stl
             // 如果孩子节点大于父节点，则交换
             if (*(first + lchild) > value)
                 *(first + shiftIdx) = *(first + lchild);
+            else
+                break;
             shiftIdx = lchild;
             lchild = 2 * shiftIdx + 1;
         }
@@ -121,10 +123,12 @@ namespace dw_stl
         while (lchild < len)
         {
             // cmp(lhs, rhs)返回true表示lhs的优先级小于rhs的优先级
-            if (lchild + 1 < len && cmp(*(first + lchild + 1), *(first + lchild)))
+            if (lchild + 1 < len && cmp(*(first + lchild), *(first + lchild + 1)))
                 lchild++;
-            if (value, cmp(*(first + lchild)))
+            if (cmp(value, *(first + lchild)))
                 *(first + shiftIdx) = *(first + lchild);
+            else
+                break;
             shiftIdx = lchild;
             lchild = 2 * shiftIdx + 1;
         }
@@ -167,7 +171,7 @@ namespace dw_stl
     void sort_heap(RandomIter first, RandomIter last, Compare cmp)
     {
         while (last - first > 1)
-            dw_stl::sort_heap(first, last--, cmp);
+            dw_stl::pop_heap(first, last--, cmp);
     }
 
     /*****************************************************************************************/
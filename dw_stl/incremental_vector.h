@@ -0,0 +1,579 @@
+#ifndef DW_STL_INCREMENTAL_VECTOR_H_
+#define DW_STL_INCREMENTAL_VECTOR_H_
+
+/*
+这个头文件用于实现模板类 incremental_vector<T>
+
+vector 扩容时在一次 push_back 中迁移全部 n 个元素，最坏情况下这一次调用是 O(n) 的，
+incremental_vector 扩容时只分配新的空间，旧空间中的元素在之后的每次修改操作中迁移一小批，迁移期间同时保留新旧两块空间：
+    下标 [0, moved_) 的元素已经迁移到新空间，[moved_, old_size_) 的元素还在旧空间中，[old_size_, size()) 的元素是扩容之后追加的，在新空间中
+    每次 push_back/emplace_back/pop_back 迁移 step 个元素，step 至少为 DW_STL_INCREMENTAL_VECTOR_STEP，
+    并且保证新空间填满之前迁移一定完成，因此 push_back 最坏情况下是 O(1) 的(不计分配器本身的耗时)
+    operator[] 在迁移期间多一次比较，仍然是 O(1) 的
+    finish_migration() 立即完成迁移；data() 需要连续的空间，会先完成迁移
+    扩容策略与 vector 相同，使用 vector.h 中的 Growth，默认按 2 倍扩容；growth_exact 不适合这个容器
+
+迭代器保存容器与下标，push_back 扩容以及迁移之后迭代器仍然有效；元素的指针与引用在下一次修改操作之后可能失效
+
+异常保证：
+    dw_stl::incremental_vector<T> 满足基本异常保证，元素的移动构造函数不抛出异常时对以下函数做强异常安全保证：
+        emplace_back
+        push_back
+*/
+
+#include <initializer_list>
+
+#include "vector.h"
+
+namespace dw_stl
+{
+    // 每次修改操作至少迁移的元素个数
+    #ifndef DW_STL_INCREMENTAL_VECTOR_STEP
+    #define DW_STL_INCREMENTAL_VECTOR_STEP 4
+    #endif
+
+    /*****************************************************************************************/
+    // incremental_vector 的迭代器，Owner 为容器类型(const_iterator 为 const 容器)
+    /*****************************************************************************************/
+    template <class Owner, class Ref, class Ptr>
+    struct incremental_vector_iterator
+        : public iterator<random_access_iterator_tag, typename std::remove_const<Owner>::type::value_type>
+    {
+        typedef incremental_vector_iterator                          self;
+        typedef typename std::remove_const<Owner>::type::value_type  value_type;
+        typedef Ptr                                                  pointer;
+        typedef Ref                                                  reference;
+        typedef size_t                                               size_type;
+        typedef ptrdiff_t                                            difference_type;
+
+        Owner*    vec;      // 所属的容器
+        size_type index;    // 元素的下标
+
+        incremental_vector_iterator() noexcept : vec(nullptr), index(0) {}
+        incremental_vector_iterator(Owner* v, size_type i) noexcept : vec(v), index(i) {}
+
+        // iterator 可以转换为 const_iterator
+        template <class O, class R, class P, typename std::enable_if<
+            std::is_convertible<O*, Owner*>::value, int>::type = 0>
+        incremental_vector_iterator(const incremental_vector_iterator<O, R, P>& rhs) noexcept
+            : vec(rhs.vec), index(rhs.index) {}
+
+        reference operator*()  const { return (*vec)[index]; }
+        pointer   operator->() const { return &(*vec)[index]; }
+        reference operator[](difference_type n) const { return (*vec)[index + n]; }
+
+        self& operator++() noexcept { ++index; return *this; }
+        self  operator++(int) noexcept { self tmp = *this; ++index; return tmp; }
+        self& operator--() noexcept { --index; return *this; }
+        self  operator--(int) noexcept { self tmp = *this; --index; return tmp; }
+
+        self& operator+=(difference_type n) noexcept { index += n; return *this; }
+        self& operator-=(difference_type n) noexcept { index -= n; return *this; }
+        self  operator+(difference_type n) const noexcept { return self(vec, index + n); }
+        self  operator-(difference_type n) const noexcept { return self(vec, index - n); }
+
+        difference_type operator-(const self& x) const noexcept
+        { return static_cast<difference_type>(index) - static_cast<difference_type>(x.index); }
+
+        // 重载比较操作符
+        bool operator==(const self& rhs) const noexcept { return index == rhs.index; }
+        bool operator< (const self& rhs) const noexcept { return index < rhs.index; }
+        bool operator!=(const self& rhs) const noexcept { return !(*this == rhs); }
+        bool operator> (const self& rhs) const noexcept { return rhs < *this; }
+        bool operator<=(const self& rhs) const noexcept { return !(rhs < *this); }
+        bool operator>=(const self& rhs) const noexcept { return !(*this < rhs); }
+    };
+
+    // 模板类incremental_vector
+    // 模板参数T代表数据类型，Alloc代表分配器类型，Growth代表扩容策略，默认按2倍扩容
+    template <class T, class Alloc = dw_stl::allocator<T>, class Growth = dw_stl::growth_2x>
+    class incremental_vector : private dw_stl::allocator_holder<Alloc>
+    {
+        static_assert(std::is_same<T, typename Alloc::value_type>::value,
+                      "The value_type of Alloc should be same with T");
+    public:
+        typedef Alloc                                    allocator_type;
+        typedef dw_stl::allocator_traits<Alloc>          alloc_traits;
+
+        typedef T                                        value_type;
+        typedef T*                                       pointer;
+        typedef const T*                                 const_pointer;
+        typedef T&                                       reference;
+        typedef const T&                                 const_reference;
+        typedef typename alloc_traits::size_type         size_type;
+        typedef typename alloc_traits::difference_type   difference_type;
+
+        typedef incremental_vector_iterator<incremental_vector, T&, T*>                   iterator;
+        typedef incremental_vector_iterator<const incremental_vector, const T&, const T*> const_iterator;
+        typedef dw_stl::reverse_iterator<iterator>                                        reverse_iterator;
+        typedef dw_stl::reverse_iterator<const_iterator>                                  const_reverse_iterator;
+
+        allocator_type get_allocator() const { return this->alloc(); }
+
+    private:
+        typedef dw_stl::allocator_holder<Alloc> holder_base;
+
+        pointer   begin_;       // 新空间
+        size_type size_;        // 元素个数
+        size_type cap_;         // 新空间的容量
+        pointer   old_;         // 正在迁移的旧空间，没有迁移时为 nullptr
+        size_type old_cap_;     // 旧空间的容量
+        size_type old_size_;    // 开始迁移时旧空间中的元素个数，pop_back 之后可能减小
+        size_type moved_;       // 已经迁移的元素个数
+        size_type step_;        // 每次修改操作迁移的元素个数
+
+    public:
+        // 构造、复制、移动、析构函数
+        incremental_vector() noexcept
+        { init_empty(); }
+
+        explicit incremental_vector(const allocator_type& alloc) noexcept
+            : holder_base(alloc)
+        { init_empty(); }
+
+        explicit incremental_vector(size_type n, const allocator_type& alloc = allocator_type())
+            : incremental_vector(n, value_type(), alloc) {}
+
+        incremental_vector(size_type n, const value_type& value, const allocator_type& alloc = allocator_type())
+            : holder_base(alloc)
+        {
+            init_empty();
+            init_space(n);
+            try
+            {
+                dw_stl::uninitialized_fill_n(begin_, n, value);
+            }
+            catch (...)
+            {
+                release();
+                throw;
+            }
+            size_ = n;
+        }
+
+        template <class Iter, typename std::enable_if<
+            dw_stl::is_input_iterator<Iter>::value, int>::type = 0>
+        incremental_vector(Iter first, Iter last, const allocator_type& alloc = allocator_type())
+            : holder_base(alloc)
+        {
+            init_empty();
+            try
+            {
+                for (; first != last; ++first)
+                    emplace_back(*first);
+                finish_migration();
+            }
+            catch (...)
+            {
+                release();
+                throw;
+            }
+        }
+
+        incremental_vector(std::initializer_list<value_type> ilist, const allocator_type& alloc = allocator_type())
+            : holder_base(alloc)
+        {
+            init_empty();
+            init_space(ilist.size());
+            try
+            {
+                dw_stl::uninitialized_copy(ilist.begin(), ilist.end(), begin_);
+            }
+            catch (...)
+            {
+                release();
+                throw;
+            }
+            size_ = ilist.size();
+        }
+
+        // 复制时只分配恰好需要的空间，按新旧两块空间中的三段分别复制
+        incremental_vector(const incremental_vector& rhs)
+            : holder_base(alloc_traits::select_on_container_copy_construction(rhs.alloc()))
+        {
+            init_empty();
+            init_space(rhs.size_);
+            copy_from(rhs);
+        }
+
+        incremental_vector(incremental_vector&& rhs) noexcept
+            : holder_base(dw_stl::move(rhs.alloc()))
+        {
+            steal(rhs);
+        }
+
+        // 先按传播规则替换分配器，再用自己的分配器复制元素，空间足够时复用原来的空间
+        incremental_vector& operator=(const incremental_vector& rhs)
+        {
+            if (this != &rhs)
+            {
+                // 分配器会被替换并且不相等时，已有的空间只能由原来的分配器释放
+                if (alloc_traits::propagate_on_container_copy_assignment::value &&
+                    !dw_stl::alloc_equal(this->alloc(), rhs.alloc()))
+                    release();
+                dw_stl::alloc_on_copy(this->alloc(), rhs.alloc());
+                clear();
+                if (cap_ < rhs.size_)
+                {
+                    release();
+                    init_space(rhs.size_);
+                }
+                copy_from(rhs);
+            }
+            return *this;
+        }
+
+        // 分配器传播或者相等时直接接管rhs的空间，否则用自己的分配器分配空间并逐个移动元素
+        incremental_vector& operator=(incremental_vector&& rhs)
+            noexcept(alloc_traits::propagate_on_container_move_assignment::value ||
+                     alloc_traits::is_always_equal::value)
+        {
+            if (this == &rhs)
+                return *this;
+            if (alloc_traits::propagate_on_container_move_assignment::value ||
+                dw_stl::alloc_equal(this->alloc(), rhs.alloc()))
+            {
+                release();
+                dw_stl::alloc_on_move(this->alloc(), rhs.alloc());
+                steal(rhs);
+            }
+            else
+            {
+                clear();
+                reserve(rhs.size_);
+                for (size_type i = 0; i < rhs.size_; ++i)
+                    emplace_back(dw_stl::move(rhs[i]));
+                rhs.clear();
+            }
+            return *this;
+        }
+
+        ~incremental_vector()
+        { release(); }
+
+    public:
+        // 迭代器相关操作
+        iterator begin() noexcept
+        { return iterator(this, 0); }
+        const_iterator begin() const noexcept
+        { return const_iterator(this, 0); }
+        iterator end() noexcept
+        { return iterator(this, size_); }
+        const_iterator end() const noexcept
+        { return const_iterator(this, size_); }
+
+        reverse_iterator rbegin() noexcept
+        { return reverse_iterator(end()); }
+        const_reverse_iterator rbegin() const noexcept
+        { return const_reverse_iterator(end()); }
+        reverse_iterator rend() noexcept
+        { return reverse_iterator(begin()); }
+        const_reverse_iterator rend() const noexcept
+        { return const_reverse_iterator(begin()); }
+
+        const_iterator cbegin() const noexcept
+        { return begin(); }
+        const_iterator cend() const noexcept
+        { return end(); }
+
+        // 容量相关操作
+        bool empty() const noexcept
+        { return size_ == 0; }
+        size_type size() const noexcept
+        { return size_; }
+        size_type max_size() const noexcept
+        { return alloc_traits::max_size(this->alloc()); }
+        size_type capacity() const noexcept
+        { return cap_; }
+
+        // 是否正在迁移
+        bool migrating() const noexcept
+        { return old_ != nullptr; }
+
+        // 立即迁移剩下的元素并释放旧空间
+        void finish_migration()
+        { migrate(old_size_ - moved_); }
+
+        // 容量小于n时分配新的空间，元素在之后的修改操作中逐步迁移
+        void reserve(size_type n)
+        {
+            if (n <= cap_)
+                return;
+            THROW_LENGTH_ERROR_IF(n > max_size(), "n can not larger than max_size() in incremental_vector<T>::reserve(n)");
+            finish_migration();
+            start_migration(n);
+        }
+
+        // 访问元素相关操作
+        reference operator[](size_type n)
+        {
+            DW_STL_DEBUG(n < size_);
+            return in_old(n) ? old_[n] : begin_[n];
+        }
+        const_reference operator[](size_type n) const
+        {
+            DW_STL_DEBUG(n < size_);
+            return in_old(n) ? old_[n] : begin_[n];
+        }
+
+        reference at(size_type n)
+        {
+            THROW_OUT_OF_RANGE_IF(!(n < size()), "incremental_vector<T>::at() subscript out of range");
+            return (*this)[n];
+        }
+        const_reference at(size_type n) const
+        {
+            THROW_OUT_OF_RANGE_IF(!(n < size()), "incremental_vector<T>::at() subscript out of range");
+            return (*this)[n];
+        }
+
+        reference front()
+        { return (*this)[0]; }
+        const_reference front() const
+        { return (*this)[0]; }
+        reference back()
+        { return (*this)[size_ - 1]; }
+        const_reference back() const
+        { return (*this)[size_ - 1]; }
+
+        // 连续的空间，正在迁移时先完成迁移
+        pointer data()
+        {
+            finish_migration();
+            return begin_;
+        }
+
+        // 修改容器相关操作
+        // 新元素总是放在新空间中，先构造新元素再迁移一批，这样参数引用容器中的元素时仍然有效
+        template <class... Args>
+        reference emplace_back(Args&& ...args)
+        {
+            if (size_ == cap_)
+            {
+                finish_migration();
+                start_migration(get_new_cap());
+            }
+            alloc_traits::construct(this->alloc(), begin_ + size_, dw_stl::forward<Args>(args)...);
+            ++size_;
+            migrate(step_);
+            return begin_[size_ - 1];
+        }
+
+        void push_back(const value_type& value)
+        { emplace_back(value); }
+        void push_back(value_type&& value)
+        { emplace_back(dw_stl::move(value)); }
+
+        void pop_back()
+        {
+            DW_STL_DEBUG(!empty());
+            migrate(step_);
+            --size_;
+            if (in_old(size_))
+            {
+                // 删除的元素还在旧空间中，旧空间需要迁移的元素随之减少
+                alloc_traits::destroy(this->alloc(), old_ + size_);
+                old_size_ = size_;
+                if (moved_ == old_size_)
+                    release_old();
+            }
+            else
+                alloc_traits::destroy(this->alloc(), begin_ + size_);
+        }
+
+        void resize(size_type new_size)
+        { resize(new_size, value_type()); }
+        void resize(size_type new_size, const value_type& value)
+        {
+            while (size_ > new_size)
+                pop_back();
+            if (size_ == new_size)
+                return;
+            // value 可能是容器中的元素，迁移之后会失效
+            const value_type value_copy = value;
+            if (new_size > cap_)
+                reserve(new_size);
+            while (size_ < new_size)
+                emplace_back(value_copy);
+        }
+
+        // 析构全部元素，保留新空间
+        void clear() noexcept
+        {
+            destroy_all();
+            release_old();
+            size_ = 0;
+        }
+
+        void swap(incremental_vector& rhs) noexcept
+        {
+            if (this != &rhs)
+            {
+                dw_stl::alloc_on_swap(this->alloc(), rhs.alloc());
+                dw_stl::swap(begin_, rhs.begin_);
+                dw_stl::swap(size_, rhs.size_);
+                dw_stl::swap(cap_, rhs.cap_);
+                dw_stl::swap(old_, rhs.old_);
+                dw_stl::swap(old_cap_, rhs.old_cap_);
+                dw_stl::swap(old_size_, rhs.old_size_);
+                dw_stl::swap(moved_, rhs.moved_);
+                dw_stl::swap(step_, rhs.step_);
+            }
+        }
+
+    private:
+        // 第n个元素是否还在旧空间中
+        bool in_old(size_type n) const noexcept
+        { return n >= moved_ && n < old_size_; }
+
+        void init_empty() noexcept
+        {
+            begin_ = old_ = nullptr;
+            size_ = cap_ = old_cap_ = old_size_ = moved_ = 0;
+            step_ = DW_STL_INCREMENTAL_VECTOR_STEP;
+        }
+
+        void init_space(size_type n)
+        {
+            if (n == 0)
+                return;
+            begin_ = alloc_traits::allocate(this->alloc(), n);
+            cap_ = n;
+        }
+
+        size_type get_new_cap() const
+        {
+            THROW_LENGTH_ERROR_IF(size_ == max_size(), "incremental_vector<T> size too big");
+            return Growth::grow(cap_, size_ + 1, static_cast<size_type>(vector_init_cap<T>::value), max_size());
+        }
+
+        // 分配容量为n的新空间，原来的元素留在旧空间中等待迁移，调用前没有正在进行的迁移
+        void start_migration(size_type n)
+        {
+            pointer tmp = alloc_traits::allocate(this->alloc(), n);
+            old_ = begin_;
+            old_cap_ = cap_;
+            old_size_ = size_;
+            moved_ = 0;
+            begin_ = tmp;
+            cap_ = n;
+            // 保证新空间的剩余容量用完之前迁移完成
+            const size_type room = n - size_;
+            const size_type need = (size_ + room - 1) / room;
+            step_ = need > DW_STL_INCREMENTAL_VECTOR_STEP ? need : DW_STL_INCREMENTAL_VECTOR_STEP;
+            if (old_size_ == 0)
+                release_old();
+        }
+
+        // 迁移最多n个元素，全部迁移之后释放旧空间
+        void migrate(size_type n)
+        {
+            if (!migrating())
+                return;
+            if (n > old_size_ - moved_)
+                n = old_size_ - moved_;
+            dw_stl::uninitialized_relocate(old_ + moved_, old_ + moved_ + n, begin_ + moved_);
+            moved_ += n;
+            if (moved_ == old_size_)
+                release_old();
+        }
+
+        void release_old() noexcept
+        {
+            if (old_ == nullptr)
+                return;
+            alloc_traits::deallocate(this->alloc(), old_, old_cap_);
+            old_ = nullptr;
+            old_cap_ = old_size_ = moved_ = 0;
+        }
+
+        // 析构新旧两块空间中的全部元素
+        void destroy_all() noexcept
+        {
+            if (migrating())
+            {
+                alloc_traits::destroy(this->alloc(), begin_, begin_ + moved_);
+                alloc_traits::destroy(this->alloc(), old_ + moved_, old_ + old_size_);
+                alloc_traits::destroy(this->alloc(), begin_ + old_size_, begin_ + size_);
+            }
+            else
+                alloc_traits::destroy(this->alloc(), begin_, begin_ + size_);
+        }
+
+        void release() noexcept
+        {
+            destroy_all();
+            release_old();
+            if (begin_ != nullptr)
+                alloc_traits::deallocate(this->alloc(), begin_, cap_);
+            init_empty();
+        }
+
+        void steal(incremental_vector& rhs) noexcept
+        {
+            begin_ = rhs.begin_;
+            size_ = rhs.size_;
+            cap_ = rhs.cap_;
+            old_ = rhs.old_;
+            old_cap_ = rhs.old_cap_;
+            old_size_ = rhs.old_size_;
+            moved_ = rhs.moved_;
+            step_ = rhs.step_;
+            rhs.init_empty();
+        }
+
+        // 调用前已经分配了rhs.size()个元素的空间
+        void copy_from(const incremental_vector& rhs)
+        {
+            try
+            {
+                if (rhs.migrating())
+                {
+                    auto cur = dw_stl::uninitialized_copy(rhs.begin_, rhs.begin_ + rhs.moved_, begin_);
+                    size_ = rhs.moved_;
+                    cur = dw_stl::uninitialized_copy(rhs.old_ + rhs.moved_, rhs.old_ + rhs.old_size_, cur);
+                    size_ = rhs.old_size_;
+                    dw_stl::uninitialized_copy(rhs.begin_ + rhs.old_size_, rhs.begin_ + rhs.size_, cur);
+                }
+                else
+                    dw_stl::uninitialized_copy(rhs.begin_, rhs.begin_ + rhs.size_, begin_);
+                size_ = rhs.size_;
+            }
+            catch (...)
+            {
+                release();
+                throw;
+            }
+        }
+    };
+
+    /****************************************************************************/
+    // 重载比较操作符
+    template <class T, class Alloc, class Growth>
+    bool operator==(const incremental_vector<T, Alloc, Growth>& lhs, const incremental_vector<T, Alloc, Growth>& rhs)
+    {
+        return lhs.size() == rhs.size() &&
+            dw_stl::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+
+    template <class T, class Alloc, class Growth>
+    bool operator!=(const incremental_vector<T, Alloc, Growth>& lhs, const incremental_vector<T, Alloc, Growth>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    template <class T, class Alloc, class Growth>
+    bool operator<(const incremental_vector<T, Alloc, Growth>& lhs, const incremental_vector<T, Alloc, Growth>& rhs)
+    {
+        return dw_stl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+
+    // 重载dw_stl的swap
+    template <class T, class Alloc, class Growth>
+    void swap(incremental_vector<T, Alloc, Growth>& lhs, incremental_vector<T, Alloc, Growth>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+}
+
+#endif
@@ -0,0 +1,163 @@
+#ifndef DW_STL_LARGE_ALLOC_H_
+#define DW_STL_LARGE_ALLOC_H_
+
+/*
+这个头文件实现了大块内存的分配，用于非常大的 vector 等容器
+大于等于 DW_STL_LARGE_ALLOC_THRESHOLD 字节的请求直接使用 mmap 向系统申请，并用 madvise(MADV_HUGEPAGE)
+建议内核使用透明大页，减少 TLB 缺失；扩容时使用 mremap 重新映射，内核只修改页表，不需要复制数据
+
+实现了以下函数：
+large_alloc::allocate(bytes)
+large_alloc::allocate_zeroed(bytes)                  // 内容为零，新映射的页面本来就是零，不需要清零
+large_alloc::deallocate(ptr, bytes)
+large_alloc::reallocate(ptr, old_bytes, new_bytes)   // 不支持 mremap 的平台返回 nullptr
+large_alloc::good_size(bytes)                        // 申请 bytes 个字节时实际映射的字节数(按页大小取整)
+定义宏 DW_STL_USE_LARGE_ALLOC 之后，dw_stl::allocator 的大块内存请求会使用这里的函数
+*/
+
+#include <cstddef>
+#include <cstring>
+#include <new>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#define DW_STL_HAS_MREMAP 1
+#endif
+
+namespace dw_stl
+{
+    // 使用 mmap 的最小字节数
+    #ifndef DW_STL_LARGE_ALLOC_THRESHOLD
+    #define DW_STL_LARGE_ALLOC_THRESHOLD (32 * 1024 * 1024)
+    #endif
+
+    class large_alloc
+    {
+    public:
+        static constexpr size_t threshold = DW_STL_LARGE_ALLOC_THRESHOLD;
+
+        // 是否应该由 large_alloc 负责
+        static bool is_large(size_t bytes) noexcept
+        { return bytes >= threshold; }
+
+        static void* allocate(size_t bytes);
+        static void* allocate_zeroed(size_t bytes);
+        static void  deallocate(void* ptr, size_t bytes) noexcept;
+        static void* reallocate(void* ptr, size_t old_bytes, size_t new_bytes) noexcept;
+        static size_t good_size(size_t bytes) noexcept;
+
+    private:
+        static size_t page_size() noexcept;
+        static size_t round_to_page(size_t bytes) noexcept
+        {
+            const size_t page = page_size();
+            return (bytes + page - 1) / page * page;
+        }
+        static void advise_huge_page(void* ptr, size_t bytes) noexcept;
+    };
+
+#if defined(DW_STL_HAS_MREMAP)
+
+    inline size_t large_alloc::page_size() noexcept
+    {
+        static const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+        return page;
+    }
+
+    inline void large_alloc::advise_huge_page(void* ptr, size_t bytes) noexcept
+    {
+    #ifdef MADV_HUGEPAGE
+        // 只是建议，失败(例如内核关闭了透明大页)也不影响使用
+        ::madvise(ptr, bytes, MADV_HUGEPAGE);
+    #else
+        (void)ptr;
+        (void)bytes;
+    #endif
+    }
+
+    // 分配 bytes 个字节，按页大小取整
+    inline void* large_alloc::allocate(size_t bytes)
+    {
+        const size_t len = round_to_page(bytes);
+        void* ptr = ::mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (ptr == MAP_FAILED)
+            throw std::bad_alloc();
+        advise_huge_page(ptr, len);
+        return ptr;
+    }
+
+    // 匿名映射的页面由内核清零，并且第一次访问时才真正分配物理内存
+    inline void* large_alloc::allocate_zeroed(size_t bytes)
+    {
+        return allocate(bytes);
+    }
+
+    inline void large_alloc::deallocate(void* ptr, size_t bytes) noexcept
+    {
+        if (ptr == nullptr)
+            return;
+        ::munmap(ptr, round_to_page(bytes));
+    }
+
+    // 重新映射 ptr 指向的 old_bytes 个字节，原来的内容保留，失败时返回 nullptr 且原来的内存不变
+    inline void* large_alloc::reallocate(void* ptr, size_t old_bytes, size_t new_bytes) noexcept
+    {
+        const size_t old_len = round_to_page(old_bytes);
+        const size_t new_len = round_to_page(new_bytes);
+        if (old_len == new_len)
+            return ptr;
+        void* result = ::mremap(ptr, old_len, new_len, MREMAP_MAYMOVE);
+        if (result == MAP_FAILED)
+            return nullptr;
+        if (new_len > old_len)
+            advise_huge_page(result, new_len);
+        return result;
+    }
+
+    inline size_t large_alloc::good_size(size_t bytes) noexcept
+    {
+        return round_to_page(bytes);
+    }
+
+#else
+
+    // 没有 mmap/mremap 的平台退化为 ::operator new，并且不支持原地扩容
+    inline size_t large_alloc::page_size() noexcept
+    {
+        return 4096;
+    }
+
+    inline void large_alloc::advise_huge_page(void*, size_t) noexcept {}
+
+    inline void* large_alloc::allocate(size_t bytes)
+    {
+        return ::operator new(bytes);
+    }
+
+    inline void* large_alloc::allocate_zeroed(size_t bytes)
+    {
+        void* ptr = ::operator new(bytes);
+        std::memset(ptr, 0, bytes);
+        return ptr;
+    }
+
+    inline void large_alloc::deallocate(void* ptr, size_t) noexcept
+    {
+        ::operator delete(ptr);
+    }
+
+    inline void* large_alloc::reallocate(void*, size_t, size_t) noexcept
+    {
+        return nullptr;
+    }
+
+    inline size_t large_alloc::good_size(size_t bytes) noexcept
+    {
+        return bytes;
+    }
+
+#endif
+}
+
+#endif
@@ -0,0 +1,155 @@
+#ifndef DW_STL_MALLOC_ALLOC_H_
+#define DW_STL_MALLOC_ALLOC_H_
+
+/*
+这个头文件实现了类似 SGI STL 第一级配置器的分配器，直接使用 malloc / realloc / free
+realloc 可以在原来的内存块后面原地扩充，大块内存还会由 C 库使用 mremap 重新映射，
+因此元素可以平凡复制的 vector 使用它扩容时不需要自己复制元素，也不会同时占用新旧两块内存
+
+实现了以下内容：
+malloc_alloc            : 按字节分配、释放、重新分配
+malloc_allocator<T>     : 使用 malloc_alloc 的分配器，提供 reallocate，可以作为容器的 Alloc 模板参数
+                          以及 allocate_at_least(用 malloc_usable_size 得到 malloc 实际分配的大小)
+                          和 allocate_zeroed(使用 calloc，大块内存由 C 库直接映射新的页面，不需要清零)
+*/
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#if defined(__GLIBC__) || defined(__linux__)
+#include <malloc.h>
+#define DW_STL_HAS_MALLOC_USABLE_SIZE 1
+#endif
+
+#include "util.h"
+
+namespace dw_stl
+{
+    class malloc_alloc
+    {
+    public:
+        // malloc 只保证这个对齐字节数
+        static constexpr size_t align = alignof(std::max_align_t);
+
+        static void* allocate(size_t bytes)
+        {
+            void* result = std::malloc(bytes == 0 ? 1 : bytes);
+            if (result == nullptr)
+                throw std::bad_alloc();
+            return result;
+        }
+
+        // 分配 count * size 个字节并清零，乘积溢出时抛出 bad_alloc
+        static void* allocate_zeroed(size_t count, size_t size)
+        {
+            void* result = std::calloc(count == 0 ? 1 : count, size == 0 ? 1 : size);
+            if (result == nullptr)
+                throw std::bad_alloc();
+            return result;
+        }
+
+        static void deallocate(void* ptr) noexcept
+        {
+            std::free(ptr);
+        }
+
+        // ptr 实际可以使用的字节数，不小于申请的 bytes
+        static size_t usable_size(void* ptr, size_t bytes) noexcept
+        {
+#ifdef DW_STL_HAS_MALLOC_USABLE_SIZE
+            const size_t usable = ::malloc_usable_size(ptr);
+            return usable > bytes ? usable : bytes;
+#else
+            (void)ptr;
+            return bytes;
+#endif
+        }
+
+        // 失败时返回 nullptr，原来的内存不变
+        static void* reallocate(void* ptr, size_t new_bytes) noexcept
+        {
+            return std::realloc(ptr, new_bytes == 0 ? 1 : new_bytes);
+        }
+    };
+
+    /*****************************************************************************************/
+    // 模板类 malloc_allocator
+    /*****************************************************************************************/
+    template <class T>
+    class malloc_allocator
+    {
+        static_assert(alignof(T) <= malloc_alloc::align,
+                      "malloc_allocator can not be used for over-aligned types, use aligned_allocator instead");
+
+    public:
+        typedef T           value_type;
+        typedef T*          pointer;
+        typedef const T*    const_pointer;
+        typedef size_t      size_type;
+        typedef ptrdiff_t   difference_type;
+
+        typedef std::true_type  propagate_on_container_move_assignment;
+        typedef std::true_type  is_always_equal;
+
+        template <class U>
+        struct rebind
+        {
+            typedef malloc_allocator<U> other;
+        };
+
+        malloc_allocator() noexcept = default;
+        template <class U>
+        malloc_allocator(const malloc_allocator<U>&) noexcept {}
+
+        static T* allocate(size_type n)
+        {
+            if (n == 0)
+                return nullptr;
+            return static_cast<T*>(malloc_alloc::allocate(n * sizeof(T)));
+        }
+
+        static T* allocate_zeroed(size_type n)
+        {
+            if (n == 0)
+                return nullptr;
+            return static_cast<T*>(malloc_alloc::allocate_zeroed(n, sizeof(T)));
+        }
+
+        static void deallocate(T* ptr, size_type)
+        {
+            malloc_alloc::deallocate(ptr);
+        }
+
+        // 分配至少n个单元，n改为malloc实际分配的空间可以放下的单元数
+        static T* allocate_at_least(size_type& n)
+        {
+            T* ptr = allocate(n);
+            if (ptr != nullptr)
+                n = malloc_alloc::usable_size(ptr, n * sizeof(T)) / sizeof(T);
+            return ptr;
+        }
+
+        // 将ptr指向的内存改为new_n个单元，内容按字节保留，只适用于可平凡复制的类型
+        static T* reallocate(T* ptr, size_type, size_type new_n)
+        {
+            if (ptr == nullptr || new_n == 0)
+                return nullptr;
+            return static_cast<T*>(malloc_alloc::reallocate(ptr, new_n * sizeof(T)));
+        }
+    };
+
+    template <class T, class U>
+    bool operator==(const malloc_allocator<T>&, const malloc_allocator<U>&) noexcept
+    {
+        return true;
+    }
+
+    template <class T, class U>
+    bool operator!=(const malloc_allocator<T>&, const malloc_allocator<U>&) noexcept
+    {
+        return false;
+    }
+}
+
+#endif
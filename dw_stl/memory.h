@@ -2,15 +2,27 @@
 #define DW_STL_MEMORY_H_
 
 // 这个头文件负责更高级的动态内存管理
-// 包含一些基本函数、空间配置器，以及一个模板类 auto_ptr
+// 包含一些基本函数、空间配置器，临时缓冲区，以及智能指针：
+// get_temporary_buffer / temporary_buffer : 从当前线程的 scratch_arena 中分配，反复使用时不再调用系统的分配函数
+// auto_ptr                              : 已经过时，保留用于兼容
+// unique_ptr<T, D> / unique_ptr<T[], D> : 独占所有权，空删除器不占用空间(空基类优化)
+// shared_ptr<T> / weak_ptr<T>           : 共享所有权，引用计数是原子操作
+// local_shared_ptr<T> / local_weak_ptr<T> : 引用计数不是原子操作，只能在一个线程中使用
+// make_unique, make_shared, allocate_shared, make_local_shared, allocate_local_shared
+// make_shared 把对象和控制块放在同一次分配中
 
 #include <cstddef>
 #include <cstdlib>
 #include <climits>
+#include <atomic>
+#include <exception>
 
 #include "algorithm.h"
 #include "allocator.h"
+#include "allocator_traits.h"
 #include "construct.h"
+#include "exceptdef.h"
+#include "scratch_arena.h"
 #include "uninitialized.h"
 
 namespace dw_stl
@@ -23,16 +35,17 @@ namespace dw_stl
         return &value;
     }
 
-    // 获取临时缓冲区
+    // 获取临时缓冲区，从当前线程的 scratch_arena 中分配
     template <class T>
     pair<T*, ptrdiff_t> get_buffer_helper(ptrdiff_t len, T*)
     {
         // 如果超过了整数最大范围
         if (len > static_cast<ptrdiff_t>(INT_MAX / sizeof(T)))
             len = INT_MAX / sizeof(T);
+        scratch_arena& arena = scratch_arena::local();
         while (len > 0)
         {
-            T* tmp = static_cast<T*>(malloc(static_cast<size_t>(len) * sizeof(T)));
+            T* tmp = static_cast<T*>(arena.allocate(static_cast<size_t>(len) * sizeof(T), alignof(T)));
             if (tmp)
                 return pair<T*, ptrdiff_t>(tmp, len);
             // 如果申请失败，将len减少一半重新申请
@@ -48,11 +61,11 @@ namespace dw_stl
         return get_buffer_helper(len, static_cast<T*>(0));
     }
 
-    // 释放临时缓冲区
+    // 释放临时缓冲区，必须在申请它的线程中释放
     template <class T>
     void release_temporary_buffer(T* ptr)
     {
-        free(ptr);
+        scratch_arena::local().deallocate(ptr, alignof(T));
     }
 
     /***************************************************************/
@@ -72,7 +85,7 @@ namespace dw_stl
         ~temporary_buffer()
         {
             dw_stl::destroy(buffer, buffer + len);
-            free(buffer);
+            dw_stl::release_temporary_buffer(buffer);
         }
 
         ptrdiff_t size() const noexcept { return len; }
@@ -99,6 +112,7 @@ namespace dw_stl
     // 构造函数
     template <class ForwardIterator, class T>
     temporary_buffer<ForwardIterator, T>::temporary_buffer(ForwardIterator first, ForwardIterator last)
+        : original_len(0), len(0), buffer(nullptr)
     {
         try 
         {
@@ -111,7 +125,7 @@ namespace dw_stl
         }
         catch (...)
         {
-            free(buffer);
+            dw_stl::release_temporary_buffer(buffer);
             buffer = nullptr;
             len = 0;
         }
@@ -122,16 +136,9 @@ namespace dw_stl
     void temporary_buffer<ForwardIterator, T>::allocate_buffer()
     {
         original_len = len;
-        if (len > static_cast<ptrdiff_t>(INT_MAX / sizeof(T)))
-            len = INT_MAX / sizeof(T);
-        while (len > 0)
-        {
-            buffer = static_cast<T*>(malloc(len * sizeof(T)));
-            if (buffer)
-                break;
-            // 申请失败时减少空间大小
-            len /= 2;
-        }
+        auto result = dw_stl::get_temporary_buffer<T>(len);
+        buffer = result.first;
+        len = result.second;
     }
 
     /*************************************************************************/
@@ -163,9 +170,9 @@ namespace dw_stl
         }
 
         template <class U>
-        auto_ptr& operator=(auto_ptr<T>& rhs)
+        auto_ptr& operator=(auto_ptr<U>& rhs)
         {
-            if (this->get != rhs.get())
+            if (this->get() != rhs.get())
             {
                 delete m_ptr;
                 m_ptr = rhs.release();
@@ -212,6 +219,895 @@ namespace dw_stl
         }
     }; // class auto_ptr
 
+    /*************************************************************************/
+    // 删除器 default_delete
+    template <class T>
+    struct default_delete
+    {
+        constexpr default_delete() noexcept = default;
+
+        template <class U, class = typename std::enable_if<std::is_convertible<U*, T*>::value>::type>
+        default_delete(const default_delete<U>&) noexcept {}
+
+        void operator()(T* ptr) const
+        {
+            static_assert(sizeof(T) > 0, "can not delete an incomplete type");
+            delete ptr;
+        }
+    };
+
+    template <class T>
+    struct default_delete<T[]>
+    {
+        constexpr default_delete() noexcept = default;
+
+        void operator()(T* ptr) const
+        {
+            static_assert(sizeof(T) > 0, "can not delete an incomplete type");
+            delete[] ptr;
+        }
+    };
+
+    namespace ptr_detail
+    {
+        // 保存删除器，空删除器不占用空间，与 allocator_holder 相同
+        template <class D, bool = std::is_empty<D>::value && !__is_final(D)>
+        class deleter_holder : private D
+        {
+        public:
+            deleter_holder() = default;
+            template <class E>
+            explicit deleter_holder(E&& d) : D(dw_stl::forward<E>(d)) {}
+
+            D&       deleter() noexcept       { return *this; }
+            const D& deleter() const noexcept { return *this; }
+        };
+
+        template <class D>
+        class deleter_holder<D, false>
+        {
+        private:
+            D deleter_;
+
+        public:
+            deleter_holder() = default;
+            template <class E>
+            explicit deleter_holder(E&& d) : deleter_(dw_stl::forward<E>(d)) {}
+
+            D&       deleter() noexcept       { return deleter_; }
+            const D& deleter() const noexcept { return deleter_; }
+        };
+    }
+
+    /*************************************************************************/
+    // unique_ptr 模板类
+    // 独占所有权的智能指针，只能移动不能复制，D 为空类型时大小与裸指针相同
+    template <class T, class D = default_delete<T>>
+    class unique_ptr : private ptr_detail::deleter_holder<D>
+    {
+        typedef ptr_detail::deleter_holder<D> holder_base;
+
+        template <class, class> friend class unique_ptr;
+
+    public:
+        typedef T*  pointer;
+        typedef T   element_type;
+        typedef D   deleter_type;
+
+    private:
+        pointer ptr_;
+
+    public:
+        constexpr unique_ptr() noexcept : holder_base(), ptr_(nullptr) {}
+        constexpr unique_ptr(std::nullptr_t) noexcept : holder_base(), ptr_(nullptr) {}
+        explicit unique_ptr(pointer p) noexcept : holder_base(), ptr_(p) {}
+        unique_ptr(pointer p, const D& d) noexcept : holder_base(d), ptr_(p) {}
+        unique_ptr(pointer p, D&& d) noexcept : holder_base(dw_stl::move(d)), ptr_(p) {}
+
+        unique_ptr(unique_ptr&& rhs) noexcept
+            : holder_base(dw_stl::forward<D>(rhs.get_deleter())), ptr_(rhs.release())
+        {
+        }
+
+        template <class U, class E, class = typename std::enable_if<
+            std::is_convertible<U*, T*>::value && !std::is_array<U>::value &&
+            std::is_convertible<E, D>::value>::type>
+        unique_ptr(unique_ptr<U, E>&& rhs) noexcept
+            : holder_base(dw_stl::forward<E>(rhs.get_deleter())), ptr_(rhs.release())
+        {
+        }
+
+        unique_ptr(const unique_ptr&) = delete;
+        unique_ptr& operator=(const unique_ptr&) = delete;
+
+        ~unique_ptr()
+        {
+            if (ptr_ != nullptr)
+                get_deleter()(ptr_);
+        }
+
+        unique_ptr& operator=(unique_ptr&& rhs) noexcept
+        {
+            reset(rhs.release());
+            get_deleter() = dw_stl::forward<D>(rhs.get_deleter());
+            return *this;
+        }
+
+        template <class U, class E>
+        unique_ptr& operator=(unique_ptr<U, E>&& rhs) noexcept
+        {
+            reset(rhs.release());
+            get_deleter() = dw_stl::forward<E>(rhs.get_deleter());
+            return *this;
+        }
+
+        unique_ptr& operator=(std::nullptr_t) noexcept
+        {
+            reset();
+            return *this;
+        }
+
+        typename std::add_lvalue_reference<T>::type operator*() const
+        {
+            DW_STL_DEBUG(ptr_ != nullptr);
+            return *ptr_;
+        }
+        pointer operator->() const noexcept { return ptr_; }
+
+        pointer get() const noexcept { return ptr_; }
+        D&       get_deleter() noexcept       { return this->deleter(); }
+        const D& get_deleter() const noexcept { return this->deleter(); }
+        explicit operator bool() const noexcept { return ptr_ != nullptr; }
+
+        // 放弃所有权，返回原来的指针
+        pointer release() noexcept
+        {
+            pointer tmp = ptr_;
+            ptr_ = nullptr;
+            return tmp;
+        }
+
+        // 先修改指针再删除原来的对象，删除器中访问 *this 时看到的是新的指针
+        void reset(pointer p = pointer()) noexcept
+        {
+            pointer old = ptr_;
+            ptr_ = p;
+            if (old != nullptr)
+                get_deleter()(old);
+        }
+
+        void swap(unique_ptr& rhs) noexcept
+        {
+            dw_stl::swap(ptr_, rhs.ptr_);
+            dw_stl::swap(get_deleter(), rhs.get_deleter());
+        }
+    };
+
+    // 数组版本，使用 delete[] 释放，提供 operator[]
+    template <class T, class D>
+    class unique_ptr<T[], D> : private ptr_detail::deleter_holder<D>
+    {
+        typedef ptr_detail::deleter_holder<D> holder_base;
+
+    public:
+        typedef T*  pointer;
+        typedef T   element_type;
+        typedef D   deleter_type;
+
+    private:
+        pointer ptr_;
+
+    public:
+        constexpr unique_ptr() noexcept : holder_base(), ptr_(nullptr) {}
+        constexpr unique_ptr(std::nullptr_t) noexcept : holder_base(), ptr_(nullptr) {}
+        explicit unique_ptr(pointer p) noexcept : holder_base(), ptr_(p) {}
+        unique_ptr(pointer p, const D& d) noexcept : holder_base(d), ptr_(p) {}
+        unique_ptr(pointer p, D&& d) noexcept : holder_base(dw_stl::move(d)), ptr_(p) {}
+
+        unique_ptr(unique_ptr&& rhs) noexcept
+            : holder_base(dw_stl::forward<D>(rhs.get_deleter())), ptr_(rhs.release())
+        {
+        }
+
+        unique_ptr(const unique_ptr&) = delete;
+        unique_ptr& operator=(const unique_ptr&) = delete;
+
+        ~unique_ptr()
+        {
+            if (ptr_ != nullptr)
+                get_deleter()(ptr_);
+        }
+
+        unique_ptr& operator=(unique_ptr&& rhs) noexcept
+        {
+            reset(rhs.release());
+            get_deleter() = dw_stl::forward<D>(rhs.get_deleter());
+            return *this;
+        }
+
+        unique_ptr& operator=(std::nullptr_t) noexcept
+        {
+            reset();
+            return *this;
+        }
+
+        T& operator[](size_t i) const
+        {
+            DW_STL_DEBUG(ptr_ != nullptr);
+            return ptr_[i];
+        }
+
+        pointer get() const noexcept { return ptr_; }
+        D&       get_deleter() noexcept       { return this->deleter(); }
+        const D& get_deleter() const noexcept { return this->deleter(); }
+        explicit operator bool() const noexcept { return ptr_ != nullptr; }
+
+        pointer release() noexcept
+        {
+            pointer tmp = ptr_;
+            ptr_ = nullptr;
+            return tmp;
+        }
+
+        void reset(pointer p = pointer()) noexcept
+        {
+            pointer old = ptr_;
+            ptr_ = p;
+            if (old != nullptr)
+                get_deleter()(old);
+        }
+
+        void swap(unique_ptr& rhs) noexcept
+        {
+            dw_stl::swap(ptr_, rhs.ptr_);
+            dw_stl::swap(get_deleter(), rhs.get_deleter());
+        }
+    };
+
+    // make_unique 函数
+    template <class T, class... Args>
+    typename std::enable_if<!std::is_array<T>::value, unique_ptr<T>>::type
+    make_unique(Args&& ...args)
+    {
+        return unique_ptr<T>(new T(dw_stl::forward<Args>(args)...));
+    }
+
+    // 数组版本，n 个元素都进行值初始化
+    template <class T>
+    typename std::enable_if<std::is_array<T>::value && std::extent<T>::value == 0, unique_ptr<T>>::type
+    make_unique(size_t n)
+    {
+        typedef typename std::remove_extent<T>::type elem_type;
+        return unique_ptr<T>(new elem_type[n]());
+    }
+
+    template <class T1, class D1, class T2, class D2>
+    bool operator==(const unique_ptr<T1, D1>& lhs, const unique_ptr<T2, D2>& rhs)
+    {
+        return lhs.get() == rhs.get();
+    }
+
+    template <class T1, class D1, class T2, class D2>
+    bool operator!=(const unique_ptr<T1, D1>& lhs, const unique_ptr<T2, D2>& rhs)
+    {
+        return lhs.get() != rhs.get();
+    }
+
+    template <class T1, class D1, class T2, class D2>
+    bool operator<(const unique_ptr<T1, D1>& lhs, const unique_ptr<T2, D2>& rhs)
+    {
+        return lhs.get() < rhs.get();
+    }
+
+    template <class T, class D>
+    bool operator==(const unique_ptr<T, D>& lhs, std::nullptr_t) noexcept { return !lhs; }
+    template <class T, class D>
+    bool operator==(std::nullptr_t, const unique_ptr<T, D>& rhs) noexcept { return !rhs; }
+    template <class T, class D>
+    bool operator!=(const unique_ptr<T, D>& lhs, std::nullptr_t) noexcept { return static_cast<bool>(lhs); }
+    template <class T, class D>
+    bool operator!=(std::nullptr_t, const unique_ptr<T, D>& rhs) noexcept { return static_cast<bool>(rhs); }
+
+    template <class T, class D>
+    void swap(unique_ptr<T, D>& lhs, unique_ptr<T, D>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+
+    // unique_ptr 只保存一个指针，删除器可以按字节迁移时 unique_ptr 也可以
+    template <class T, class D>
+    struct is_trivially_relocatable<unique_ptr<T, D>> : is_trivially_relocatable<D> {};
+
+    /*************************************************************************/
+    // shared_ptr / weak_ptr / local_shared_ptr / local_weak_ptr
+    // 对象和控制块分开保存：ptr_ 指向对象，cb_ 指向控制块，控制块中有两个计数
+    //     use_count  : shared_ptr 的数目，变为 0 时析构对象
+    //     weak_count : weak_ptr 的数目，所有 shared_ptr 共同持有 1，变为 0 时释放控制块
+    // 两种计数策略：atomic_count 用于 shared_ptr，local_count 用于 local_shared_ptr
+
+    // weak_ptr 已经失效时，用它构造 shared_ptr 会抛出这个异常
+    class bad_weak_ptr : public std::exception
+    {
+    public:
+        const char* what() const noexcept override { return "dw_stl::bad_weak_ptr"; }
+    };
+
+    namespace ptr_detail
+    {
+        // 原子引用计数
+        struct atomic_count
+        {
+            typedef std::atomic<long> type;
+
+            static void increment(type& c) noexcept
+            { c.fetch_add(1, std::memory_order_relaxed); }
+
+            // 返回减少之后的值，acq_rel 保证析构对象之前能看到其他线程对它的全部修改
+            static long decrement(type& c) noexcept
+            { return c.fetch_sub(1, std::memory_order_acq_rel) - 1; }
+
+            // 计数不为 0 时加 1，用于 weak_ptr::lock
+            static bool increment_if_not_zero(type& c) noexcept
+            {
+                long n = c.load(std::memory_order_relaxed);
+                while (n != 0)
+                {
+                    if (c.compare_exchange_weak(n, n + 1, std::memory_order_acq_rel, std::memory_order_relaxed))
+                        return true;
+                }
+                return false;
+            }
+
+            static long load(const type& c) noexcept
+            { return c.load(std::memory_order_relaxed); }
+        };
+
+        // 普通引用计数，只能在一个线程中使用
+        struct local_count
+        {
+            typedef long type;
+
+            static void increment(type& c) noexcept { ++c; }
+            static long decrement(type& c) noexcept { return --c; }
+            static bool increment_if_not_zero(type& c) noexcept
+            {
+                if (c == 0)
+                    return false;
+                ++c;
+                return true;
+            }
+            static long load(const type& c) noexcept { return c; }
+        };
+
+        // 控制块的基类
+        template <class Count>
+        class sp_counted_base
+        {
+        public:
+            sp_counted_base() noexcept : use_count_(1), weak_count_(1) {}
+            virtual ~sp_counted_base() = default;
+
+            sp_counted_base(const sp_counted_base&) = delete;
+            sp_counted_base& operator=(const sp_counted_base&) = delete;
+
+            // 析构管理的对象
+            virtual void dispose() noexcept = 0;
+            // 释放控制块本身
+            virtual void destroy() noexcept { delete this; }
+
+            void add_ref() noexcept { Count::increment(use_count_); }
+            bool add_ref_lock() noexcept { return Count::increment_if_not_zero(use_count_); }
+
+            void release() noexcept
+            {
+                if (Count::decrement(use_count_) == 0)
+                {
+                    dispose();
+                    weak_release();
+                }
+            }
+
+            void weak_add_ref() noexcept { Count::increment(weak_count_); }
+            void weak_release() noexcept
+            {
+                if (Count::decrement(weak_count_) == 0)
+                    destroy();
+            }
+
+            long use_count() const noexcept { return Count::load(use_count_); }
+
+        private:
+            typename Count::type use_count_;
+            typename Count::type weak_count_;
+        };
+
+        // 控制块：使用 delete 释放对象
+        template <class P, class Count>
+        class sp_counted_ptr : public sp_counted_base<Count>
+        {
+        public:
+            explicit sp_counted_ptr(P* p) noexcept : ptr_(p) {}
+            void dispose() noexcept override { delete ptr_; }
+
+        private:
+            P* ptr_;
+        };
+
+        // 控制块：使用删除器释放对象
+        template <class P, class D, class Count>
+        class sp_counted_deleter : public sp_counted_base<Count>, private deleter_holder<D>
+        {
+        public:
+            sp_counted_deleter(P* p, D d) : deleter_holder<D>(dw_stl::move(d)), ptr_(p) {}
+            void dispose() noexcept override { this->deleter()(ptr_); }
+
+        private:
+            P* ptr_;
+        };
+
+        // 控制块：对象保存在控制块内部，make_shared / allocate_shared 只需要一次分配
+        template <class T, class Alloc, class Count>
+        class sp_counted_inplace : public sp_counted_base<Count>, private allocator_holder<Alloc>
+        {
+            typedef typename allocator_traits<Alloc>::template rebind_alloc<sp_counted_inplace> block_alloc;
+            typedef allocator_traits<block_alloc>                                                block_traits;
+            typedef typename allocator_traits<Alloc>::template rebind_alloc<T>                   value_alloc;
+            typedef allocator_traits<value_alloc>                                                value_traits;
+
+        public:
+            template <class... Args>
+            explicit sp_counted_inplace(const Alloc& a, Args&& ...args)
+                : allocator_holder<Alloc>(a)
+            {
+                value_alloc va(this->alloc());
+                value_traits::construct(va, ptr(), dw_stl::forward<Args>(args)...);
+            }
+
+            T* ptr() noexcept { return reinterpret_cast<T*>(&storage_); }
+
+            void dispose() noexcept override
+            {
+                value_alloc va(this->alloc());
+                value_traits::destroy(va, ptr());
+            }
+
+            // 用保存的分配器释放控制块自己
+            void destroy() noexcept override
+            {
+                block_alloc ba(this->alloc());
+                this->~sp_counted_inplace();
+                block_traits::deallocate(ba, this, 1);
+            }
+
+            // 分配控制块并在其中构造对象
+            template <class... Args>
+            static sp_counted_inplace* create(const Alloc& a, Args&& ...args)
+            {
+                block_alloc ba(a);
+                sp_counted_inplace* mem = block_traits::allocate(ba, 1);
+                try
+                {
+                    ::new (static_cast<void*>(mem)) sp_counted_inplace(a, dw_stl::forward<Args>(args)...);
+                }
+                catch (...)
+                {
+                    block_traits::deallocate(ba, mem, 1);
+                    throw;
+                }
+                return mem;
+            }
+
+        private:
+            typename std::aligned_storage<sizeof(T), alignof(T)>::type storage_;
+        };
+
+        // 内部使用的构造标记：直接接管已经创建好的控制块
+        struct sp_adopt_tag {};
+    }
+
+    template <class T, class Count> class basic_weak_ptr;
+
+    /*************************************************************************/
+    // basic_shared_ptr 模板类，Count 决定引用计数是否是原子操作
+    template <class T, class Count>
+    class basic_shared_ptr
+    {
+        template <class, class> friend class basic_shared_ptr;
+        template <class, class> friend class basic_weak_ptr;
+
+        typedef ptr_detail::sp_counted_base<Count> control_block;
+
+    public:
+        typedef T                               element_type;
+        typedef basic_weak_ptr<T, Count>        weak_type;
+
+    private:
+        T*             ptr_;
+        control_block* cb_;
+
+    public:
+        constexpr basic_shared_ptr() noexcept : ptr_(nullptr), cb_(nullptr) {}
+        constexpr basic_shared_ptr(std::nullptr_t) noexcept : ptr_(nullptr), cb_(nullptr) {}
+
+        // 接管 p，创建控制块失败时删除 p
+        template <class U>
+        explicit basic_shared_ptr(U* p) : ptr_(p), cb_(nullptr)
+        {
+            try
+            {
+                cb_ = new ptr_detail::sp_counted_ptr<U, Count>(p);
+            }
+            catch (...)
+            {
+                delete p;
+                throw;
+            }
+        }
+
+        template <class U, class D>
+        basic_shared_ptr(U* p, D d) : ptr_(p), cb_(nullptr)
+        {
+            try
+            {
+                cb_ = new ptr_detail::sp_counted_deleter<U, D, Count>(p, d);
+            }
+            catch (...)
+            {
+                d(p);
+                throw;
+            }
+        }
+
+        // 别名构造函数：与 rhs 共享所有权，但是指向 p
+        template <class U>
+        basic_shared_ptr(const basic_shared_ptr<U, Count>& rhs, T* p) noexcept
+            : ptr_(p), cb_(rhs.cb_)
+        {
+            if (cb_ != nullptr)
+                cb_->add_ref();
+        }
+
+        basic_shared_ptr(const basic_shared_ptr& rhs) noexcept
+            : ptr_(rhs.ptr_), cb_(rhs.cb_)
+        {
+            if (cb_ != nullptr)
+                cb_->add_ref();
+        }
+
+        template <class U, class = typename std::enable_if<std::is_convertible<U*, T*>::value>::type>
+        basic_shared_ptr(const basic_shared_ptr<U, Count>& rhs) noexcept
+            : ptr_(rhs.ptr_), cb_(rhs.cb_)
+        {
+            if (cb_ != nullptr)
+                cb_->add_ref();
+        }
+
+        basic_shared_ptr(basic_shared_ptr&& rhs) noexcept
+            : ptr_(rhs.ptr_), cb_(rhs.cb_)
+        {
+            rhs.ptr_ = nullptr;
+            rhs.cb_ = nullptr;
+        }
+
+        template <class U, class = typename std::enable_if<std::is_convertible<U*, T*>::value>::type>
+        basic_shared_ptr(basic_shared_ptr<U, Count>&& rhs) noexcept
+            : ptr_(rhs.ptr_), cb_(rhs.cb_)
+        {
+            rhs.ptr_ = nullptr;
+            rhs.cb_ = nullptr;
+        }
+
+        // 从 weak_ptr 构造，weak_ptr 已经失效时抛出 bad_weak_ptr
+        template <class U, class = typename std::enable_if<std::is_convertible<U*, T*>::value>::type>
+        explicit basic_shared_ptr(const basic_weak_ptr<U, Count>& rhs)
+            : ptr_(nullptr), cb_(nullptr)
+        {
+            if (rhs.cb_ == nullptr || !rhs.cb_->add_ref_lock())
+                throw bad_weak_ptr();
+            ptr_ = rhs.ptr_;
+            cb_ = rhs.cb_;
+        }
+
+        template <class U, class D, class = typename std::enable_if<std::is_convertible<U*, T*>::value>::type>
+        basic_shared_ptr(unique_ptr<U, D>&& rhs)
+            : ptr_(nullptr), cb_(nullptr)
+        {
+            if (rhs.get() != nullptr)
+            {
+                cb_ = new ptr_detail::sp_counted_deleter<U, D, Count>(rhs.get(), dw_stl::move(rhs.get_deleter()));
+                ptr_ = rhs.release();
+            }
+        }
+
+        // 内部使用：接管已经创建好的控制块
+        basic_shared_ptr(ptr_detail::sp_adopt_tag, T* p, control_block* cb) noexcept
+            : ptr_(p), cb_(cb)
+        {
+        }
+
+        ~basic_shared_ptr()
+        {
+            if (cb_ != nullptr)
+                cb_->release();
+        }
+
+        basic_shared_ptr& operator=(const basic_shared_ptr& rhs) noexcept
+        {
+            basic_shared_ptr(rhs).swap(*this);
+            return *this;
+        }
+
+        template <class U>
+        basic_shared_ptr& operator=(const basic_shared_ptr<U, Count>& rhs) noexcept
+        {
+            basic_shared_ptr(rhs).swap(*this);
+            return *this;
+        }
+
+        basic_shared_ptr& operator=(basic_shared_ptr&& rhs) noexcept
+        {
+            basic_shared_ptr(dw_stl::move(rhs)).swap(*this);
+            return *this;
+        }
+
+        template <class U>
+        basic_shared_ptr& operator=(basic_shared_ptr<U, Count>&& rhs) noexcept
+        {
+            basic_shared_ptr(dw_stl::move(rhs)).swap(*this);
+            return *this;
+        }
+
+        template <class U, class D>
+        basic_shared_ptr& operator=(unique_ptr<U, D>&& rhs)
+        {
+            basic_shared_ptr(dw_stl::move(rhs)).swap(*this);
+            return *this;
+        }
+
+        void reset() noexcept { basic_shared_ptr().swap(*this); }
+
+        template <class U>
+        void reset(U* p) { basic_shared_ptr(p).swap(*this); }
+
+        template <class U, class D>
+        void reset(U* p, D d) { basic_shared_ptr(p, d).swap(*this); }
+
+        void swap(basic_shared_ptr& rhs) noexcept
+        {
+            dw_stl::swap(ptr_, rhs.ptr_);
+            dw_stl::swap(cb_, rhs.cb_);
+        }
+
+        T* get() const noexcept { return ptr_; }
+
+        typename std::add_lvalue_reference<T>::type operator*() const
+        {
+            DW_STL_DEBUG(ptr_ != nullptr);
+            return *ptr_;
+        }
+        T* operator->() const noexcept { return ptr_; }
+
+        long use_count() const noexcept { return cb_ != nullptr ? cb_->use_count() : 0; }
+        explicit operator bool() const noexcept { return ptr_ != nullptr; }
+
+        // 按控制块的地址排序，指向同一对象不同部分的别名指针排在一起
+        template <class U>
+        bool owner_before(const basic_shared_ptr<U, Count>& rhs) const noexcept
+        { return cb_ < rhs.cb_; }
+        template <class U>
+        bool owner_before(const basic_weak_ptr<U, Count>& rhs) const noexcept
+        { return cb_ < rhs.cb_; }
+    };
+
+    /*************************************************************************/
+    // basic_weak_ptr 模板类，不拥有对象，只能通过 lock 得到 shared_ptr
+    template <class T, class Count>
+    class basic_weak_ptr
+    {
+        template <class, class> friend class basic_shared_ptr;
+        template <class, class> friend class basic_weak_ptr;
+
+        typedef ptr_detail::sp_counted_base<Count> control_block;
+
+    public:
+        typedef T element_type;
+
+    private:
+        T*             ptr_;
+        control_block* cb_;
+
+    public:
+        constexpr basic_weak_ptr() noexcept : ptr_(nullptr), cb_(nullptr) {}
+
+        basic_weak_ptr(const basic_weak_ptr& rhs) noexcept
+            : ptr_(rhs.ptr_), cb_(rhs.cb_)
+        {
+            if (cb_ != nullptr)
+                cb_->weak_add_ref();
+        }
+
+        template <class U, class = typename std::enable_if<std::is_convertible<U*, T*>::value>::type>
+        basic_weak_ptr(const basic_weak_ptr<U, Count>& rhs) noexcept
+            : ptr_(rhs.ptr_), cb_(rhs.cb_)
+        {
+            if (cb_ != nullptr)
+                cb_->weak_add_ref();
+        }
+
+        template <class U, class = typename std::enable_if<std::is_convertible<U*, T*>::value>::type>
+        basic_weak_ptr(const basic_shared_ptr<U, Count>& rhs) noexcept
+            : ptr_(rhs.ptr_), cb_(rhs.cb_)
+        {
+            if (cb_ != nullptr)
+                cb_->weak_add_ref();
+        }
+
+        basic_weak_ptr(basic_weak_ptr&& rhs) noexcept
+            : ptr_(rhs.ptr_), cb_(rhs.cb_)
+        {
+            rhs.ptr_ = nullptr;
+            rhs.cb_ = nullptr;
+        }
+
+        ~basic_weak_ptr()
+        {
+            if (cb_ != nullptr)
+                cb_->weak_release();
+        }
+
+        basic_weak_ptr& operator=(const basic_weak_ptr& rhs) noexcept
+        {
+            basic_weak_ptr(rhs).swap(*this);
+            return *this;
+        }
+
+        template <class U>
+        basic_weak_ptr& operator=(const basic_shared_ptr<U, Count>& rhs) noexcept
+        {
+            basic_weak_ptr(rhs).swap(*this);
+            return *this;
+        }
+
+        basic_weak_ptr& operator=(basic_weak_ptr&& rhs) noexcept
+        {
+            basic_weak_ptr(dw_stl::move(rhs)).swap(*this);
+            return *this;
+        }
+
+        void reset() noexcept { basic_weak_ptr().swap(*this); }
+
+        void swap(basic_weak_ptr& rhs) noexcept
+        {
+            dw_stl::swap(ptr_, rhs.ptr_);
+            dw_stl::swap(cb_, rhs.cb_);
+        }
+
+        long use_count() const noexcept { return cb_ != nullptr ? cb_->use_count() : 0; }
+        bool expired() const noexcept { return use_count() == 0; }
+
+        // 对象仍然存在时返回共享它的 shared_ptr，否则返回空的 shared_ptr
+        basic_shared_ptr<T, Count> lock() const noexcept
+        {
+            if (cb_ != nullptr && cb_->add_ref_lock())
+                return basic_shared_ptr<T, Count>(ptr_detail::sp_adopt_tag(), ptr_, cb_);
+            return basic_shared_ptr<T, Count>();
+        }
+
+        template <class U>
+        bool owner_before(const basic_shared_ptr<U, Count>& rhs) const noexcept
+        { return cb_ < rhs.cb_; }
+        template <class U>
+        bool owner_before(const basic_weak_ptr<U, Count>& rhs) const noexcept
+        { return cb_ < rhs.cb_; }
+    };
+
+    // 引用计数是原子操作，可以在多个线程之间共享
+    template <class T>
+    using shared_ptr = basic_shared_ptr<T, ptr_detail::atomic_count>;
+    template <class T>
+    using weak_ptr = basic_weak_ptr<T, ptr_detail::atomic_count>;
+
+    // 引用计数不是原子操作，只能在一个线程中使用，复制和销毁的开销更小
+    template <class T>
+    using local_shared_ptr = basic_shared_ptr<T, ptr_detail::local_count>;
+    template <class T>
+    using local_weak_ptr = basic_weak_ptr<T, ptr_detail::local_count>;
+
+    // allocate_shared 函数，使用 alloc 一次分配控制块和对象
+    template <class T, class Alloc, class... Args>
+    shared_ptr<T> allocate_shared(const Alloc& alloc, Args&& ...args)
+    {
+        typedef ptr_detail::sp_counted_inplace<T, Alloc, ptr_detail::atomic_count> block_type;
+        block_type* cb = block_type::create(alloc, dw_stl::forward<Args>(args)...);
+        return shared_ptr<T>(ptr_detail::sp_adopt_tag(), cb->ptr(), cb);
+    }
+
+    template <class T, class... Args>
+    shared_ptr<T> make_shared(Args&& ...args)
+    {
+        return dw_stl::allocate_shared<T>(dw_stl::allocator<T>(), dw_stl::forward<Args>(args)...);
+    }
+
+    template <class T, class Alloc, class... Args>
+    local_shared_ptr<T> allocate_local_shared(const Alloc& alloc, Args&& ...args)
+    {
+        typedef ptr_detail::sp_counted_inplace<T, Alloc, ptr_detail::local_count> block_type;
+        block_type* cb = block_type::create(alloc, dw_stl::forward<Args>(args)...);
+        return local_shared_ptr<T>(ptr_detail::sp_adopt_tag(), cb->ptr(), cb);
+    }
+
+    template <class T, class... Args>
+    local_shared_ptr<T> make_local_shared(Args&& ...args)
+    {
+        return dw_stl::allocate_local_shared<T>(dw_stl::allocator<T>(), dw_stl::forward<Args>(args)...);
+    }
+
+    // 类型转换
+    template <class T, class U, class Count>
+    basic_shared_ptr<T, Count> static_pointer_cast(const basic_shared_ptr<U, Count>& r) noexcept
+    {
+        return basic_shared_ptr<T, Count>(r, static_cast<T*>(r.get()));
+    }
+
+    template <class T, class U, class Count>
+    basic_shared_ptr<T, Count> const_pointer_cast(const basic_shared_ptr<U, Count>& r) noexcept
+    {
+        return basic_shared_ptr<T, Count>(r, const_cast<T*>(r.get()));
+    }
+
+    template <class T, class U, class Count>
+    basic_shared_ptr<T, Count> dynamic_pointer_cast(const basic_shared_ptr<U, Count>& r) noexcept
+    {
+        T* p = dynamic_cast<T*>(r.get());
+        return p != nullptr ? basic_shared_ptr<T, Count>(r, p) : basic_shared_ptr<T, Count>();
+    }
+
+    // 比较操作符
+    template <class T, class U, class Count>
+    bool operator==(const basic_shared_ptr<T, Count>& lhs, const basic_shared_ptr<U, Count>& rhs) noexcept
+    {
+        return lhs.get() == rhs.get();
+    }
+
+    template <class T, class U, class Count>
+    bool operator!=(const basic_shared_ptr<T, Count>& lhs, const basic_shared_ptr<U, Count>& rhs) noexcept
+    {
+        return lhs.get() != rhs.get();
+    }
+
+    template <class T, class U, class Count>
+    bool operator<(const basic_shared_ptr<T, Count>& lhs, const basic_shared_ptr<U, Count>& rhs) noexcept
+    {
+        return lhs.get() < rhs.get();
+    }
+
+    template <class T, class Count>
+    bool operator==(const basic_shared_ptr<T, Count>& lhs, std::nullptr_t) noexcept { return !lhs; }
+    template <class T, class Count>
+    bool operator==(std::nullptr_t, const basic_shared_ptr<T, Count>& rhs) noexcept { return !rhs; }
+    template <class T, class Count>
+    bool operator!=(const basic_shared_ptr<T, Count>& lhs, std::nullptr_t) noexcept { return static_cast<bool>(lhs); }
+    template <class T, class Count>
+    bool operator!=(std::nullptr_t, const basic_shared_ptr<T, Count>& rhs) noexcept { return static_cast<bool>(rhs); }
+
+    template <class T, class Count>
+    void swap(basic_shared_ptr<T, Count>& lhs, basic_shared_ptr<T, Count>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+
+    template <class T, class Count>
+    void swap(basic_weak_ptr<T, Count>& lhs, basic_weak_ptr<T, Count>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+
+    // 只保存两个指针，可以按字节迁移
+    template <class T, class Count>
+    struct is_trivially_relocatable<basic_shared_ptr<T, Count>> : std::true_type {};
+    template <class T, class Count>
+    struct is_trivially_relocatable<basic_weak_ptr<T, Count>> : std::true_type {};
+
 } // namespace dw_stl
 
 #endif
\ No newline at end of file
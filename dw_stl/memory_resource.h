@@ -0,0 +1,601 @@
+#ifndef DW_STL_MEMORY_RESOURCE_H_
+#define DW_STL_MEMORY_RESOURCE_H_
+
+/*
+这个头文件实现了多态内存资源(polymorphic memory resource)，位于命名空间 dw_stl::pmr 中
+容器使用 polymorphic_allocator 时，内存从运行期指定的 memory_resource 中分配，
+不同的内存策略不需要改变容器的类型
+
+实现了以下内容：
+memory_resource                 : 内存资源的抽象基类
+new_delete_resource()           : 使用 ::operator new / delete 的内存资源(默认资源)
+null_memory_resource()          : 任何分配都会抛出 std::bad_alloc 的内存资源
+get_default_resource / set_default_resource
+monotonic_buffer_resource       : 单调增长的缓冲区，deallocate 不做任何事情，release 或析构时一次性释放
+unsynchronized_pool_resource    : 按块大小划分的内存池，非线程安全
+synchronized_pool_resource      : 加锁的 unsynchronized_pool_resource
+polymorphic_allocator<T>        : 使用 memory_resource 的分配器
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <atomic>
+#include <mutex>
+
+#include "util.h"
+#include "exceptdef.h"
+#include "aligned_alloc.h"
+
+namespace dw_stl
+{
+namespace pmr
+{
+    // 默认的对齐字节数
+    static constexpr size_t max_align = alignof(std::max_align_t);
+
+    /*****************************************************************************************/
+    // memory_resource
+    // 内存资源的抽象基类，派生类需要实现 do_allocate, do_deallocate, do_is_equal
+    /*****************************************************************************************/
+    class memory_resource
+    {
+    public:
+        virtual ~memory_resource() = default;
+
+        void* allocate(size_t bytes, size_t alignment = max_align)
+        { return do_allocate(bytes, alignment); }
+
+        void deallocate(void* ptr, size_t bytes, size_t alignment = max_align)
+        { do_deallocate(ptr, bytes, alignment); }
+
+        bool is_equal(const memory_resource& other) const noexcept
+        { return do_is_equal(other); }
+
+    private:
+        virtual void* do_allocate(size_t bytes, size_t alignment) = 0;
+        virtual void  do_deallocate(void* ptr, size_t bytes, size_t alignment) = 0;
+        virtual bool  do_is_equal(const memory_resource& other) const noexcept = 0;
+    };
+
+    inline bool operator==(const memory_resource& lhs, const memory_resource& rhs) noexcept
+    {
+        return &lhs == &rhs || lhs.is_equal(rhs);
+    }
+
+    inline bool operator!=(const memory_resource& lhs, const memory_resource& rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+
+    namespace resource_detail
+    {
+        // 将 n 上调到 alignment 的倍数
+        inline size_t align_up(size_t n, size_t alignment)
+        { return (n + alignment - 1) & ~(alignment - 1); }
+
+        // 对齐要求超过 max_align 时使用 aligned_alloc.h 中的对齐分配
+        inline void* aligned_new(size_t bytes, size_t alignment)
+        { return aligned_alloc::allocate(bytes, alignment); }
+
+        inline void aligned_delete(void* ptr, size_t alignment)
+        { aligned_alloc::deallocate(ptr, alignment); }
+    }
+
+    /*****************************************************************************************/
+    // new_delete_resource 与 null_memory_resource
+    /*****************************************************************************************/
+    class new_delete_memory_resource : public memory_resource
+    {
+    private:
+        void* do_allocate(size_t bytes, size_t alignment) override
+        { return resource_detail::aligned_new(bytes, alignment); }
+
+        void do_deallocate(void* ptr, size_t, size_t alignment) override
+        { resource_detail::aligned_delete(ptr, alignment); }
+
+        bool do_is_equal(const memory_resource& other) const noexcept override
+        { return this == &other; }
+    };
+
+    class null_resource : public memory_resource
+    {
+    private:
+        void* do_allocate(size_t, size_t) override
+        { throw std::bad_alloc(); }
+
+        void do_deallocate(void*, size_t, size_t) override {}
+
+        bool do_is_equal(const memory_resource& other) const noexcept override
+        { return this == &other; }
+    };
+
+    inline memory_resource* new_delete_resource() noexcept
+    {
+        static new_delete_memory_resource resource;
+        return &resource;
+    }
+
+    inline memory_resource* null_memory_resource() noexcept
+    {
+        static null_resource resource;
+        return &resource;
+    }
+
+    namespace resource_detail
+    {
+        inline std::atomic<memory_resource*>& default_resource()
+        {
+            static std::atomic<memory_resource*> resource(new_delete_resource());
+            return resource;
+        }
+    }
+
+    // 获取默认的内存资源
+    inline memory_resource* get_default_resource() noexcept
+    {
+        return resource_detail::default_resource().load(std::memory_order_acquire);
+    }
+
+    // 设置默认的内存资源，传入 nullptr 时恢复为 new_delete_resource，返回原来的默认资源
+    inline memory_resource* set_default_resource(memory_resource* r) noexcept
+    {
+        if (r == nullptr)
+            r = new_delete_resource();
+        return resource_detail::default_resource().exchange(r, std::memory_order_acq_rel);
+    }
+
+    /*****************************************************************************************/
+    // monotonic_buffer_resource
+    // 从当前缓冲区顺序切出内存，用完后向上游申请一块更大的缓冲区(每次翻倍)
+    // deallocate 不做任何事情，内存在 release() 或析构时一次性归还给上游
+    // 适合一个请求内的临时容器：请求结束时整体释放，不需要逐个容器释放
+    /*****************************************************************************************/
+    class monotonic_buffer_resource : public memory_resource
+    {
+    private:
+        // 每块从上游申请的缓冲区的头部，用链表串起来
+        struct chunk_header
+        {
+            chunk_header* next;
+            size_t        size;       // 整块的字节数(包含头部)
+            size_t        alignment;  // 向上游申请时的对齐
+        };
+
+        memory_resource* upstream_;
+        void*            initial_buffer_;   // 用户提供的初始缓冲区
+        size_t           initial_size_;
+        char*            cur_;              // 当前缓冲区中未使用空间的头部
+        size_t           space_;            // 当前缓冲区剩余的字节数
+        size_t           next_size_;        // 下一次向上游申请的大小
+        chunk_header*    chunks_;
+
+        static constexpr size_t default_size = 1024;
+
+    public:
+        explicit monotonic_buffer_resource(memory_resource* upstream = get_default_resource())
+            :upstream_(upstream), initial_buffer_(nullptr), initial_size_(0),
+            cur_(nullptr), space_(0), next_size_(default_size), chunks_(nullptr) {}
+
+        explicit monotonic_buffer_resource(size_t initial_size,
+                                           memory_resource* upstream = get_default_resource())
+            :upstream_(upstream), initial_buffer_(nullptr), initial_size_(0),
+            cur_(nullptr), space_(0), next_size_(initial_size == 0 ? 1 : initial_size), chunks_(nullptr) {}
+
+        // 使用用户提供的缓冲区，例如栈上的数组，用完之后才会向上游申请
+        monotonic_buffer_resource(void* buffer, size_t buffer_size,
+                                  memory_resource* upstream = get_default_resource())
+            :upstream_(upstream), initial_buffer_(buffer), initial_size_(buffer_size),
+            cur_(static_cast<char*>(buffer)), space_(buffer_size),
+            next_size_(buffer_size == 0 ? default_size : buffer_size * 2), chunks_(nullptr) {}
+
+        monotonic_buffer_resource(const monotonic_buffer_resource&) = delete;
+        monotonic_buffer_resource& operator=(const monotonic_buffer_resource&) = delete;
+
+        ~monotonic_buffer_resource() override
+        { release(); }
+
+        // 把从上游申请的全部缓冲区归还，回到构造时的状态
+        void release()
+        {
+            while (chunks_ != nullptr)
+            {
+                chunk_header* next = chunks_->next;
+                upstream_->deallocate(chunks_, chunks_->size, chunks_->alignment);
+                chunks_ = next;
+            }
+            cur_ = static_cast<char*>(initial_buffer_);
+            space_ = initial_size_;
+        }
+
+        memory_resource* upstream_resource() const noexcept
+        { return upstream_; }
+
+    private:
+        void* do_allocate(size_t bytes, size_t alignment) override
+        {
+            if (bytes == 0)
+                bytes = 1;
+            void* result = try_allocate(bytes, alignment);
+            if (result == nullptr)
+            {
+                new_chunk(bytes, alignment);
+                result = try_allocate(bytes, alignment);
+            }
+            return result;
+        }
+
+        // 单调资源不回收单个内存块
+        void do_deallocate(void*, size_t, size_t) override {}
+
+        bool do_is_equal(const memory_resource& other) const noexcept override
+        { return this == &other; }
+
+        // 在当前缓冲区中按照 alignment 对齐切出 bytes 个字节，空间不足时返回 nullptr
+        void* try_allocate(size_t bytes, size_t alignment)
+        {
+            if (cur_ == nullptr)
+                return nullptr;
+            const uintptr_t addr = reinterpret_cast<uintptr_t>(cur_);
+            const uintptr_t aligned = (addr + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+            const size_t padding = static_cast<size_t>(aligned - addr);
+            if (padding > space_ || bytes > space_ - padding)
+                return nullptr;
+            cur_ += padding + bytes;
+            space_ -= padding + bytes;
+            return reinterpret_cast<void*>(aligned);
+        }
+
+        // 向上游申请新的缓冲区，大小至少能放下本次请求
+        void new_chunk(size_t bytes, size_t alignment)
+        {
+            const size_t header = resource_detail::align_up(sizeof(chunk_header), max_align);
+            size_t size = next_size_;
+            if (size < bytes + alignment + header)
+                size = bytes + alignment + header;
+            const size_t chunk_align = alignment > max_align ? alignment : max_align;
+            void* p = upstream_->allocate(size, chunk_align);
+            chunk_header* h = static_cast<chunk_header*>(p);
+            h->next = chunks_;
+            h->size = size;
+            h->alignment = chunk_align;
+            chunks_ = h;
+            cur_ = static_cast<char*>(p) + header;
+            space_ = size - header;
+            next_size_ = size * 2;
+        }
+    };
+
+    /*****************************************************************************************/
+    // pool_options 与 unsynchronized_pool_resource
+    // 按照 2 的幂划分块大小，每种块大小一个池，池中的块用完之后向上游申请新的 chunk(块数目每次翻倍)
+    // 超过 largest_required_pool_block 的请求直接交给上游，并记录下来以便 release 时释放
+    /*****************************************************************************************/
+    struct pool_options
+    {
+        size_t max_blocks_per_chunk = 0;        // 每个 chunk 最多的块数目，0 表示使用默认值
+        size_t largest_required_pool_block = 0; // 池负责的最大块大小，0 表示使用默认值
+    };
+
+    class unsynchronized_pool_resource : public memory_resource
+    {
+    private:
+        static constexpr size_t min_block = 8;
+        static constexpr size_t default_max_blocks = 1024;
+        static constexpr size_t default_largest_block = 4096;
+        static constexpr size_t max_pools = 32;
+
+        struct free_block { free_block* next; };
+
+        struct chunk_header
+        {
+            chunk_header* next;
+            size_t        size;
+        };
+
+        // 一种块大小对应的池
+        struct pool
+        {
+            size_t        block_size;
+            size_t        next_blocks;   // 下一个 chunk 的块数目
+            free_block*   free_list;
+            chunk_header* chunks;
+        };
+
+        // 直接交给上游的大块内存，用双向链表记录
+        struct large_header
+        {
+            large_header* prev;
+            large_header* next;
+            size_t        size;       // 向上游申请的总字节数
+            size_t        alignment;  // 向上游申请时的对齐
+        };
+
+        memory_resource* upstream_;
+        pool_options     options_;
+        pool             pools_[max_pools];
+        size_t           npools_;
+        large_header*    large_;
+
+    public:
+        unsynchronized_pool_resource()
+            :unsynchronized_pool_resource(pool_options(), get_default_resource()) {}
+
+        explicit unsynchronized_pool_resource(memory_resource* upstream)
+            :unsynchronized_pool_resource(pool_options(), upstream) {}
+
+        explicit unsynchronized_pool_resource(const pool_options& opts,
+                                              memory_resource* upstream = get_default_resource())
+            :upstream_(upstream), options_(opts), npools_(0), large_(nullptr)
+        {
+            if (options_.max_blocks_per_chunk == 0)
+                options_.max_blocks_per_chunk = default_max_blocks;
+            if (options_.largest_required_pool_block == 0)
+                options_.largest_required_pool_block = default_largest_block;
+            if (options_.largest_required_pool_block < min_block)
+                options_.largest_required_pool_block = min_block;
+            size_t size = min_block;
+            while (npools_ < max_pools)
+            {
+                pools_[npools_].block_size = size;
+                pools_[npools_].next_blocks = 1;
+                pools_[npools_].free_list = nullptr;
+                pools_[npools_].chunks = nullptr;
+                ++npools_;
+                if (size >= options_.largest_required_pool_block)
+                    break;
+                size <<= 1;
+            }
+            options_.largest_required_pool_block = pools_[npools_ - 1].block_size;
+        }
+
+        unsynchronized_pool_resource(const unsynchronized_pool_resource&) = delete;
+        unsynchronized_pool_resource& operator=(const unsynchronized_pool_resource&) = delete;
+
+        ~unsynchronized_pool_resource() override
+        { release(); }
+
+        // 把全部内存归还给上游，即使其中的块还没有被 deallocate
+        void release()
+        {
+            for (size_t i = 0; i < npools_; ++i)
+            {
+                pool& p = pools_[i];
+                while (p.chunks != nullptr)
+                {
+                    chunk_header* next = p.chunks->next;
+                    upstream_->deallocate(p.chunks, p.chunks->size, max_align);
+                    p.chunks = next;
+                }
+                p.free_list = nullptr;
+                p.next_blocks = 1;
+            }
+            while (large_ != nullptr)
+            {
+                large_header* next = large_->next;
+                upstream_->deallocate(large_, large_->size, large_->alignment);
+                large_ = next;
+            }
+        }
+
+        memory_resource* upstream_resource() const noexcept
+        { return upstream_; }
+
+        pool_options options() const noexcept
+        { return options_; }
+
+    protected:
+        void* do_allocate(size_t bytes, size_t alignment) override
+        {
+            pool* p = find_pool(bytes, alignment);
+            if (p == nullptr)
+                return allocate_large(bytes, alignment);
+            if (p->free_list == nullptr)
+                replenish(*p);
+            free_block* block = p->free_list;
+            p->free_list = block->next;
+            return block;
+        }
+
+        void do_deallocate(void* ptr, size_t bytes, size_t alignment) override
+        {
+            if (ptr == nullptr)
+                return;
+            pool* p = find_pool(bytes, alignment);
+            if (p == nullptr)
+            {
+                deallocate_large(ptr, alignment);
+                return;
+            }
+            free_block* block = static_cast<free_block*>(ptr);
+            block->next = p->free_list;
+            p->free_list = block;
+        }
+
+        bool do_is_equal(const memory_resource& other) const noexcept override
+        { return this == &other; }
+
+    private:
+        // 找到能放下 bytes 且满足对齐的最小的池，找不到时返回 nullptr
+        // 块大小是 2 的幂且 chunk 按 max_align 对齐，所以块天然按 min(块大小, max_align) 对齐
+        pool* find_pool(size_t bytes, size_t alignment)
+        {
+            if (alignment > max_align)
+                return nullptr;
+            const size_t need = bytes > alignment ? bytes : alignment;
+            if (need > options_.largest_required_pool_block)
+                return nullptr;
+            size_t i = 0;
+            while (pools_[i].block_size < need)
+                ++i;
+            return &pools_[i];
+        }
+
+        // 池中没有空闲块时，向上游申请一个新的 chunk
+        void replenish(pool& p)
+        {
+            const size_t header = resource_detail::align_up(sizeof(chunk_header), max_align);
+            const size_t nblocks = p.next_blocks;
+            const size_t size = header + nblocks * p.block_size;
+            char* mem = static_cast<char*>(upstream_->allocate(size, max_align));
+            chunk_header* h = reinterpret_cast<chunk_header*>(mem);
+            h->next = p.chunks;
+            h->size = size;
+            p.chunks = h;
+            char* first = mem + header;
+            for (size_t i = nblocks; i > 0; --i)
+            {
+                free_block* block = reinterpret_cast<free_block*>(first + (i - 1) * p.block_size);
+                block->next = p.free_list;
+                p.free_list = block;
+            }
+            if (p.next_blocks < options_.max_blocks_per_chunk)
+                p.next_blocks *= 2;
+            if (p.next_blocks > options_.max_blocks_per_chunk)
+                p.next_blocks = options_.max_blocks_per_chunk;
+        }
+
+        static size_t large_header_size(size_t alignment)
+        {
+            const size_t a = alignment > max_align ? alignment : max_align;
+            return resource_detail::align_up(sizeof(large_header), a);
+        }
+
+        void* allocate_large(size_t bytes, size_t alignment)
+        {
+            const size_t header = large_header_size(alignment);
+            const size_t chunk_align = alignment > max_align ? alignment : max_align;
+            const size_t size = header + bytes;
+            char* mem = static_cast<char*>(upstream_->allocate(size, chunk_align));
+            large_header* h = reinterpret_cast<large_header*>(mem);
+            h->prev = nullptr;
+            h->next = large_;
+            h->size = size;
+            h->alignment = chunk_align;
+            if (large_ != nullptr)
+                large_->prev = h;
+            large_ = h;
+            return mem + header;
+        }
+
+        void deallocate_large(void* ptr, size_t alignment)
+        {
+            large_header* h = reinterpret_cast<large_header*>(
+                static_cast<char*>(ptr) - large_header_size(alignment));
+            if (h->prev != nullptr)
+                h->prev->next = h->next;
+            else
+                large_ = h->next;
+            if (h->next != nullptr)
+                h->next->prev = h->prev;
+            upstream_->deallocate(h, h->size, h->alignment);
+        }
+    };
+
+    /*****************************************************************************************/
+    // synchronized_pool_resource
+    // 每次分配和释放都加锁的 unsynchronized_pool_resource，可以被多个线程共享
+    /*****************************************************************************************/
+    class synchronized_pool_resource : public unsynchronized_pool_resource
+    {
+    private:
+        std::mutex mtx_;
+
+    public:
+        synchronized_pool_resource() = default;
+
+        explicit synchronized_pool_resource(memory_resource* upstream)
+            :unsynchronized_pool_resource(upstream) {}
+
+        explicit synchronized_pool_resource(const pool_options& opts,
+                                            memory_resource* upstream = get_default_resource())
+            :unsynchronized_pool_resource(opts, upstream) {}
+
+        void release()
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            unsynchronized_pool_resource::release();
+        }
+
+    protected:
+        void* do_allocate(size_t bytes, size_t alignment) override
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            return unsynchronized_pool_resource::do_allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void* ptr, size_t bytes, size_t alignment) override
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            unsynchronized_pool_resource::do_deallocate(ptr, bytes, alignment);
+        }
+    };
+
+    /*****************************************************************************************/
+    // polymorphic_allocator
+    // 分配器只保存一个 memory_resource 指针，不同内存资源的容器类型相同
+    // 分配器不会在容器的拷贝、移动赋值和交换时传播，拷贝构造容器时使用默认资源
+    /*****************************************************************************************/
+    template <class T>
+    class polymorphic_allocator
+    {
+    public:
+        typedef T           value_type;
+        typedef T*          pointer;
+        typedef const T*    const_pointer;
+        typedef size_t      size_type;
+        typedef ptrdiff_t   difference_type;
+
+    private:
+        memory_resource* resource_;
+
+    public:
+        polymorphic_allocator() noexcept
+            :resource_(get_default_resource()) {}
+
+        polymorphic_allocator(memory_resource* r) noexcept
+            :resource_(r != nullptr ? r : get_default_resource()) {}
+
+        polymorphic_allocator(const polymorphic_allocator&) = default;
+
+        template <class U>
+        polymorphic_allocator(const polymorphic_allocator<U>& rhs) noexcept
+            :resource_(rhs.resource()) {}
+
+        polymorphic_allocator& operator=(const polymorphic_allocator&) = delete;
+
+        T* allocate(size_type n)
+        {
+            THROW_LENGTH_ERROR_IF(n > static_cast<size_type>(-1) / sizeof(T),
+                                  "polymorphic_allocator<T>::allocate() size too big");
+            return static_cast<T*>(resource_->allocate(n * sizeof(T), alignof(T)));
+        }
+
+        void deallocate(T* ptr, size_type n)
+        {
+            resource_->deallocate(ptr, n * sizeof(T), alignof(T));
+        }
+
+        memory_resource* resource() const noexcept
+        { return resource_; }
+
+        // 拷贝构造的容器不继承原容器的内存资源
+        polymorphic_allocator select_on_container_copy_construction() const
+        { return polymorphic_allocator(); }
+    };
+
+    template <class T, class U>
+    bool operator==(const polymorphic_allocator<T>& lhs, const polymorphic_allocator<U>& rhs) noexcept
+    {
+        return *lhs.resource() == *rhs.resource();
+    }
+
+    template <class T, class U>
+    bool operator!=(const polymorphic_allocator<T>& lhs, const polymorphic_allocator<U>& rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+}
+}
+
+#endif
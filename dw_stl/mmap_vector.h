@@ -0,0 +1,592 @@
+#ifndef DW_STL_MMAP_VECTOR_H_
+#define DW_STL_MMAP_VECTOR_H_
+
+/*
+这个头文件用于实现模板类 mmap_vector<T>，元素保存在用 mmap 映射的文件中，进程退出之后数据仍然保留
+
+只能保存可以平凡复制的类型，文件的内容就是元素的字节，重新打开时直接映射，不需要解析或者复制：
+    文件开头是 64 字节的 mmap_vector_header(魔数、版本、元素的大小与对齐、元素个数)，之后是元素数组
+    元素个数直接写在映射的文件头中，修改之后立即生效，不需要单独保存
+    扩容时先用 ftruncate 扩大文件，再用 mremap 重新映射(没有 mremap 的平台先 munmap 再 mmap)，
+    新的容量按 Growth 计算之后取整到页大小，默认按 2 倍扩容
+    sync() / sync_async() / sync(first, n) 调用 msync 把修改写回文件，不调用时由内核在之后写回
+    shrink_to_fit() 把文件截短到恰好保存 size() 个元素
+    以 read_only 打开时只映射为只读，修改容器的操作抛出 std::runtime_error(通过元素的引用写入仍然是错误的)
+
+iterator 与 dw_stl::vector<T> 的 iterator 一样都是 T*，接口也与 vector 相同，使用 vector 迭代器的代码可以直接使用
+注意：扩容会重新映射，与 vector 一样之前的指针、引用与迭代器全部失效
+
+实现了以下内容：
+mmap_vector_header      : 文件头
+mmap_vector_mode        : 打开方式 open_or_create / create / open_existing / read_only
+mmap_vector<T>          : 文件映射的 vector
+*/
+
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "vector.h"
+#include "exceptdef.h"
+
+namespace dw_stl
+{
+    // 文件头，占用 64 字节，元素数组从第 64 个字节开始
+    struct mmap_vector_header
+    {
+        static constexpr uint64_t file_magic = 0x5443455650414d4dULL;   // "MMAPVECT"
+        static constexpr uint32_t file_version = 1;
+
+        uint64_t magic;
+        uint32_t version;
+        uint32_t elem_size;     // sizeof(T)
+        uint32_t elem_align;    // alignof(T)
+        uint32_t reserved0;
+        uint64_t size;          // 元素个数
+        uint64_t reserved[4];
+    };
+
+    static_assert(sizeof(mmap_vector_header) == 64, "mmap_vector_header should be 64 bytes");
+
+    enum class mmap_vector_mode
+    {
+        open_or_create, // 文件存在时打开，否则创建
+        create,         // 创建新文件，已经存在时清空
+        open_existing,  // 只打开已经存在的文件
+        read_only       // 只读打开已经存在的文件
+    };
+
+    // 模板类mmap_vector
+    // 模板参数T代表数据类型，必须可以平凡复制，Growth代表扩容策略
+    template <class T, class Growth = dw_stl::growth_2x>
+    class mmap_vector
+    {
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "mmap_vector<T> requires a trivially copyable value_type");
+        static_assert(alignof(T) <= sizeof(mmap_vector_header),
+                      "mmap_vector<T> does not support value_type aligned more than 64 bytes");
+    public:
+        typedef T                   value_type;
+        typedef T*                  pointer;
+        typedef const T*            const_pointer;
+        typedef T*                  iterator;
+        typedef const T*            const_iterator;
+        typedef T&                  reference;
+        typedef const T&            const_reference;
+        typedef size_t              size_type;
+        typedef ptrdiff_t           difference_type;
+
+        typedef dw_stl::reverse_iterator<iterator>       reverse_iterator;
+        typedef dw_stl::reverse_iterator<const_iterator> const_reverse_iterator;
+
+        static constexpr size_t header_bytes = sizeof(mmap_vector_header);
+
+    private:
+        int                 fd_;        // 文件描述符，没有打开时为 -1
+        char*               map_;       // 映射的起始地址
+        size_t              map_len_;   // 映射(文件)的字节数
+        size_type           cap_;       // 容量
+        bool                read_only_;
+
+    public:
+        // 构造、移动、析构函数
+        mmap_vector() noexcept
+            : fd_(-1), map_(nullptr), map_len_(0), cap_(0), read_only_(false) {}
+
+        explicit mmap_vector(const char* path, mmap_vector_mode mode = mmap_vector_mode::open_or_create)
+            : fd_(-1), map_(nullptr), map_len_(0), cap_(0), read_only_(false)
+        { open(path, mode); }
+
+        mmap_vector(const mmap_vector&) = delete;
+        mmap_vector& operator=(const mmap_vector&) = delete;
+
+        mmap_vector(mmap_vector&& rhs) noexcept
+            : fd_(rhs.fd_), map_(rhs.map_), map_len_(rhs.map_len_), cap_(rhs.cap_), read_only_(rhs.read_only_)
+        { rhs.reset_members(); }
+
+        mmap_vector& operator=(mmap_vector&& rhs) noexcept
+        {
+            if (this != &rhs)
+            {
+                close();
+                fd_ = rhs.fd_;
+                map_ = rhs.map_;
+                map_len_ = rhs.map_len_;
+                cap_ = rhs.cap_;
+                read_only_ = rhs.read_only_;
+                rhs.reset_members();
+            }
+            return *this;
+        }
+
+        ~mmap_vector()
+        { close(); }
+
+        // 打开文件，已经打开时先关闭；文件头与T不符时抛出 std::runtime_error
+        void open(const char* path, mmap_vector_mode mode = mmap_vector_mode::open_or_create);
+        // 解除映射并关闭文件，修改的内容由内核写回
+        void close() noexcept;
+        bool is_open() const noexcept
+        { return fd_ != -1; }
+
+        // 把修改写回文件，sync 等待写完，sync_async 只安排写回
+        void sync()
+        { msync_range(0, map_len_, MS_SYNC); }
+        void sync_async()
+        { msync_range(0, map_len_, MS_ASYNC); }
+        // 只写回 [first, first + n) 个元素所在的页
+        void sync(size_type first, size_type n)
+        {
+            DW_STL_DEBUG(first + n <= size());
+            msync_range(header_bytes + first * sizeof(T), n * sizeof(T), MS_SYNC);
+        }
+
+    public:
+        // 迭代器相关操作
+        iterator begin() noexcept
+        { return data(); }
+        const_iterator begin() const noexcept
+        { return data(); }
+        iterator end() noexcept
+        { return data() + size(); }
+        const_iterator end() const noexcept
+        { return data() + size(); }
+
+        reverse_iterator rbegin() noexcept
+        { return reverse_iterator(end()); }
+        const_reverse_iterator rbegin() const noexcept
+        { return const_reverse_iterator(end()); }
+        reverse_iterator rend() noexcept
+        { return reverse_iterator(begin()); }
+        const_reverse_iterator rend() const noexcept
+        { return const_reverse_iterator(begin()); }
+
+        const_iterator cbegin() const noexcept
+        { return begin(); }
+        const_iterator cend() const noexcept
+        { return end(); }
+
+        // 容量相关操作
+        bool empty() const noexcept
+        { return size() == 0; }
+        size_type size() const noexcept
+        { return map_ == nullptr ? 0 : static_cast<size_type>(header()->size); }
+        size_type max_size() const noexcept
+        { return (static_cast<size_t>(-1) - header_bytes) / sizeof(T); }
+        size_type capacity() const noexcept
+        { return cap_; }
+        void reserve(size_type n);
+        // 把文件截短到恰好保存size()个元素(按页取整)
+        void shrink_to_fit();
+
+        // 访问元素相关操作
+        reference operator[](size_type n)
+        {
+            DW_STL_DEBUG(n < size());
+            return data()[n];
+        }
+        const_reference operator[](size_type n) const
+        {
+            DW_STL_DEBUG(n < size());
+            return data()[n];
+        }
+        reference at(size_type n)
+        {
+            THROW_OUT_OF_RANGE_IF(!(n < size()), "mmap_vector<T>::at() subscript out of range");
+            return data()[n];
+        }
+        const_reference at(size_type n) const
+        {
+            THROW_OUT_OF_RANGE_IF(!(n < size()), "mmap_vector<T>::at() subscript out of range");
+            return data()[n];
+        }
+
+        reference front()
+        { return (*this)[0]; }
+        const_reference front() const
+        { return (*this)[0]; }
+        reference back()
+        { return (*this)[size() - 1]; }
+        const_reference back() const
+        { return (*this)[size() - 1]; }
+
+        pointer data() noexcept
+        { return map_ == nullptr ? nullptr : reinterpret_cast<T*>(map_ + header_bytes); }
+        const_pointer data() const noexcept
+        { return map_ == nullptr ? nullptr : reinterpret_cast<const T*>(map_ + header_bytes); }
+
+        // 修改容器相关操作
+        void assign(size_type n, const value_type& value)
+        {
+            clear();
+            insert(end(), n, value);
+        }
+
+        template <class Iter, typename std::enable_if<
+            dw_stl::is_input_iterator<Iter>::value, int>::type = 0>
+        void assign(Iter first, Iter last)
+        {
+            clear();
+            append_range(first, last);
+        }
+
+        void assign(std::initializer_list<value_type> ilist)
+        { assign(ilist.begin(), ilist.end()); }
+
+        template <class... Args>
+        reference emplace_back(Args&& ...args)
+        {
+            check_writable();
+            // 先构造一个副本，参数可能引用容器中的元素，扩容之后会失效
+            value_type tmp(dw_stl::forward<Args>(args)...);
+            reserve_extra(1);
+            pointer p = end();
+            std::memcpy(static_cast<void*>(p), &tmp, sizeof(T));
+            ++header()->size;
+            return *p;
+        }
+
+        void push_back(const value_type& value)
+        { emplace_back(value); }
+
+        void pop_back()
+        {
+            DW_STL_DEBUG(!empty());
+            check_writable();
+            --header()->size;
+        }
+
+        iterator insert(const_iterator pos, const value_type& value)
+        { return insert(pos, 1, value); }
+        iterator insert(const_iterator pos, size_type n, const value_type& value);
+
+        template <class Iter, typename std::enable_if<
+            dw_stl::is_input_iterator<Iter>::value, int>::type = 0>
+        iterator insert(const_iterator pos, Iter first, Iter last)
+        {
+            check_writable();
+            const size_type xpos = pos - begin();
+            const size_type old_size = size();
+            append_range(first, last);
+            // 追加到尾部之后旋转到插入位置
+            dw_stl::rotate(begin() + xpos, begin() + old_size, end());
+            return begin() + xpos;
+        }
+
+        iterator insert(const_iterator pos, std::initializer_list<value_type> ilist)
+        { return insert(pos, ilist.begin(), ilist.end()); }
+
+        template <class Iter, typename std::enable_if<
+            dw_stl::is_input_iterator<Iter>::value, int>::type = 0>
+        void append_range(Iter first, Iter last)
+        {
+            check_writable();
+            append_dispatch(first, last, iterator_category(first));
+        }
+
+        template <class Range, typename std::enable_if<
+            dw_stl::is_range<Range>::value, int>::type = 0>
+        void append_range(const Range& r)
+        { append_range(r.begin(), r.end()); }
+
+        iterator erase(const_iterator pos)
+        { return erase(pos, pos + 1); }
+        iterator erase(const_iterator first, const_iterator last);
+        void clear()
+        {
+            if (map_ == nullptr)
+                return;
+            check_writable();
+            header()->size = 0;
+        }
+
+        void resize(size_type new_size)
+        { resize(new_size, value_type()); }
+        void resize(size_type new_size, const value_type& value)
+        {
+            check_writable();
+            if (new_size < size())
+                header()->size = new_size;
+            else
+                insert(end(), new_size - size(), value);
+        }
+
+        void swap(mmap_vector& rhs) noexcept
+        {
+            dw_stl::swap(fd_, rhs.fd_);
+            dw_stl::swap(map_, rhs.map_);
+            dw_stl::swap(map_len_, rhs.map_len_);
+            dw_stl::swap(cap_, rhs.cap_);
+            dw_stl::swap(read_only_, rhs.read_only_);
+        }
+
+    private:
+        mmap_vector_header* header() noexcept
+        { return reinterpret_cast<mmap_vector_header*>(map_); }
+        const mmap_vector_header* header() const noexcept
+        { return reinterpret_cast<const mmap_vector_header*>(map_); }
+
+        void reset_members() noexcept
+        {
+            fd_ = -1;
+            map_ = nullptr;
+            map_len_ = 0;
+            cap_ = 0;
+            read_only_ = false;
+        }
+
+        static size_t page_size() noexcept
+        {
+            static const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+            return page;
+        }
+
+        // 保存n个元素需要的文件字节数，按页取整
+        static size_t bytes_for(size_type n) noexcept
+        {
+            const size_t page = page_size();
+            return (header_bytes + n * sizeof(T) + page - 1) / page * page;
+        }
+
+        // 只读打开时映射为PROT_READ，修改操作在写入之前抛出异常
+        void check_writable() const
+        { THROW_RUNTIME_ERROR_IF(read_only_, "mmap_vector<T> is read only"); }
+
+        // 文件大小改为len个字节并重新映射
+        void remap(size_t len);
+
+        // 保证剩余容量不少于n，按扩容策略增长
+        void reserve_extra(size_type n)
+        {
+            if (cap_ - size() >= n)
+                return;
+            THROW_LENGTH_ERROR_IF(size() > max_size() - n, "mmap_vector<T> size too big");
+            reserve(Growth::grow(cap_, size() + n, static_cast<size_type>(vector_init_cap<T>::value), max_size()));
+        }
+
+        void msync_range(size_t offset, size_t len, int flags)
+        {
+            if (map_ == nullptr || len == 0)
+                return;
+            // msync 要求起始地址按页对齐
+            const size_t begin = offset / page_size() * page_size();
+            THROW_RUNTIME_ERROR_IF(::msync(map_ + begin, offset + len - begin, flags) != 0,
+                                   "mmap_vector<T>::sync() msync failed");
+        }
+
+        template <class InputIter>
+        void append_dispatch(InputIter first, InputIter last, input_iterator_tag)
+        {
+            for (; first != last; ++first)
+                emplace_back(*first);
+        }
+
+        template <class FIter>
+        void append_dispatch(FIter first, FIter last, forward_iterator_tag)
+        {
+            const size_type n = static_cast<size_type>(dw_stl::distance(first, last));
+            reserve_extra(n);
+            pointer p = end();
+            for (; first != last; ++first, ++p)
+                ::new (static_cast<void*>(p)) T(*first);
+            header()->size += n;
+        }
+    };
+
+    /*****************************************************************************************/
+
+    template <class T, class Growth>
+    void mmap_vector<T, Growth>::open(const char* path, mmap_vector_mode mode)
+    {
+        close();
+        int flags = O_RDWR;
+        if (mode == mmap_vector_mode::read_only)
+            flags = O_RDONLY;
+        else if (mode == mmap_vector_mode::open_or_create)
+            flags |= O_CREAT;
+        else if (mode == mmap_vector_mode::create)
+            flags |= O_CREAT | O_TRUNC;
+        const int fd = ::open(path, flags | O_CLOEXEC, 0644);
+        THROW_RUNTIME_ERROR_IF(fd == -1, "mmap_vector<T>::open() can not open the file");
+
+        struct stat st;
+        if (::fstat(fd, &st) != 0)
+        {
+            ::close(fd);
+            THROW_RUNTIME_ERROR_IF(true, "mmap_vector<T>::open() fstat failed");
+        }
+        size_t len = static_cast<size_t>(st.st_size);
+        const bool fresh = len == 0;
+        if (fresh)
+        {
+            // 新文件，写入文件头
+            if (mode == mmap_vector_mode::read_only || ::ftruncate(fd, static_cast<off_t>(bytes_for(0))) != 0)
+            {
+                ::close(fd);
+                THROW_RUNTIME_ERROR_IF(true, "mmap_vector<T>::open() can not initialize the file");
+            }
+            len = bytes_for(0);
+        }
+        else if (len < header_bytes)
+        {
+            ::close(fd);
+            THROW_RUNTIME_ERROR_IF(true, "mmap_vector<T>::open() the file is too small");
+        }
+
+        const int prot = mode == mmap_vector_mode::read_only ? PROT_READ : PROT_READ | PROT_WRITE;
+        void* p = ::mmap(nullptr, len, prot, MAP_SHARED, fd, 0);
+        if (p == MAP_FAILED)
+        {
+            ::close(fd);
+            THROW_RUNTIME_ERROR_IF(true, "mmap_vector<T>::open() mmap failed");
+        }
+        fd_ = fd;
+        map_ = static_cast<char*>(p);
+        map_len_ = len;
+        cap_ = (len - header_bytes) / sizeof(T);
+        read_only_ = mode == mmap_vector_mode::read_only;
+
+        mmap_vector_header* h = header();
+        if (fresh)
+        {
+            h->magic = mmap_vector_header::file_magic;
+            h->version = mmap_vector_header::file_version;
+            h->elem_size = static_cast<uint32_t>(sizeof(T));
+            h->elem_align = static_cast<uint32_t>(alignof(T));
+            h->size = 0;
+            return;
+        }
+        // 已有的文件只检查文件头，元素直接使用
+        if (h->magic != mmap_vector_header::file_magic || h->version != mmap_vector_header::file_version ||
+            h->elem_size != sizeof(T) || h->elem_align != alignof(T) || h->size > cap_)
+        {
+            close();
+            THROW_RUNTIME_ERROR_IF(true, "mmap_vector<T>::open() the file does not match mmap_vector<T>");
+        }
+    }
+
+    template <class T, class Growth>
+    void mmap_vector<T, Growth>::close() noexcept
+    {
+        if (map_ != nullptr)
+            ::munmap(map_, map_len_);
+        if (fd_ != -1)
+            ::close(fd_);
+        reset_members();
+    }
+
+    template <class T, class Growth>
+    void mmap_vector<T, Growth>::remap(size_t len)
+    {
+        THROW_RUNTIME_ERROR_IF(!is_open(), "mmap_vector<T> is not open");
+        check_writable();
+        if (len == map_len_)
+            return;
+        // 缩小时先解除多余的映射再截短文件，扩大时先扩大文件再映射
+        if (len > map_len_)
+            THROW_RUNTIME_ERROR_IF(::ftruncate(fd_, static_cast<off_t>(len)) != 0,
+                                   "mmap_vector<T> ftruncate failed");
+#if defined(__linux__)
+        void* p = ::mremap(map_, map_len_, len, MREMAP_MAYMOVE);
+        if (p == MAP_FAILED)
+        {
+            // 恢复原来的文件大小
+            THROW_RUNTIME_ERROR_IF(len > map_len_ && ::ftruncate(fd_, static_cast<off_t>(map_len_)) != 0,
+                                   "mmap_vector<T> mremap failed and the file size can not be restored");
+            THROW_RUNTIME_ERROR_IF(true, "mmap_vector<T> mremap failed");
+        }
+#else
+        void* p = ::mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (p == MAP_FAILED)
+        {
+            THROW_RUNTIME_ERROR_IF(len > map_len_ && ::ftruncate(fd_, static_cast<off_t>(map_len_)) != 0,
+                                   "mmap_vector<T> mmap failed and the file size can not be restored");
+            THROW_RUNTIME_ERROR_IF(true, "mmap_vector<T> mmap failed");
+        }
+        ::munmap(map_, map_len_);
+#endif
+        const bool shrink = len < map_len_;
+        map_ = static_cast<char*>(p);
+        map_len_ = len;
+        cap_ = (len - header_bytes) / sizeof(T);
+        // 映射已经缩小，截短失败时文件仍然保持原来的大小，可以再次调用shrink_to_fit
+        THROW_RUNTIME_ERROR_IF(shrink && ::ftruncate(fd_, static_cast<off_t>(len)) != 0,
+                               "mmap_vector<T> ftruncate failed while shrinking the file");
+    }
+
+    template <class T, class Growth>
+    void mmap_vector<T, Growth>::reserve(size_type n)
+    {
+        if (n <= cap_)
+            return;
+        THROW_LENGTH_ERROR_IF(n > max_size(), "n can not larger than max_size() in mmap_vector<T>::reserve(n)");
+        remap(bytes_for(n));
+    }
+
+    template <class T, class Growth>
+    void mmap_vector<T, Growth>::shrink_to_fit()
+    {
+        if (is_open() && !read_only_)
+            remap(bytes_for(size()));
+    }
+
+    template <class T, class Growth>
+    typename mmap_vector<T, Growth>::iterator
+    mmap_vector<T, Growth>::insert(const_iterator pos, size_type n, const value_type& value)
+    {
+        check_writable();
+        const size_type xpos = pos - begin();
+        if (n == 0)
+            return begin() + xpos;
+        // value 可能是容器中的元素，扩容之后会失效
+        const value_type value_copy = value;
+        reserve_extra(n);
+        pointer p = begin() + xpos;
+        std::memmove(static_cast<void*>(p + n), p, (size() - xpos) * sizeof(T));
+        for (size_type i = 0; i < n; ++i)
+            std::memcpy(static_cast<void*>(p + i), &value_copy, sizeof(T));
+        header()->size += n;
+        return p;
+    }
+
+    template <class T, class Growth>
+    typename mmap_vector<T, Growth>::iterator
+    mmap_vector<T, Growth>::erase(const_iterator first, const_iterator last)
+    {
+        DW_STL_DEBUG(first >= begin() && last <= end() && !(last < first));
+        check_writable();
+        pointer p = begin() + (first - begin());
+        std::memmove(static_cast<void*>(p), last, (end() - last) * sizeof(T));
+        header()->size -= static_cast<size_type>(last - first);
+        return p;
+    }
+
+    /****************************************************************************/
+    // 重载比较操作符
+    template <class T, class Growth>
+    bool operator==(const mmap_vector<T, Growth>& lhs, const mmap_vector<T, Growth>& rhs)
+    {
+        return lhs.size() == rhs.size() &&
+            dw_stl::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+
+    template <class T, class Growth>
+    bool operator!=(const mmap_vector<T, Growth>& lhs, const mmap_vector<T, Growth>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    // 重载dw_stl的swap
+    template <class T, class Growth>
+    void swap(mmap_vector<T, Growth>& lhs, mmap_vector<T, Growth>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+}
+
+#endif
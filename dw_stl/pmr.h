@@ -0,0 +1,28 @@
+#ifndef DW_STL_PMR_H_
+#define DW_STL_PMR_H_
+
+// 这个头文件为容器定义了使用 polymorphic_allocator 的别名，位于命名空间 dw_stl::pmr 中
+// 例如 dw_stl::pmr::vector<int> 就是 dw_stl::vector<int, dw_stl::pmr::polymorphic_allocator<int>>
+
+#include "memory_resource.h"
+#include "vector.h"
+#include "deque.h"
+#include "queue.h"
+#include "functional.h"
+
+namespace dw_stl
+{
+namespace pmr
+{
+    template <class T>
+    using vector = dw_stl::vector<T, polymorphic_allocator<T>>;
+
+    template <class T>
+    using deque = dw_stl::deque<T, polymorphic_allocator<T>>;
+
+    template <class T, class Compare = dw_stl::less<T>>
+    using priority_queue = dw_stl::priority_queue<T, pmr::vector<T>, Compare>;
+}
+}
+
+#endif
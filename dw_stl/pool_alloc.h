@@ -0,0 +1,376 @@
+#ifndef DW_STL_POOL_ALLOC_H_
+#define DW_STL_POOL_ALLOC_H_
+
+/*
+这个头文件实现了类似 SGI STL 的第二级空间配置器(内存池)
+小于等于 DW_STL_POOL_MAX_BYTES 的请求按照 DW_STL_POOL_ALIGN 字节对齐划分成若干个大小等级(size class)，
+每个等级维护一条自由链表(free list)：
+
+    线程缓存(thread_cache) : 每个线程各自的自由链表，分配和释放都不需要加锁
+    中心内存池(central_pool): 所有线程共享的自由链表和一块连续的内存(chunk)，需要加锁
+
+线程缓存为空时，一次性从中心内存池取 DW_STL_POOL_BATCH 个节点；线程缓存中某个等级的节点过多时，
+把一批节点还给中心内存池；线程退出时把缓存中的全部节点还给中心内存池
+超过 DW_STL_POOL_MAX_BYTES 的请求直接使用 ::operator new
+
+实现了以下内容：
+pool_alloc           : 按字节分配与释放的内存池
+pool_allocator<T>    : 使用内存池的分配器，可以作为容器的 Alloc 模板参数
+定义宏 DW_STL_USE_POOL_ALLOC 之后，dw_stl::allocator 的小块内存请求也会使用内存池
+*/
+
+#include <cstddef>
+#include <new>
+#include <mutex>
+
+#include "util.h"
+#include "aligned_alloc.h"
+
+namespace dw_stl
+{
+    // 小块内存的对齐字节数
+    #ifndef DW_STL_POOL_ALIGN
+    #define DW_STL_POOL_ALIGN 8
+    #endif
+
+    // 内存池负责的最大字节数
+    #ifndef DW_STL_POOL_MAX_BYTES
+    #define DW_STL_POOL_MAX_BYTES 128
+    #endif
+
+    // 线程缓存每次从中心内存池取得的节点数目
+    #ifndef DW_STL_POOL_BATCH
+    #define DW_STL_POOL_BATCH 20
+    #endif
+
+    // 线程缓存中每个等级最多保留的节点数目
+    #ifndef DW_STL_POOL_CACHE_LIMIT
+    #define DW_STL_POOL_CACHE_LIMIT 128
+    #endif
+
+    class pool_alloc
+    {
+    public:
+        static constexpr size_t align = DW_STL_POOL_ALIGN;
+        static constexpr size_t max_bytes = DW_STL_POOL_MAX_BYTES;
+        static constexpr size_t nfreelists = max_bytes / align;
+
+        static_assert(align >= sizeof(void*) && (align & (align - 1)) == 0,
+                      "DW_STL_POOL_ALIGN should be a power of 2 and not less than sizeof(void*)");
+        static_assert(max_bytes % align == 0, "DW_STL_POOL_MAX_BYTES should be a multiple of DW_STL_POOL_ALIGN");
+
+        // 分配与释放 bytes 个字节，释放时传入的 bytes 必须与分配时相同
+        static void* allocate(size_t bytes);
+        static void  deallocate(void* ptr, size_t bytes);
+
+        // 申请 bytes 个字节时实际得到的字节数，内存池中的请求按大小等级取整
+        static size_t good_size(size_t bytes) noexcept
+        { return bytes > max_bytes ? bytes : round_up(bytes); }
+
+    private:
+        // 自由链表的节点，未分配时用来保存下一个节点的地址
+        union obj
+        {
+            obj* next;
+            char data[1];
+        };
+
+        // 中心内存池，所有线程共享
+        struct central_pool
+        {
+            std::mutex mtx;
+            obj*       free_list[nfreelists];
+            char*      start_free;    // chunk 中未使用空间的头部
+            char*      end_free;      // chunk 中未使用空间的尾部
+            size_t     heap_size;     // 已经向系统申请的总字节数
+        };
+
+        // 线程缓存，线程退出时析构，把全部节点还给中心内存池
+        struct thread_cache
+        {
+            obj*   free_list[nfreelists];
+            size_t count[nfreelists];
+
+            thread_cache() noexcept
+            {
+                for (size_t i = 0; i < nfreelists; ++i)
+                {
+                    free_list[i] = nullptr;
+                    count[i] = 0;
+                }
+            }
+            ~thread_cache();
+        };
+
+    private:
+        // 将 bytes 上调到 align 的倍数
+        static size_t round_up(size_t bytes)
+        { return (bytes + align - 1) & ~(align - 1); }
+
+        // 根据字节数得到自由链表的下标
+        static size_t freelist_index(size_t bytes)
+        { return (bytes + align - 1) / align - 1; }
+
+        static central_pool& central();
+        static thread_cache& local();
+
+        static obj* refill(thread_cache& cache, size_t index);
+        static void release_batch(thread_cache& cache, size_t index, size_t n);
+        static char* chunk_alloc(central_pool& pool, size_t size, size_t& nobjs);
+    };
+
+    /*****************************************************************************************/
+
+    // 分配 bytes 个字节
+    inline void* pool_alloc::allocate(size_t bytes)
+    {
+        if (bytes > max_bytes)
+            return ::operator new(bytes);
+        if (bytes == 0)
+            bytes = 1;
+        thread_cache& cache = local();
+        const size_t index = freelist_index(bytes);
+        obj* result = cache.free_list[index];
+        if (result == nullptr)
+            return refill(cache, index);
+        cache.free_list[index] = result->next;
+        --cache.count[index];
+        return result;
+    }
+
+    // 释放 ptr 指向的 bytes 个字节，节点放回当前线程的缓存
+    inline void pool_alloc::deallocate(void* ptr, size_t bytes)
+    {
+        if (ptr == nullptr)
+            return;
+        if (bytes > max_bytes)
+        {
+            ::operator delete(ptr);
+            return;
+        }
+        if (bytes == 0)
+            bytes = 1;
+        thread_cache& cache = local();
+        const size_t index = freelist_index(bytes);
+        obj* node = static_cast<obj*>(ptr);
+        node->next = cache.free_list[index];
+        cache.free_list[index] = node;
+        // 缓存过多时归还一批节点，避免某个线程囤积内存
+        if (++cache.count[index] > DW_STL_POOL_CACHE_LIMIT)
+            release_batch(cache, index, DW_STL_POOL_BATCH);
+    }
+
+    // 中心内存池只创建一次并且不会析构，保证线程缓存析构时它仍然可用
+    inline pool_alloc::central_pool& pool_alloc::central()
+    {
+        static central_pool* pool = []
+        {
+            central_pool* p = new central_pool;
+            for (size_t i = 0; i < nfreelists; ++i)
+                p->free_list[i] = nullptr;
+            p->start_free = nullptr;
+            p->end_free = nullptr;
+            p->heap_size = 0;
+            return p;
+        }();
+        return *pool;
+    }
+
+    inline pool_alloc::thread_cache& pool_alloc::local()
+    {
+        static thread_local thread_cache cache;
+        return cache;
+    }
+
+    // 线程退出时把缓存中的节点全部还给中心内存池
+    inline pool_alloc::thread_cache::~thread_cache()
+    {
+        central_pool& pool = central();
+        std::lock_guard<std::mutex> lock(pool.mtx);
+        for (size_t i = 0; i < nfreelists; ++i)
+        {
+            while (free_list[i] != nullptr)
+            {
+                obj* node = free_list[i];
+                free_list[i] = node->next;
+                node->next = pool.free_list[i];
+                pool.free_list[i] = node;
+            }
+            count[i] = 0;
+        }
+    }
+
+    // refill 函数，线程缓存为空时从中心内存池取一批节点，返回其中一个，其余放入线程缓存
+    inline pool_alloc::obj* pool_alloc::refill(thread_cache& cache, size_t index)
+    {
+        const size_t size = (index + 1) * align;
+        central_pool& pool = central();
+        std::lock_guard<std::mutex> lock(pool.mtx);
+
+        // 优先使用中心自由链表上的节点
+        obj* result = pool.free_list[index];
+        if (result != nullptr)
+        {
+            obj* last = result;
+            size_t n = 1;
+            while (n < DW_STL_POOL_BATCH && last->next != nullptr)
+            {
+                last = last->next;
+                ++n;
+            }
+            pool.free_list[index] = last->next;
+            last->next = nullptr;
+            cache.free_list[index] = result->next;
+            cache.count[index] = n - 1;
+            return result;
+        }
+
+        // 中心自由链表为空，从 chunk 中切出一批节点
+        size_t nobjs = DW_STL_POOL_BATCH;
+        char* chunk = chunk_alloc(pool, size, nobjs);
+        result = reinterpret_cast<obj*>(chunk);
+        obj* cur = nullptr;
+        cache.free_list[index] = nullptr;
+        for (size_t i = nobjs - 1; i >= 1; --i)
+        {
+            cur = reinterpret_cast<obj*>(chunk + i * size);
+            cur->next = cache.free_list[index];
+            cache.free_list[index] = cur;
+        }
+        cache.count[index] = nobjs - 1;
+        return result;
+    }
+
+    // release_batch 函数，把线程缓存中某个等级的 n 个节点还给中心内存池
+    inline void pool_alloc::release_batch(thread_cache& cache, size_t index, size_t n)
+    {
+        obj* first = cache.free_list[index];
+        obj* last = first;
+        size_t k = 1;
+        while (k < n && last->next != nullptr)
+        {
+            last = last->next;
+            ++k;
+        }
+        cache.free_list[index] = last->next;
+        cache.count[index] -= k;
+
+        central_pool& pool = central();
+        std::lock_guard<std::mutex> lock(pool.mtx);
+        last->next = pool.free_list[index];
+        pool.free_list[index] = first;
+    }
+
+    // chunk_alloc 函数，从中心内存池的 chunk 中取出 nobjs 个大小为 size 的节点
+    // 空间不足时 nobjs 会被减小，调用时必须持有 pool.mtx
+    inline char* pool_alloc::chunk_alloc(central_pool& pool, size_t size, size_t& nobjs)
+    {
+        size_t need_bytes = size * nobjs;
+        size_t pool_bytes = static_cast<size_t>(pool.end_free - pool.start_free);
+        char* result = nullptr;
+
+        // 剩余空间满足全部需求
+        if (pool_bytes >= need_bytes)
+        {
+            result = pool.start_free;
+            pool.start_free += need_bytes;
+            return result;
+        }
+        // 剩余空间至少满足一个节点
+        if (pool_bytes >= size)
+        {
+            nobjs = pool_bytes / size;
+            need_bytes = size * nobjs;
+            result = pool.start_free;
+            pool.start_free += need_bytes;
+            return result;
+        }
+
+        // 剩余的零头放入对应的自由链表，再向系统申请新的 chunk
+        if (pool_bytes > 0)
+        {
+            obj* node = reinterpret_cast<obj*>(pool.start_free);
+            const size_t index = freelist_index(pool_bytes);
+            node->next = pool.free_list[index];
+            pool.free_list[index] = node;
+        }
+        const size_t get_bytes = (need_bytes << 1) + round_up(pool.heap_size >> 4);
+        pool.start_free = static_cast<char*>(::operator new(get_bytes));
+        pool.end_free = pool.start_free + get_bytes;
+        pool.heap_size += get_bytes;
+        return chunk_alloc(pool, size, nobjs);
+    }
+
+    /*****************************************************************************************/
+    // 模板类 pool_allocator
+    // 小块内存使用 pool_alloc，对齐要求超过 DW_STL_POOL_ALIGN 的类型使用 aligned_alloc
+    /*****************************************************************************************/
+    template <class T>
+    class pool_allocator
+    {
+    public:
+        typedef T           value_type;
+        typedef T*          pointer;
+        typedef const T*    const_pointer;
+        typedef size_t      size_type;
+        typedef ptrdiff_t   difference_type;
+
+        typedef std::true_type  propagate_on_container_move_assignment;
+        typedef std::true_type  is_always_equal;
+
+        template <class U>
+        struct rebind
+        {
+            typedef pool_allocator<U> other;
+        };
+
+        pool_allocator() noexcept = default;
+        template <class U>
+        pool_allocator(const pool_allocator<U>&) noexcept {}
+
+        // 能否使用内存池
+        static constexpr bool use_pool = alignof(T) <= DW_STL_POOL_ALIGN;
+
+        static T* allocate(size_type n)
+        {
+            if (n == 0)
+                return nullptr;
+            if (use_pool)
+                return static_cast<T*>(pool_alloc::allocate(n * sizeof(T)));
+            return static_cast<T*>(aligned_alloc::allocate(n * sizeof(T), alignof(T)));
+        }
+
+        static void deallocate(T* ptr, size_type n)
+        {
+            if (ptr == nullptr)
+                return;
+            if (use_pool)
+                pool_alloc::deallocate(ptr, n * sizeof(T));
+            else
+                aligned_alloc::deallocate(ptr, alignof(T));
+        }
+
+        // 分配至少n个单元，n改为所在大小等级可以放下的单元数，用这个n释放时仍然属于同一个大小等级
+        static T* allocate_at_least(size_type& n)
+        {
+            T* ptr = allocate(n);
+            if (use_pool && ptr != nullptr)
+                n = pool_alloc::good_size(n * sizeof(T)) / sizeof(T);
+            return ptr;
+        }
+    };
+
+    template <class T, class U>
+    bool operator==(const pool_allocator<T>&, const pool_allocator<U>&) noexcept
+    {
+        return true;
+    }
+
+    template <class T, class U>
+    bool operator!=(const pool_allocator<T>&, const pool_allocator<U>&) noexcept
+    {
+        return false;
+    }
+}
+
+#endif
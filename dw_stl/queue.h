@@ -11,6 +11,7 @@ priority_queue: 优先队列，使用堆来实现
 #include "vector.h"
 #include "functional.h"
 #include "heap_algo.h"
+#include "allocator_traits.h"
 
 namespace dw_stl
 {
@@ -55,6 +56,27 @@ namespace dw_stl
 
         queue(queue &&rhs) noexcept(std::is_nothrow_move_constructible<Sequence>::value)
             : c(dw_stl::move(rhs.c)) {}
+
+        // 带分配器的构造函数，分配器会被转发给底层容器
+        template <class Alloc, typename std::enable_if<
+            dw_stl::uses_allocator<Sequence, Alloc>::value, int>::type = 0>
+        explicit queue(const Alloc &alloc) : c(alloc) {}
+
+        template <class Alloc, typename std::enable_if<
+            dw_stl::uses_allocator<Sequence, Alloc>::value, int>::type = 0>
+        queue(const Sequence &c_, const Alloc &alloc) : c(c_, alloc) {}
+
+        template <class Alloc, typename std::enable_if<
+            dw_stl::uses_allocator<Sequence, Alloc>::value, int>::type = 0>
+        queue(Sequence &&c_, const Alloc &alloc) : c(dw_stl::move(c_), alloc) {}
+
+        template <class Alloc, typename std::enable_if<
+            dw_stl::uses_allocator<Sequence, Alloc>::value, int>::type = 0>
+        queue(const queue &rhs, const Alloc &alloc) : c(rhs.c, alloc) {}
+
+        template <class Alloc, typename std::enable_if<
+            dw_stl::uses_allocator<Sequence, Alloc>::value, int>::type = 0>
+        queue(queue &&rhs, const Alloc &alloc) : c(dw_stl::move(rhs.c), alloc) {}
         
         // 赋值构造函数
         queue& operator=(const queue &rhs)
@@ -197,6 +219,10 @@ namespace dw_stl
         lhs.swap(rhs);
     }
 
+    // 用于构造priority_queue的标记，表示传入的容器已经是按比较函数排好的堆，不再调用make_heap
+    struct heap_ordered_t {};
+    constexpr heap_ordered_t heap_ordered{};
+
     /*
     模板类priority_queue
     第一个参数代表数据类型
@@ -261,16 +287,47 @@ namespace dw_stl
             dw_stl::make_heap(c_.begin(), c_.end(), cmp_);
         }
 
+        // s已经是堆(例如从快照中读出的容器)，直接使用
+        priority_queue(heap_ordered_t, Container &&s, const Compare &c = Compare())
+            : c_(dw_stl::move(s)), cmp_(c) {}
+
         priority_queue(const priority_queue &rhs) : c_(rhs.c_), cmp_(rhs.cmp_)
         {
             dw_stl::make_heap(c_.begin(), c_.end(), cmp_);
         }
 
-        priority_queue(priority_queue &&rhs) : c_(dw_stl::move(rhs.c_), cmp_(rhs.cmp_))
+        priority_queue(priority_queue &&rhs) : c_(dw_stl::move(rhs.c_)), cmp_(rhs.cmp_)
         {
             dw_stl::make_heap(c_.begin(), c_.end(), cmp_);
         }
 
+        // 带分配器的构造函数，分配器会被转发给底层容器
+        template <class Alloc, typename std::enable_if<
+            dw_stl::uses_allocator<Container, Alloc>::value, int>::type = 0>
+        explicit priority_queue(const Alloc &alloc) : c_(alloc), cmp_() {}
+
+        template <class Alloc, typename std::enable_if<
+            dw_stl::uses_allocator<Container, Alloc>::value, int>::type = 0>
+        priority_queue(const Compare &c, const Alloc &alloc) : c_(alloc), cmp_(c) {}
+
+        template <class Alloc, typename std::enable_if<
+            dw_stl::uses_allocator<Container, Alloc>::value, int>::type = 0>
+        priority_queue(const Compare &c, const Container &s, const Alloc &alloc)
+            : c_(s, alloc), cmp_(c)
+        {
+            dw_stl::make_heap(c_.begin(), c_.end(), cmp_);
+        }
+
+        template <class Alloc, typename std::enable_if<
+            dw_stl::uses_allocator<Container, Alloc>::value, int>::type = 0>
+        priority_queue(const priority_queue &rhs, const Alloc &alloc)
+            : c_(rhs.c_, alloc), cmp_(rhs.cmp_) {}
+
+        template <class Alloc, typename std::enable_if<
+            dw_stl::uses_allocator<Container, Alloc>::value, int>::type = 0>
+        priority_queue(priority_queue &&rhs, const Alloc &alloc)
+            : c_(dw_stl::move(rhs.c_), alloc), cmp_(rhs.cmp_) {}
+
         // 赋值构造函数
         priority_queue &operator=(const priority_queue &rhs)
         {
@@ -305,6 +362,17 @@ namespace dw_stl
             return c_.front();
         }
 
+        // 按堆的顺序排列的底层容器，用于保存快照
+        const container_type& container() const noexcept
+        {
+            return c_;
+        }
+
+        value_compare value_comp() const
+        {
+            return cmp_;
+        }
+
         // 容量相关操作
         bool empty() const noexcept
         {
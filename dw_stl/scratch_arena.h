@@ -0,0 +1,270 @@
+#ifndef DW_STL_SCRATCH_ARENA_H_
+#define DW_STL_SCRATCH_ARENA_H_
+
+/*
+这个头文件实现了每个线程一个的临时内存区(scratch arena)，用于 get_temporary_buffer 与 temporary_buffer
+排序、归并等算法每一趟都要申请临时缓冲区，用完马上释放，申请与释放基本上是后进先出的顺序，
+因此用一整块可以增长的内存按栈的方式分配，释放之后留给下一次使用，稳定之后不再调用系统的分配函数
+
+    allocate 在内存区中按栈的方式分配，放不下时：
+        内存区中没有正在使用的空间，把内存区扩大(不超过上限)
+        否则直接向系统申请，并记下需要的大小，下一次内存区为空时一次扩大到位
+    超过上限 ceiling 的请求总是直接向系统申请
+    deallocate 可以按任意顺序调用，不在栈顶的空间先做标记，等到它上面的空间都释放后一起回收
+
+实现了以下内容：
+scratch_arena::local()              : 当前线程的内存区
+scratch_arena::allocate(bytes, alignment) / deallocate(ptr, alignment)
+scratch_arena::set_ceiling(bytes)   : 修改内存区大小的上限，默认为 DW_STL_SCRATCH_ARENA_CEILING
+scratch_arena::stats() / dump(out)  : 统计数据，包括内存区占用的峰值(high water mark)以及直接向系统申请的次数
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <new>
+
+#include "aligned_alloc.h"
+
+namespace dw_stl
+{
+    // 每个线程的内存区大小的上限
+    #ifndef DW_STL_SCRATCH_ARENA_CEILING
+    #define DW_STL_SCRATCH_ARENA_CEILING (8 * 1024 * 1024)
+    #endif
+
+    class scratch_arena
+    {
+    public:
+        struct stats_type
+        {
+            size_t capacity;        // 内存区当前的大小
+            size_t in_use;          // 内存区当前占用的字节数
+            size_t high_water;      // 内存区占用的峰值
+            size_t peak_request;    // 单次请求的最大字节数
+            size_t arena_allocs;    // 在内存区中完成的分配次数
+            size_t heap_allocs;     // 直接向系统申请的次数
+            size_t grows;           // 内存区扩大的次数
+        };
+
+        // 内存区的对齐字节数
+        static constexpr size_t block_align = DW_STL_CACHELINE_SIZE;
+
+        scratch_arena() noexcept
+            : block_(nullptr), cap_(0), top_(0), last_(npos), want_(0),
+              ceiling_(DW_STL_SCRATCH_ARENA_CEILING), stats_()
+        {
+        }
+
+        ~scratch_arena()
+        {
+            aligned_alloc::deallocate(block_, block_align);
+        }
+
+        scratch_arena(const scratch_arena&) = delete;
+        scratch_arena& operator=(const scratch_arena&) = delete;
+
+        // 当前线程的内存区，线程结束时释放
+        static scratch_arena& local() noexcept
+        {
+            static thread_local scratch_arena arena;
+            return arena;
+        }
+
+        // alignment 必须是 2 的幂，失败时返回 nullptr
+        void* allocate(size_t bytes, size_t alignment) noexcept;
+        void  deallocate(void* ptr, size_t alignment) noexcept;
+
+        bool owns(const void* ptr) const noexcept
+        {
+            const char* p = static_cast<const char*>(ptr);
+            return block_ != nullptr && p >= block_ && p < block_ + cap_;
+        }
+
+        bool empty() const noexcept { return last_ == npos; }
+
+        size_t ceiling() const noexcept { return ceiling_; }
+
+        // 修改上限，内存区为空并且超过新的上限时立即释放
+        void set_ceiling(size_t bytes) noexcept
+        {
+            ceiling_ = bytes;
+            if (want_ > ceiling_)
+                want_ = ceiling_;
+            if (cap_ > ceiling_)
+                release_memory();
+        }
+
+        // 内存区为空时把它还给系统
+        void release_memory() noexcept
+        {
+            if (!empty())
+                return;
+            aligned_alloc::deallocate(block_, block_align);
+            block_ = nullptr;
+            cap_ = 0;
+            stats_.capacity = 0;
+        }
+
+        const stats_type& stats() const noexcept { return stats_; }
+
+        // 清空计数，峰值从当前占用重新开始
+        void reset_stats() noexcept
+        {
+            stats_.high_water = top_;
+            stats_.peak_request = 0;
+            stats_.arena_allocs = 0;
+            stats_.heap_allocs = 0;
+            stats_.grows = 0;
+        }
+
+        void dump(std::FILE* out) const
+        {
+            std::fprintf(out, "[scratch_arena] capacity=%zu in_use=%zu high_water=%zu peak_request=%zu "
+                         "arena_allocs=%zu heap_allocs=%zu grows=%zu ceiling=%zu\n",
+                         stats_.capacity, stats_.in_use, stats_.high_water, stats_.peak_request,
+                         stats_.arena_allocs, stats_.heap_allocs, stats_.grows, ceiling_);
+        }
+
+    private:
+        // 每次分配前面的记录，用于按栈的方式回收
+        struct header
+        {
+            size_t prev_top;    // 分配之前的栈顶
+            size_t prev_last;   // 上一次分配的记录的位置
+            size_t freed;       // 是否已经释放
+        };
+
+        static constexpr size_t npos = static_cast<size_t>(-1);
+
+        header* header_at(size_t offset) const noexcept
+        { return reinterpret_cast<header*>(block_ + offset); }
+
+        // 在内存区中分配，放不下时返回 nullptr
+        void* bump(size_t bytes, size_t alignment) noexcept
+        {
+            const uintptr_t base = reinterpret_cast<uintptr_t>(block_);
+            uintptr_t addr = base + top_ + sizeof(header);
+            addr = (addr + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+            const size_t end = static_cast<size_t>(addr - base);
+            if (end > cap_ || bytes > cap_ - end)
+                return nullptr;
+            const size_t hdr = end - sizeof(header);
+            header* h = header_at(hdr);
+            h->prev_top = top_;
+            h->prev_last = last_;
+            h->freed = 0;
+            top_ = end + bytes;
+            last_ = hdr;
+            ++stats_.arena_allocs;
+            stats_.in_use = top_;
+            if (top_ > stats_.high_water)
+                stats_.high_water = top_;
+            return reinterpret_cast<void*>(addr);
+        }
+
+        // 内存区为空时把它扩大到 new_cap 个字节
+        bool grow(size_t new_cap) noexcept
+        {
+            void* p = nullptr;
+            try
+            {
+                p = aligned_alloc::allocate(new_cap, block_align);
+            }
+            catch (...)
+            {
+                return false;
+            }
+            aligned_alloc::deallocate(block_, block_align);
+            block_ = static_cast<char*>(p);
+            cap_ = new_cap;
+            ++stats_.grows;
+            stats_.capacity = cap_;
+            return true;
+        }
+
+        static void* heap_allocate(size_t bytes, size_t alignment) noexcept
+        {
+            try
+            {
+                return aligned_alloc::allocate(bytes, alignment);
+            }
+            catch (...)
+            {
+                return nullptr;
+            }
+        }
+
+    private:
+        char*       block_;     // 内存区
+        size_t      cap_;       // 内存区的字节数
+        size_t      top_;       // 栈顶
+        size_t      last_;      // 最后一次分配的记录的位置，npos 表示内存区为空
+        size_t      want_;      // 需要的大小，内存区为空时按它扩大
+        size_t      ceiling_;   // 内存区大小的上限
+        stats_type  stats_;
+    };
+
+    inline void* scratch_arena::allocate(size_t bytes, size_t alignment) noexcept
+    {
+        if (alignment < alignof(header))
+            alignment = alignof(header);
+        if (bytes > stats_.peak_request)
+            stats_.peak_request = bytes;
+        // 最坏情况下需要的字节数
+        const size_t need = bytes + sizeof(header) + alignment - 1;
+        if (need < bytes || need > ceiling_)
+        {
+            ++stats_.heap_allocs;
+            return heap_allocate(bytes, alignment);
+        }
+        if (empty())
+        {
+            // 没有正在使用的空间，按需要的大小、记下的大小以及两倍的当前大小中最大的一个扩大
+            size_t new_cap = cap_ * 2;
+            if (new_cap < need)
+                new_cap = need;
+            if (new_cap < want_)
+                new_cap = want_;
+            if (new_cap > ceiling_)
+                new_cap = ceiling_;
+            if (need > cap_ || want_ > cap_)
+                grow(new_cap);
+        }
+        if (block_ != nullptr)
+        {
+            void* p = bump(bytes, alignment);
+            if (p != nullptr)
+                return p;
+        }
+        // 内存区中有正在使用的空间，记下一共需要的大小
+        if (!empty() && top_ + need > want_)
+            want_ = top_ + need > ceiling_ ? ceiling_ : top_ + need;
+        ++stats_.heap_allocs;
+        return heap_allocate(bytes, alignment);
+    }
+
+    inline void scratch_arena::deallocate(void* ptr, size_t alignment) noexcept
+    {
+        if (ptr == nullptr)
+            return;
+        if (!owns(ptr))
+        {
+            if (alignment < alignof(header))
+                alignment = alignof(header);
+            aligned_alloc::deallocate(ptr, alignment);
+            return;
+        }
+        reinterpret_cast<header*>(static_cast<char*>(ptr) - sizeof(header))->freed = 1;
+        // 回收栈顶所有已经释放的空间
+        while (last_ != npos && header_at(last_)->freed)
+        {
+            const header* h = header_at(last_);
+            top_ = h->prev_top;
+            last_ = h->prev_last;
+        }
+        stats_.in_use = top_;
+    }
+}
+
+#endif
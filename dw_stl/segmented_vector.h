@@ -0,0 +1,792 @@
+#ifndef DW_STL_SEGMENTED_VECTOR_H_
+#define DW_STL_SEGMENTED_VECTOR_H_
+
+/*
+这个头文件用于实现模板类 segmented_vector<T>
+
+vector 扩容时要把全部元素迁移到新的空间，指针全部失效，并且一次 push_back 的耗时与元素个数成正比，
+segmented_vector 把元素保存在大小为 2 的幂的若干段(chunk)中，空间不足时只分配新的一段，已有的元素从不移动：
+    第 k 段可以保存 B << k 个元素，B = 2^S 为第一段的大小(约 DW_STL_SEGMENTED_VECTOR_INIT_BYTES 字节)，
+    前 k 段一共可以保存 B * (2^k - 1) 个元素，因此第 i 个元素所在的段与偏移只需要一次 clz 就可以算出，operator[] 为 O(1)
+    push_back/emplace_back 不迁移任何元素，最坏情况下只多一次分配，元素的指针与引用在 pop_back 删除它之前一直有效
+    段的指针保存在第一次分配时申请的固定大小的数组中，这个数组也从不重新分配，因此 swap 与移动之后迭代器仍然有效
+    每一段内部是连续的，segment_data(k)/segment_size(k) 与 for_each_segment(f) 可以把每一段交给需要连续内存的算法
+    与 vector 按 2 倍扩容时相同，最后一段最多有一半的空间没有使用
+
+迭代器是随机访问迭代器，与 deque 的迭代器类似，在段内移动时只修改指针，跨过段的边界时重新计算所在的段
+
+异常保证：
+    dw_stl::segmented_vector<T> 满足基本异常保证，并对以下函数做强异常安全保证：
+        emplace_back
+        push_back
+*/
+
+#include <initializer_list>
+
+#include "iterator.h"
+#include "util.h"
+#include "exceptdef.h"
+#include "allocator.h"
+#include "allocator_traits.h"
+#include "algorithm.h"
+#include "uninitialized.h"
+
+namespace dw_stl
+{
+    // segmented_vector第一段的大致字节数
+    #ifndef DW_STL_SEGMENTED_VECTOR_INIT_BYTES
+    #define DW_STL_SEGMENTED_VECTOR_INIT_BYTES 256
+    #endif
+
+    /*****************************************************************************************/
+    // segment_layout
+    // 第一段大小为 2^S 时各段的位置：第 k 段从第 B * (2^k - 1) 个元素开始，可以保存 B << k 个元素
+    /*****************************************************************************************/
+    template <class T>
+    struct segment_layout
+    {
+        // 不小于 n 的 2 的幂的指数
+        static constexpr size_t ceil_log2(size_t n, size_t s = 0)
+        { return (size_t(1) << s) >= n ? s : ceil_log2(n, s + 1); }
+
+        static constexpr size_t shift = ceil_log2(sizeof(T) < DW_STL_SEGMENTED_VECTOR_INIT_BYTES
+                                                  ? DW_STL_SEGMENTED_VECTOR_INIT_BYTES / sizeof(T) : 1);
+        static constexpr size_t first_size = size_t(1) << shift;
+        // 段数的上限，最后一段的大小为 2^(位数 - 1)，实际上不会分配到
+        static constexpr size_t max_segments = sizeof(size_t) * 8 - shift;
+
+        static size_t segment_size(size_t k) noexcept
+        { return first_size << k; }
+
+        static size_t segment_start(size_t k) noexcept
+        { return (first_size << k) - first_size; }
+
+        // 最高位 1 的位置，x 不能为零
+        static size_t floor_log2(size_t x) noexcept
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return sizeof(unsigned long long) * 8 - 1 - static_cast<size_t>(__builtin_clzll(x));
+#else
+            size_t n = 0;
+            while (x >>= 1)
+                ++n;
+            return n;
+#endif
+        }
+
+        // 第 i 个元素所在的段 k 以及在段内的偏移 off
+        static void locate(size_t i, size_t& k, size_t& off) noexcept
+        {
+            const size_t j = i + first_size;
+            const size_t h = floor_log2(j);
+            k = h - shift;
+            off = j - (size_t(1) << h);
+        }
+
+        // 保存 n 个元素需要的段数
+        static size_t segments_for(size_t n) noexcept
+        {
+            if (n == 0)
+                return 0;
+            size_t k, off;
+            locate(n - 1, k, off);
+            return k + 1;
+        }
+    };
+
+    /*****************************************************************************************/
+    // segmented_vector 的迭代器
+    // map 为段的指针数组，index 为元素的下标，cur/first/last 为当前段内的位置，
+    // 所在的段还没有分配时(例如 end() 正好落在段的边界上) cur、first、last 都为 nullptr
+    /*****************************************************************************************/
+    template <class T, class Ref, class Ptr>
+    struct segmented_vector_iterator : public iterator<random_access_iterator_tag, T>
+    {
+        typedef segmented_vector_iterator<T, T&, T*>             iterator;
+        typedef segmented_vector_iterator<T, const T&, const T*> const_iterator;
+        typedef segmented_vector_iterator                        self;
+        typedef segment_layout<T>                                layout;
+
+        typedef T            value_type;
+        typedef Ptr          pointer;
+        typedef Ref          reference;
+        typedef size_t       size_type;
+        typedef ptrdiff_t    difference_type;
+        typedef T*           value_pointer;
+        typedef T* const*    map_pointer;
+
+        // 迭代器所含成员数据
+        value_pointer cur;      // 当前元素
+        value_pointer first;    // 所在段的头部
+        value_pointer last;     // 所在段的尾部
+        map_pointer   map;      // 段的指针数组
+        size_type     index;    // 元素的下标
+
+        segmented_vector_iterator() noexcept
+            :cur(nullptr), first(nullptr), last(nullptr), map(nullptr), index(0) {}
+
+        segmented_vector_iterator(map_pointer m, size_type i) noexcept
+            :map(m)
+        { set_index(i); }
+
+        segmented_vector_iterator(const iterator& rhs) noexcept
+            :cur(rhs.cur), first(rhs.first), last(rhs.last), map(rhs.map), index(rhs.index) {}
+
+        // 转到第 i 个元素
+        void set_index(size_type i) noexcept
+        {
+            index = i;
+            size_type k, off;
+            layout::locate(i, k, off);
+            first = map == nullptr ? nullptr : map[k];
+            if (first == nullptr)
+            {
+                cur = last = nullptr;
+                return;
+            }
+            cur = first + off;
+            last = first + layout::segment_size(k);
+        }
+
+        // 重载运算符
+        reference operator*()  const { return *cur; }
+        pointer   operator->() const { return cur; }
+
+        difference_type operator-(const self& x) const noexcept
+        { return static_cast<difference_type>(index) - static_cast<difference_type>(x.index); }
+
+        self& operator++() noexcept
+        {
+            ++index;
+            if (++cur == last)
+                set_index(index);
+            return *this;
+        }
+        self operator++(int) noexcept
+        {
+            self tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        self& operator--() noexcept
+        {
+            if (cur == first)
+                set_index(index - 1);
+            else
+            {
+                --cur;
+                --index;
+            }
+            return *this;
+        }
+        self operator--(int) noexcept
+        {
+            self tmp = *this;
+            --*this;
+            return tmp;
+        }
+
+        self& operator+=(difference_type n) noexcept
+        {
+            const difference_type offset = n + (cur - first);
+            if (first != nullptr && offset >= 0 && offset < last - first)
+            {
+                cur += n;
+                index += n;
+            }
+            else
+                set_index(index + n);
+            return *this;
+        }
+        self operator+(difference_type n) const noexcept
+        {
+            self tmp = *this;
+            return tmp += n;
+        }
+        self& operator-=(difference_type n) noexcept
+        { return *this += -n; }
+        self operator-(difference_type n) const noexcept
+        {
+            self tmp = *this;
+            return tmp -= n;
+        }
+
+        reference operator[](difference_type n) const { return *(*this + n); }
+
+        // 重载比较操作符
+        bool operator==(const self& rhs) const noexcept { return index == rhs.index; }
+        bool operator< (const self& rhs) const noexcept { return index < rhs.index; }
+        bool operator!=(const self& rhs) const noexcept { return !(*this == rhs); }
+        bool operator> (const self& rhs) const noexcept { return rhs < *this; }
+        bool operator<=(const self& rhs) const noexcept { return !(rhs < *this); }
+        bool operator>=(const self& rhs) const noexcept { return !(*this < rhs); }
+    };
+
+    // 模板类segmented_vector
+    // 模板参数T代表数据类型，Alloc代表分配器类型，默认使用dw_stl::allocator<T>
+    // 段的指针数组使用由Alloc rebind得到的分配器分配
+    template <class T, class Alloc = dw_stl::allocator<T>>
+    class segmented_vector : private dw_stl::allocator_holder<Alloc>
+    {
+        static_assert(std::is_same<T, typename Alloc::value_type>::value,
+                      "The value_type of Alloc should be same with T");
+    public:
+        typedef Alloc                                                  allocator_type;
+        typedef dw_stl::allocator_traits<Alloc>                        alloc_traits;
+        typedef typename alloc_traits::template rebind_map_alloc<T*>   map_allocator;
+        typedef dw_stl::allocator_traits<map_allocator>                map_traits;
+        typedef segment_layout<T>                                      layout;
+
+        typedef T                                        value_type;
+        typedef T*                                       pointer;
+        typedef const T*                                 const_pointer;
+        typedef T&                                       reference;
+        typedef const T&                                 const_reference;
+        typedef typename alloc_traits::size_type         size_type;
+        typedef typename alloc_traits::difference_type   difference_type;
+        typedef pointer*                                 map_pointer;
+
+        typedef segmented_vector_iterator<T, T&, T*>             iterator;
+        typedef segmented_vector_iterator<T, const T&, const T*> const_iterator;
+        typedef dw_stl::reverse_iterator<iterator>               reverse_iterator;
+        typedef dw_stl::reverse_iterator<const_iterator>         const_reverse_iterator;
+
+        allocator_type get_allocator() const { return this->alloc(); }
+
+    private:
+        typedef dw_stl::allocator_holder<Alloc> holder_base;
+
+        map_pointer map_;       // 段的指针数组，长度为 layout::max_segments，没有分配的段为 nullptr
+        size_type   segments_;  // 已经分配的段数
+        size_type   size_;      // 元素个数
+
+    public:
+        // 构造、复制、移动、析构函数
+        segmented_vector() noexcept
+            : map_(nullptr), segments_(0), size_(0) {}
+
+        explicit segmented_vector(const allocator_type& alloc) noexcept
+            : holder_base(alloc), map_(nullptr), segments_(0), size_(0) {}
+
+        explicit segmented_vector(size_type n, const allocator_type& alloc = allocator_type())
+            : holder_base(alloc), map_(nullptr), segments_(0), size_(0)
+        {
+            try
+            {
+                resize(n);
+            }
+            catch (...)
+            {
+                release();
+                throw;
+            }
+        }
+
+        segmented_vector(size_type n, const value_type& value, const allocator_type& alloc = allocator_type())
+            : holder_base(alloc), map_(nullptr), segments_(0), size_(0)
+        {
+            try
+            {
+                resize(n, value);
+            }
+            catch (...)
+            {
+                release();
+                throw;
+            }
+        }
+
+        template <class Iter, typename std::enable_if<
+            dw_stl::is_input_iterator<Iter>::value, int>::type = 0>
+        segmented_vector(Iter first, Iter last, const allocator_type& alloc = allocator_type())
+            : holder_base(alloc), map_(nullptr), segments_(0), size_(0)
+        {
+            try
+            {
+                append_range(first, last);
+            }
+            catch (...)
+            {
+                release();
+                throw;
+            }
+        }
+
+        segmented_vector(std::initializer_list<value_type> ilist, const allocator_type& alloc = allocator_type())
+            : segmented_vector(ilist.begin(), ilist.end(), alloc) {}
+
+        segmented_vector(const segmented_vector& rhs)
+            : holder_base(alloc_traits::select_on_container_copy_construction(rhs.alloc())),
+              map_(nullptr), segments_(0), size_(0)
+        {
+            try
+            {
+                copy_from(rhs);
+            }
+            catch (...)
+            {
+                release();
+                throw;
+            }
+        }
+
+        segmented_vector(segmented_vector&& rhs) noexcept
+            : holder_base(dw_stl::move(rhs.alloc())),
+              map_(rhs.map_), segments_(rhs.segments_), size_(rhs.size_)
+        {
+            rhs.map_ = nullptr;
+            rhs.segments_ = 0;
+            rhs.size_ = 0;
+        }
+
+        segmented_vector& operator=(const segmented_vector& rhs);
+        // 分配器不传播且不总是相等时要用自己的分配器重新分配，不能保证不抛出异常
+        segmented_vector& operator=(segmented_vector&& rhs)
+            noexcept(alloc_traits::propagate_on_container_move_assignment::value ||
+                     alloc_traits::is_always_equal::value);
+
+        segmented_vector& operator=(std::initializer_list<value_type> ilist)
+        {
+            assign(ilist.begin(), ilist.end());
+            return *this;
+        }
+
+        ~segmented_vector()
+        { release(); }
+
+    public:
+        // 迭代器相关操作
+        iterator begin() noexcept
+        { return iterator(map_, 0); }
+        const_iterator begin() const noexcept
+        { return const_iterator(map_, 0); }
+        iterator end() noexcept
+        { return iterator(map_, size_); }
+        const_iterator end() const noexcept
+        { return const_iterator(map_, size_); }
+
+        reverse_iterator rbegin() noexcept
+        { return reverse_iterator(end()); }
+        const_reverse_iterator rbegin() const noexcept
+        { return const_reverse_iterator(end()); }
+        reverse_iterator rend() noexcept
+        { return reverse_iterator(begin()); }
+        const_reverse_iterator rend() const noexcept
+        { return const_reverse_iterator(begin()); }
+
+        const_iterator cbegin() const noexcept
+        { return begin(); }
+        const_iterator cend() const noexcept
+        { return end(); }
+        const_reverse_iterator crbegin() const noexcept
+        { return rbegin(); }
+        const_reverse_iterator crend() const noexcept
+        { return rend(); }
+
+        // 容量相关操作
+        bool empty() const noexcept
+        { return size_ == 0; }
+        size_type size() const noexcept
+        { return size_; }
+        size_type max_size() const noexcept
+        { return alloc_traits::max_size(this->alloc()); }
+        size_type capacity() const noexcept
+        { return layout::segment_start(segments_); }
+
+        // 分配足够的段，已有的元素不会移动
+        void reserve(size_type n);
+        // 释放没有元素的段
+        void shrink_to_fit() noexcept;
+
+        // 访问元素相关操作
+        reference operator[](size_type n)
+        {
+            DW_STL_DEBUG(n < size_);
+            size_type k, off;
+            layout::locate(n, k, off);
+            return map_[k][off];
+        }
+        const_reference operator[](size_type n) const
+        {
+            DW_STL_DEBUG(n < size_);
+            size_type k, off;
+            layout::locate(n, k, off);
+            return map_[k][off];
+        }
+
+        reference at(size_type n)
+        {
+            THROW_OUT_OF_RANGE_IF(!(n < size()), "segmented_vector<T>::at() subscript out of range");
+            return (*this)[n];
+        }
+        const_reference at(size_type n) const
+        {
+            THROW_OUT_OF_RANGE_IF(!(n < size()), "segmented_vector<T>::at() subscript out of range");
+            return (*this)[n];
+        }
+
+        reference front()
+        {
+            DW_STL_DEBUG(!empty());
+            return map_[0][0];
+        }
+        const_reference front() const
+        {
+            DW_STL_DEBUG(!empty());
+            return map_[0][0];
+        }
+        reference back()
+        {
+            DW_STL_DEBUG(!empty());
+            return (*this)[size_ - 1];
+        }
+        const_reference back() const
+        {
+            DW_STL_DEBUG(!empty());
+            return (*this)[size_ - 1];
+        }
+
+        // 按段访问，第 k 段中的元素是连续的，k < segment_count()
+        size_type segment_count() const noexcept
+        { return layout::segments_for(size_); }
+        pointer segment_data(size_type k) noexcept
+        { return map_[k]; }
+        const_pointer segment_data(size_type k) const noexcept
+        { return map_[k]; }
+        size_type segment_size(size_type k) const noexcept
+        {
+            const size_type start = layout::segment_start(k);
+            const size_type len = layout::segment_size(k);
+            return size_ - start < len ? size_ - start : len;
+        }
+
+        // 对每一段调用 f(first, last)
+        template <class F>
+        void for_each_segment(F f)
+        {
+            const size_type n = segment_count();
+            for (size_type k = 0; k < n; ++k)
+                f(map_[k], map_[k] + segment_size(k));
+        }
+        template <class F>
+        void for_each_segment(F f) const
+        {
+            const size_type n = segment_count();
+            for (size_type k = 0; k < n; ++k)
+                f(static_cast<const_pointer>(map_[k]), static_cast<const_pointer>(map_[k]) + segment_size(k));
+        }
+
+        // 修改容器相关操作
+        void assign(size_type n, const value_type& value)
+        {
+            clear();
+            resize(n, value);
+        }
+
+        template <class Iter, typename std::enable_if<
+            dw_stl::is_input_iterator<Iter>::value, int>::type = 0>
+        void assign(Iter first, Iter last)
+        {
+            clear();
+            append_range(first, last);
+        }
+
+        void assign(std::initializer_list<value_type> ilist)
+        { assign(ilist.begin(), ilist.end()); }
+
+        // 在尾部就地构造元素，不会移动已有的元素
+        template <class... Args>
+        reference emplace_back(Args&& ...args)
+        {
+            size_type k, off;
+            layout::locate(size_, k, off);
+            if (k == segments_)
+                add_segment();
+            pointer p = map_[k] + off;
+            alloc_traits::construct(this->alloc(), p, dw_stl::forward<Args>(args)...);
+            ++size_;
+            return *p;
+        }
+
+        void push_back(const value_type& value)
+        { emplace_back(value); }
+        void push_back(value_type&& value)
+        { emplace_back(dw_stl::move(value)); }
+
+        void pop_back()
+        {
+            DW_STL_DEBUG(!empty());
+            alloc_traits::destroy(this->alloc(), &back());
+            --size_;
+        }
+
+        // 在尾部追加一个区间，前向迭代器先按区间的长度分配需要的段
+        template <class Iter, typename std::enable_if<
+            dw_stl::is_input_iterator<Iter>::value, int>::type = 0>
+        void append_range(Iter first, Iter last)
+        {
+            append_dispatch(first, last, iterator_category(first));
+        }
+
+        template <class Range, typename std::enable_if<
+            dw_stl::is_range<Range>::value, int>::type = 0>
+        void append_range(const Range& r)
+        { append_range(r.begin(), r.end()); }
+
+        void resize(size_type new_size)
+        { resize(new_size, value_type()); }
+        void resize(size_type new_size, const value_type& value);
+
+        // 析构全部元素，已经分配的段保留
+        void clear() noexcept
+        { destroy_from(0); }
+
+        void swap(segmented_vector& rhs) noexcept;
+
+    private:
+        // 分配下一段，第一次分配时同时申请段的指针数组
+        void add_segment();
+        // 析构下标不小于 n 的元素
+        void destroy_from(size_type n) noexcept;
+        // 析构全部元素并释放全部的空间
+        void release() noexcept;
+        // 按段复制 rhs 的元素
+        void copy_from(const segmented_vector& rhs);
+
+        template <class InputIter>
+        void append_dispatch(InputIter first, InputIter last, input_iterator_tag)
+        {
+            for (; first != last; ++first)
+                emplace_back(*first);
+        }
+
+        template <class FIter>
+        void append_dispatch(FIter first, FIter last, forward_iterator_tag)
+        {
+            reserve(size_ + static_cast<size_type>(dw_stl::distance(first, last)));
+            for (; first != last; ++first)
+                emplace_back(*first);
+        }
+    };
+
+    /*****************************************************************************************/
+
+    // 复制赋值操作符
+    template <class T, class Alloc>
+    segmented_vector<T, Alloc>& segmented_vector<T, Alloc>::operator=(const segmented_vector& rhs)
+    {
+        if (this != &rhs)
+        {
+            // 分配器会被替换并且不相等时，已有的段只能由原来的分配器释放
+            if (alloc_traits::propagate_on_container_copy_assignment::value &&
+                !dw_stl::alloc_equal(this->alloc(), rhs.alloc()))
+                release();
+            dw_stl::alloc_on_copy(this->alloc(), rhs.alloc());
+            clear();
+            copy_from(rhs);
+        }
+        return *this;
+    }
+
+    // 移动赋值操作符，分配器不能传播并且不相等时逐个移动元素
+    template <class T, class Alloc>
+    segmented_vector<T, Alloc>& segmented_vector<T, Alloc>::operator=(segmented_vector&& rhs)
+        noexcept(alloc_traits::propagate_on_container_move_assignment::value ||
+                 alloc_traits::is_always_equal::value)
+    {
+        if (this == &rhs)
+            return *this;
+        if (alloc_traits::propagate_on_container_move_assignment::value ||
+            dw_stl::alloc_equal(this->alloc(), rhs.alloc()))
+        {
+            release();
+            dw_stl::alloc_on_move(this->alloc(), rhs.alloc());
+            map_ = rhs.map_;
+            segments_ = rhs.segments_;
+            size_ = rhs.size_;
+            rhs.map_ = nullptr;
+            rhs.segments_ = 0;
+            rhs.size_ = 0;
+        }
+        else
+        {
+            clear();
+            reserve(rhs.size_);
+            for (auto& value : rhs)
+                emplace_back(dw_stl::move(value));
+            rhs.clear();
+        }
+        return *this;
+    }
+
+    template <class T, class Alloc>
+    void segmented_vector<T, Alloc>::reserve(size_type n)
+    {
+        THROW_LENGTH_ERROR_IF(n > max_size(), "n can not larger than max_size() in segmented_vector<T>::reserve(n)");
+        const size_type need = layout::segments_for(n);
+        while (segments_ < need)
+            add_segment();
+    }
+
+    template <class T, class Alloc>
+    void segmented_vector<T, Alloc>::shrink_to_fit() noexcept
+    {
+        const size_type need = layout::segments_for(size_);
+        while (segments_ > need)
+        {
+            --segments_;
+            alloc_traits::deallocate(this->alloc(), map_[segments_], layout::segment_size(segments_));
+            map_[segments_] = nullptr;
+        }
+        if (segments_ == 0 && map_ != nullptr)
+        {
+            map_allocator ma(this->alloc());
+            map_traits::deallocate(ma, map_, layout::max_segments);
+            map_ = nullptr;
+        }
+    }
+
+    // 重载容器大小
+    template <class T, class Alloc>
+    void segmented_vector<T, Alloc>::resize(size_type new_size, const value_type& value)
+    {
+        if (new_size < size_)
+        {
+            destroy_from(new_size);
+            return;
+        }
+        reserve(new_size);
+        while (size_ < new_size)
+        {
+            // 每次填满一段中需要的部分
+            size_type k, off;
+            layout::locate(size_, k, off);
+            const size_type room = layout::segment_size(k) - off;
+            const size_type n = new_size - size_ < room ? new_size - size_ : room;
+            dw_stl::uninitialized_fill_n(map_[k] + off, n, value);
+            size_ += n;
+        }
+    }
+
+    template <class T, class Alloc>
+    void segmented_vector<T, Alloc>::swap(segmented_vector& rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            dw_stl::alloc_on_swap(this->alloc(), rhs.alloc());
+            dw_stl::swap(map_, rhs.map_);
+            dw_stl::swap(segments_, rhs.segments_);
+            dw_stl::swap(size_, rhs.size_);
+        }
+    }
+
+    /****************************************************************************/
+    // 下面是实现接口用到的一些辅助函数
+    /****************************************************************************/
+
+    template <class T, class Alloc>
+    void segmented_vector<T, Alloc>::add_segment()
+    {
+        THROW_LENGTH_ERROR_IF(segments_ >= layout::max_segments ||
+                              layout::segment_size(segments_) > max_size() - layout::segment_start(segments_),
+                              "segmented_vector<T> size too big");
+        if (map_ == nullptr)
+        {
+            map_allocator ma(this->alloc());
+            map_ = map_traits::allocate(ma, layout::max_segments);
+            for (size_type k = 0; k < layout::max_segments; ++k)
+                map_[k] = nullptr;
+        }
+        map_[segments_] = alloc_traits::allocate(this->alloc(), layout::segment_size(segments_));
+        ++segments_;
+    }
+
+    template <class T, class Alloc>
+    void segmented_vector<T, Alloc>::destroy_from(size_type n) noexcept
+    {
+        if (n >= size_)
+            return;
+        const size_type count = layout::segments_for(size_);
+        size_type k, off;
+        layout::locate(n, k, off);
+        for (; k < count; ++k, off = 0)
+            alloc_traits::destroy(this->alloc(), map_[k] + off, map_[k] + segment_size(k));
+        size_ = n;
+    }
+
+    template <class T, class Alloc>
+    void segmented_vector<T, Alloc>::release() noexcept
+    {
+        destroy_from(0);
+        shrink_to_fit();
+    }
+
+    // 调用前容器为空，两边相同编号的段大小相同，每一段整体复制
+    template <class T, class Alloc>
+    void segmented_vector<T, Alloc>::copy_from(const segmented_vector& rhs)
+    {
+        DW_STL_DEBUG(empty());
+        reserve(rhs.size_);
+        const size_type count = rhs.segment_count();
+        for (size_type k = 0; k < count; ++k)
+        {
+            const size_type len = rhs.segment_size(k);
+            dw_stl::uninitialized_copy(rhs.map_[k], rhs.map_[k] + len, map_[k]);
+            size_ += len;
+        }
+    }
+
+    /****************************************************************************/
+    // 重载比较操作符
+    template <class T, class Alloc>
+    bool operator==(const segmented_vector<T, Alloc>& lhs, const segmented_vector<T, Alloc>& rhs)
+    {
+        return lhs.size() == rhs.size() &&
+            dw_stl::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+
+    template <class T, class Alloc>
+    bool operator<(const segmented_vector<T, Alloc>& lhs, const segmented_vector<T, Alloc>& rhs)
+    {
+        return dw_stl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+
+    template <class T, class Alloc>
+    bool operator!=(const segmented_vector<T, Alloc>& lhs, const segmented_vector<T, Alloc>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    template <class T, class Alloc>
+    bool operator>(const segmented_vector<T, Alloc>& lhs, const segmented_vector<T, Alloc>& rhs)
+    {
+        return rhs < lhs;
+    }
+
+    template <class T, class Alloc>
+    bool operator<=(const segmented_vector<T, Alloc>& lhs, const segmented_vector<T, Alloc>& rhs)
+    {
+        return !(rhs < lhs);
+    }
+
+    template <class T, class Alloc>
+    bool operator>=(const segmented_vector<T, Alloc>& lhs, const segmented_vector<T, Alloc>& rhs)
+    {
+        return !(lhs < rhs);
+    }
+
+    // 重载dw_stl的swap
+    template <class T, class Alloc>
+    void swap(segmented_vector<T, Alloc>& lhs, segmented_vector<T, Alloc>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+
+    // segmented_vector只保存指针，可以按字节迁移
+    template <class T, class Alloc>
+    struct is_trivially_relocatable<segmented_vector<T, Alloc>>
+        : is_trivially_relocatable<Alloc> {};
+}
+
+#endif
@@ -0,0 +1,463 @@
+#ifndef DW_STL_SERIALIZE_H_
+#define DW_STL_SERIALIZE_H_
+
+/*
+这个头文件实现了 vector、deque、priority_queue 的二进制序列化，只适用于元素可以平凡复制的容器
+
+每个容器写成一条记录：64 字节的 serial_header，之后是元素的字节，补齐到 64 字节的整数倍，
+因此一个文件中可以依次保存多个容器，每条记录的元素都按 64 字节对齐，可以直接映射使用：
+    save 用 writev 一次写出文件头与元素，deque 按缓冲区逐块写出，不需要先复制成连续的数组
+    load 先读文件头并检查版本、元素大小与对齐，再用 resize_default_init 留出空间，
+        vector 用一次 read 读入全部元素，deque 用 readv 直接读入每个缓冲区
+    priority_queue 的快照按堆的顺序保存底层容器，读入之后直接作为堆使用，不再调用 make_heap
+    serialized_view<T> 用 mmap 只读映射文件中的一条记录，不复制元素
+
+文件描述符由调用者打开与关闭，save/load 从当前的文件位置开始，结束时位于下一条记录的开头；
+读写失败或者文件头不符时抛出 std::runtime_error，读入失败时容器被清空
+
+实现了以下内容：
+serial_header               : 每条记录的文件头
+save(fd, container)         : 写出 vector / deque / priority_queue
+load(fd, container)         : 读入 vector / deque / priority_queue
+serialized_view<T>          : 只读映射一条记录
+*/
+
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "vector.h"
+#include "deque.h"
+#include "queue.h"
+#include "exceptdef.h"
+
+namespace dw_stl
+{
+    // 记录的类型，priority_queue 的元素按堆的顺序排列
+    enum class serial_kind : uint32_t
+    {
+        vector = 1,
+        deque = 2,
+        priority_queue = 3
+    };
+
+    // 每条记录的文件头，占用 64 字节
+    struct serial_header
+    {
+        static constexpr uint64_t file_magic = 0x5245534c54535744ULL;   // "DWSTLSER"
+        static constexpr uint32_t file_version = 1;
+        static constexpr size_t   align = 64;                           // 记录与元素的对齐字节数
+
+        uint64_t magic;
+        uint32_t version;
+        uint32_t kind;          // serial_kind
+        uint32_t elem_size;     // sizeof(T)
+        uint32_t elem_align;    // alignof(T)
+        uint64_t count;         // 元素个数
+        uint64_t payload;       // 元素占用的字节数，补齐到 align 的整数倍
+        uint64_t reserved[3];
+    };
+
+    static_assert(sizeof(serial_header) == serial_header::align, "serial_header should be 64 bytes");
+
+    namespace serial_detail
+    {
+        #ifdef IOV_MAX
+        static constexpr int iov_max = IOV_MAX;
+        #else
+        static constexpr int iov_max = 1024;
+        #endif
+
+        inline size_t padded(size_t bytes) noexcept
+        { return (bytes + serial_header::align - 1) / serial_header::align * serial_header::align; }
+
+        template <class T>
+        serial_header make_header(serial_kind kind, size_t count) noexcept
+        {
+            serial_header h;
+            std::memset(&h, 0, sizeof(h));
+            h.magic = serial_header::file_magic;
+            h.version = serial_header::file_version;
+            h.kind = static_cast<uint32_t>(kind);
+            h.elem_size = static_cast<uint32_t>(sizeof(T));
+            h.elem_align = static_cast<uint32_t>(alignof(T));
+            h.count = count;
+            h.payload = padded(count * sizeof(T));
+            return h;
+        }
+
+        template <class T>
+        void check_header(const serial_header& h)
+        {
+            THROW_RUNTIME_ERROR_IF(h.magic != serial_header::file_magic, "dw_stl::load bad magic number");
+            THROW_RUNTIME_ERROR_IF(h.version != serial_header::file_version, "dw_stl::load unsupported version");
+            THROW_RUNTIME_ERROR_IF(h.elem_size != sizeof(T) || h.elem_align != alignof(T),
+                                   "dw_stl::load element type does not match");
+            // count * sizeof(T) 以及补齐之后都不能溢出，否则回绕后的 payload 可能通过下面的检查
+            THROW_RUNTIME_ERROR_IF(h.count > (SIZE_MAX - serial_header::align) / sizeof(T),
+                                   "dw_stl::load corrupted header");
+            THROW_RUNTIME_ERROR_IF(h.payload != padded(static_cast<size_t>(h.count) * sizeof(T)),
+                                   "dw_stl::load corrupted header");
+        }
+
+        // 写出全部的iov，处理部分写入以及超过IOV_MAX的情况
+        inline void writev_all(int fd, struct iovec* iov, int n)
+        {
+            while (n > 0)
+            {
+                const ssize_t w = ::writev(fd, iov, n < iov_max ? n : iov_max);
+                if (w < 0)
+                {
+                    THROW_RUNTIME_ERROR_IF(errno != EINTR, "dw_stl::save writev failed");
+                    continue;
+                }
+                size_t left = static_cast<size_t>(w);
+                while (n > 0 && left >= iov->iov_len)
+                {
+                    left -= iov->iov_len;
+                    ++iov;
+                    --n;
+                }
+                if (n > 0)
+                {
+                    iov->iov_base = static_cast<char*>(iov->iov_base) + left;
+                    iov->iov_len -= left;
+                }
+            }
+        }
+
+        // 读入全部的iov，文件提前结束时抛出异常
+        inline void readv_all(int fd, struct iovec* iov, int n)
+        {
+            while (n > 0)
+            {
+                const ssize_t r = ::readv(fd, iov, n < iov_max ? n : iov_max);
+                if (r < 0)
+                {
+                    THROW_RUNTIME_ERROR_IF(errno != EINTR, "dw_stl::load read failed");
+                    continue;
+                }
+                THROW_RUNTIME_ERROR_IF(r == 0, "dw_stl::load unexpected end of file");
+                size_t left = static_cast<size_t>(r);
+                while (n > 0 && left >= iov->iov_len)
+                {
+                    left -= iov->iov_len;
+                    ++iov;
+                    --n;
+                }
+                if (n > 0)
+                {
+                    iov->iov_base = static_cast<char*>(iov->iov_base) + left;
+                    iov->iov_len -= left;
+                }
+            }
+        }
+
+        inline void read_all(int fd, void* buf, size_t bytes)
+        {
+            struct iovec iov = { buf, bytes };
+            readv_all(fd, &iov, 1);
+        }
+
+        // 补齐用的零字节
+        inline const char* zero_padding() noexcept
+        {
+            static const char zeros[serial_header::align] = {};
+            return zeros;
+        }
+
+        inline struct iovec make_iov(const void* p, size_t bytes) noexcept
+        {
+            struct iovec iov;
+            iov.iov_base = const_cast<void*>(p);
+            iov.iov_len = bytes;
+            return iov;
+        }
+
+        // 写出一条记录，segs为元素所在的连续区间
+        template <class T>
+        void write_record(int fd, serial_kind kind, size_t count, vector<struct iovec>& segs)
+        {
+            const serial_header h = make_header<T>(kind, count);
+            const size_t pad = static_cast<size_t>(h.payload) - count * sizeof(T);
+            segs.insert(segs.begin(), make_iov(&h, sizeof(h)));
+            if (pad != 0)
+                segs.push_back(make_iov(zero_padding(), pad));
+            writev_all(fd, segs.data(), static_cast<int>(segs.size()));
+        }
+
+        // 元素所在的连续区间：vector只有一段，deque每个缓冲区一段
+        template <class T, class Alloc, class Growth>
+        void collect_segments(const vector<T, Alloc, Growth>& v, vector<struct iovec>& segs)
+        {
+            if (!v.empty())
+                segs.push_back(make_iov(v.data(), v.size() * sizeof(T)));
+        }
+
+        template <class T, class Alloc>
+        void collect_segments(const deque<T, Alloc>& d, vector<struct iovec>& segs)
+        {
+            auto first = d.begin();
+            const auto last = d.end();
+            while (first.node != last.node)
+            {
+                segs.push_back(make_iov(first.cur, (first.last - first.cur) * sizeof(T)));
+                first.set_node(first.node + 1);
+                first.cur = first.first;
+            }
+            if (first.cur != last.cur)
+                segs.push_back(make_iov(first.cur, (last.cur - first.cur) * sizeof(T)));
+        }
+
+        // 读入元素：先留出count个元素的空间，再直接读入容器的存储
+        template <class T, class Alloc, class Growth>
+        void read_payload(int fd, vector<T, Alloc, Growth>& v, size_t count)
+        {
+            v.clear();
+            v.resize_default_init(count);
+            if (count != 0)
+                read_all(fd, v.data(), count * sizeof(T));
+        }
+
+        // deque没有不初始化的resize，元素先值初始化一次
+        template <class T, class Alloc>
+        void read_payload(int fd, deque<T, Alloc>& d, size_t count)
+        {
+            d.clear();
+            d.resize(count);
+            vector<struct iovec> segs;
+            collect_segments(d, segs);
+            if (!segs.empty())
+                readv_all(fd, segs.data(), static_cast<int>(segs.size()));
+        }
+
+        // 读入一条记录，expect为nullptr时接受任意类型的记录
+        template <class T, class Container>
+        void read_record(int fd, Container& c, const serial_kind* expect)
+        {
+            static_assert(std::is_trivially_copyable<T>::value,
+                          "dw_stl::load requires a trivially copyable value_type");
+            serial_header h;
+            read_all(fd, &h, sizeof(h));
+            check_header<T>(h);
+            THROW_RUNTIME_ERROR_IF(expect != nullptr && h.kind != static_cast<uint32_t>(*expect),
+                                   "dw_stl::load record kind does not match");
+            try
+            {
+                read_payload(fd, c, static_cast<size_t>(h.count));
+                const size_t pad = static_cast<size_t>(h.payload) - static_cast<size_t>(h.count) * sizeof(T);
+                char skip[serial_header::align];
+                if (pad != 0)
+                    read_all(fd, skip, pad);
+            }
+            catch (...)
+            {
+                c.clear();
+                throw;
+            }
+        }
+
+        template <class T, class Container>
+        void save_container(int fd, serial_kind kind, const Container& c)
+        {
+            static_assert(std::is_trivially_copyable<T>::value,
+                          "dw_stl::save requires a trivially copyable value_type");
+            vector<struct iovec> segs;
+            collect_segments(c, segs);
+            write_record<T>(fd, kind, c.size(), segs);
+        }
+    }
+
+    /*****************************************************************************************/
+    // save / load
+    // vector与deque的记录可以互相读入，priority_queue只能读入priority_queue的快照
+    /*****************************************************************************************/
+    template <class T, class Alloc, class Growth>
+    void save(int fd, const vector<T, Alloc, Growth>& v)
+    {
+        serial_detail::save_container<T>(fd, serial_kind::vector, v);
+    }
+
+    template <class T, class Alloc>
+    void save(int fd, const deque<T, Alloc>& d)
+    {
+        serial_detail::save_container<T>(fd, serial_kind::deque, d);
+    }
+
+    // 按堆的顺序保存底层容器
+    template <class T, class Container, class Compare>
+    void save(int fd, const priority_queue<T, Container, Compare>& q)
+    {
+        serial_detail::save_container<T>(fd, serial_kind::priority_queue, q.container());
+    }
+
+    template <class T, class Alloc, class Growth>
+    void load(int fd, vector<T, Alloc, Growth>& v)
+    {
+        serial_detail::read_record<T>(fd, v, nullptr);
+    }
+
+    template <class T, class Alloc>
+    void load(int fd, deque<T, Alloc>& d)
+    {
+        serial_detail::read_record<T>(fd, d, nullptr);
+    }
+
+    // 读入的容器已经是堆，保留q原来的比较函数
+    template <class T, class Container, class Compare>
+    void load(int fd, priority_queue<T, Container, Compare>& q)
+    {
+        const serial_kind kind = serial_kind::priority_queue;
+        Container c;
+        serial_detail::read_record<T>(fd, c, &kind);
+        priority_queue<T, Container, Compare> tmp(heap_ordered, dw_stl::move(c), q.value_comp());
+        q.swap(tmp);
+    }
+
+    /*****************************************************************************************/
+    // serialized_view
+    // 只读映射文件中从 offset 开始的一条记录，元素直接在映射的内存中，不复制
+    /*****************************************************************************************/
+    template <class T>
+    class serialized_view
+    {
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "serialized_view<T> requires a trivially copyable value_type");
+    public:
+        typedef T           value_type;
+        typedef const T*    const_pointer;
+        typedef const T*    const_iterator;
+        typedef const T&    const_reference;
+        typedef size_t      size_type;
+
+        serialized_view() noexcept
+            : map_(nullptr), map_len_(0), data_(nullptr), size_(0), kind_(0), next_(0) {}
+
+        // 映射path中从offset开始的记录，offset必须是某条记录的开头
+        explicit serialized_view(const char* path, size_t offset = 0)
+            : serialized_view()
+        { open(path, offset); }
+
+        serialized_view(const serialized_view&) = delete;
+        serialized_view& operator=(const serialized_view&) = delete;
+
+        serialized_view(serialized_view&& rhs) noexcept
+            : map_(rhs.map_), map_len_(rhs.map_len_), data_(rhs.data_),
+              size_(rhs.size_), kind_(rhs.kind_), next_(rhs.next_)
+        { rhs.reset_members(); }
+
+        serialized_view& operator=(serialized_view&& rhs) noexcept
+        {
+            if (this != &rhs)
+            {
+                close();
+                map_ = rhs.map_;
+                map_len_ = rhs.map_len_;
+                data_ = rhs.data_;
+                size_ = rhs.size_;
+                kind_ = rhs.kind_;
+                next_ = rhs.next_;
+                rhs.reset_members();
+            }
+            return *this;
+        }
+
+        ~serialized_view()
+        { close(); }
+
+        void open(const char* path, size_t offset = 0);
+        void close() noexcept
+        {
+            if (map_ != nullptr)
+                ::munmap(map_, map_len_);
+            reset_members();
+        }
+
+        const_iterator begin() const noexcept { return data_; }
+        const_iterator end() const noexcept { return data_ + size_; }
+        const_pointer  data() const noexcept { return data_; }
+        size_type      size() const noexcept { return size_; }
+        bool           empty() const noexcept { return size_ == 0; }
+
+        const_reference operator[](size_type n) const
+        {
+            DW_STL_DEBUG(n < size_);
+            return data_[n];
+        }
+
+        serial_kind kind() const noexcept { return static_cast<serial_kind>(kind_); }
+        // 下一条记录在文件中的偏移
+        size_t next_offset() const noexcept { return next_; }
+
+    private:
+        void reset_members() noexcept
+        {
+            map_ = nullptr;
+            map_len_ = 0;
+            data_ = nullptr;
+            size_ = 0;
+            kind_ = 0;
+            next_ = 0;
+        }
+
+    private:
+        void*       map_;       // 映射的起始地址(按页对齐)
+        size_t      map_len_;   // 映射的字节数
+        const T*    data_;      // 第一个元素
+        size_type   size_;      // 元素个数
+        uint32_t    kind_;      // 记录的类型
+        size_t      next_;      // 下一条记录的偏移
+    };
+
+    template <class T>
+    void serialized_view<T>::open(const char* path, size_t offset)
+    {
+        close();
+        const int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+        THROW_RUNTIME_ERROR_IF(fd == -1, "dw_stl::serialized_view can not open the file");
+        serial_header h;
+        const bool ok = ::pread(fd, &h, sizeof(h), static_cast<off_t>(offset)) == static_cast<ssize_t>(sizeof(h));
+        struct stat st;
+        try
+        {
+            THROW_RUNTIME_ERROR_IF(!ok, "dw_stl::serialized_view can not read the header");
+            serial_detail::check_header<T>(h);
+            // 映射超出文件末尾的部分在访问时会产生SIGBUS，记录不完整时先抛出异常
+            THROW_RUNTIME_ERROR_IF(::fstat(fd, &st) != 0, "dw_stl::serialized_view fstat failed");
+            const size_t file_size = static_cast<size_t>(st.st_size);
+            THROW_RUNTIME_ERROR_IF(file_size < offset + sizeof(h) ||
+                                   file_size - offset - sizeof(h) < static_cast<size_t>(h.payload),
+                                   "dw_stl::serialized_view the record is truncated");
+            // 映射的起始地址按页对齐，元素的地址是否对齐取决于记录在文件中的偏移
+            THROW_RUNTIME_ERROR_IF((offset + sizeof(h)) % alignof(T) != 0,
+                                   "dw_stl::serialized_view the record is not aligned");
+        }
+        catch (...)
+        {
+            ::close(fd);
+            throw;
+        }
+        // mmap的偏移必须按页对齐
+        const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+        const size_t base = offset / page * page;
+        const size_t len = offset - base + sizeof(h) + static_cast<size_t>(h.payload);
+        void* p = ::mmap(nullptr, len, PROT_READ, MAP_SHARED, fd, static_cast<off_t>(base));
+        ::close(fd);
+        THROW_RUNTIME_ERROR_IF(p == MAP_FAILED, "dw_stl::serialized_view mmap failed");
+        map_ = p;
+        map_len_ = len;
+        data_ = reinterpret_cast<const T*>(static_cast<const char*>(p) + (offset - base) + sizeof(h));
+        size_ = static_cast<size_type>(h.count);
+        kind_ = h.kind;
+        next_ = offset + sizeof(h) + static_cast<size_t>(h.payload);
+    }
+}
+
+#endif
@@ -0,0 +1,931 @@
+#ifndef DW_STL_SMALL_VECTOR_H_
+#define DW_STL_SMALL_VECTOR_H_
+
+/*
+这个头文件用于实现模板类 small_vector<T, N>
+
+small_vector 的接口与 vector 相同，但是对象内部带有可以存放 N 个元素的空间：
+    元素个数不超过 N 时不分配内存，元素直接保存在对象内部，访问时也少一次指针跳转
+    超过 N 个元素时与 vector 一样按 Growth(默认为 DW_STL_VECTOR_DEFAULT_GROWTH)在堆上扩容，元素可以按字节迁移时整块复制
+    shrink_to_fit 在元素个数不超过 N 时把元素移回对象内部并释放堆上的空间
+
+适合大多数情况下元素很少的列表，例如 small_vector<int, 8>
+注意：元素保存在对象内部时，移动或者交换 small_vector 会移动每个元素，迭代器也随之失效
+
+异常保证：
+    dw_stl::small_vector<T, N> 满足基本异常保证，并对以下函数做强异常安全保证：
+        emplace_back
+        emplace
+        push_back
+        需要扩容的 insert
+*/
+
+#include <initializer_list>
+
+#include "iterator.h"
+#include "memory.h"
+#include "util.h"
+#include "exceptdef.h"
+#include "allocator.h"
+#include "allocator_traits.h"
+#include "uninitialized.h"
+#include "algorithm.h"
+#include "vector.h"
+
+namespace dw_stl
+{
+    // small_vector模板类
+    // 模板参数T代表数据类型，N代表对象内部可以保存的元素个数，Alloc代表在堆上分配空间时使用的分配器，
+    // Growth代表转到堆上之后的扩容策略，与vector相同
+    template <class T, size_t N, class Alloc = dw_stl::allocator<T>, class Growth = DW_STL_VECTOR_DEFAULT_GROWTH>
+    class small_vector : private dw_stl::allocator_holder<Alloc>
+    {
+        static_assert(N > 0, "N of small_vector should be greater than 0");
+        static_assert(std::is_same<T, typename Alloc::value_type>::value,
+                      "The value_type of Alloc should be same with T");
+    public:
+        typedef Alloc                                    allocator_type;
+        typedef dw_stl::allocator_traits<Alloc>          alloc_traits;
+
+        typedef T                                        value_type;
+        typedef typename alloc_traits::pointer           pointer;
+        typedef typename alloc_traits::const_pointer     const_pointer;
+        typedef value_type&                              reference;
+        typedef const value_type&                        const_reference;
+        typedef typename alloc_traits::size_type         size_type;
+        typedef typename alloc_traits::difference_type   difference_type;
+
+        typedef value_type*                              iterator;
+        typedef const value_type*                        const_iterator;
+
+        typedef dw_stl::reverse_iterator<iterator>        reverse_iterator;
+        typedef dw_stl::reverse_iterator<const_iterator>  const_reverse_iterator;
+
+        // 对象内部可以保存的元素个数
+        static constexpr size_type inline_capacity = N;
+
+        allocator_type get_allocator() const { return this->alloc(); }
+
+    private:
+        typedef dw_stl::allocator_holder<Alloc>          holder_base;
+
+        // 元素可以按字节迁移时，扩容、插入、删除都整块复制元素，不需要逐个移动构造和析构
+        typedef dw_stl::is_trivially_relocatable<T>      can_relocate;
+
+        typedef typename std::aligned_storage<sizeof(T), alignof(T)>::type raw_storage;
+
+        iterator    begin_;        // 表示目前使用空间的头部
+        iterator    end_;          // 表示目前使用空间的尾部
+        iterator    cap_;          // 表示目前储存空间的尾部
+        raw_storage storage_[N];   // 对象内部的空间
+
+    public:
+        // 构造、复制、移动、析构函数
+        small_vector() noexcept
+        { reset_inline(); }
+
+        explicit small_vector(const allocator_type& alloc) noexcept
+            :holder_base(alloc)
+        { reset_inline(); }
+
+        explicit small_vector(size_type n, const allocator_type& alloc = allocator_type())
+            :holder_base(alloc)
+        {
+            reset_inline();
+            fill_insert(end_, n, value_type());
+        }
+
+        small_vector(size_type n, const value_type& value, const allocator_type& alloc = allocator_type())
+            :holder_base(alloc)
+        {
+            reset_inline();
+            fill_insert(end_, n, value);
+        }
+
+        template <class Iter, typename std::enable_if<
+            dw_stl::is_input_iterator<Iter>::value, int>::type = 0>
+        small_vector(Iter first, Iter last, const allocator_type& alloc = allocator_type())
+            :holder_base(alloc)
+        {
+            reset_inline();
+            copy_insert(end_, first, last, iterator_category(first));
+        }
+
+        small_vector(const small_vector& rhs)
+            :holder_base(alloc_traits::select_on_container_copy_construction(rhs.alloc()))
+        {
+            reset_inline();
+            copy_insert(end_, rhs.begin_, rhs.end_, dw_stl::forward_iterator_tag());
+        }
+
+        small_vector(const small_vector& rhs, const allocator_type& alloc)
+            :holder_base(alloc)
+        {
+            reset_inline();
+            copy_insert(end_, rhs.begin_, rhs.end_, dw_stl::forward_iterator_tag());
+        }
+
+        // rhs的元素在堆上时直接接管，在对象内部时逐个移动过来
+        small_vector(small_vector&& rhs) noexcept(std::is_nothrow_move_constructible<T>::value)
+            :holder_base(dw_stl::move(rhs.alloc()))
+        {
+            reset_inline();
+            take(rhs);
+        }
+
+        small_vector(small_vector&& rhs, const allocator_type& alloc)
+            :holder_base(alloc)
+        {
+            reset_inline();
+            if (rhs.is_inline() || dw_stl::alloc_equal(this->alloc(), rhs.alloc()))
+            {
+                take(rhs);
+            }
+            else
+            {
+                reserve(rhs.size());
+                end_ = dw_stl::uninitialized_move(rhs.begin_, rhs.end_, begin_);
+                rhs.clear();
+            }
+        }
+
+        small_vector(std::initializer_list<value_type> ilist, const allocator_type& alloc = allocator_type())
+            :holder_base(alloc)
+        {
+            reset_inline();
+            copy_insert(end_, ilist.begin(), ilist.end(), dw_stl::forward_iterator_tag());
+        }
+
+        small_vector& operator=(const small_vector& rhs);
+        // 分配器不传播且不总是相等时可能要在堆上分配空间，不能保证不抛出异常
+        small_vector& operator=(small_vector&& rhs)
+            noexcept(std::is_nothrow_move_constructible<T>::value &&
+                     (alloc_traits::propagate_on_container_move_assignment::value ||
+                      alloc_traits::is_always_equal::value));
+
+        small_vector& operator=(std::initializer_list<value_type> ilist)
+        {
+            copy_assign(ilist.begin(), ilist.end(), dw_stl::forward_iterator_tag());
+            return *this;
+        }
+
+        ~small_vector()
+        {
+            alloc_traits::destroy(this->alloc(), begin_, end_);
+            deallocate_heap(begin_, capacity());
+        }
+
+    public:
+        // 迭代器相关操作
+        iterator begin() noexcept
+        { return begin_; }
+        const_iterator begin() const noexcept
+        { return begin_; }
+        iterator end() noexcept
+        { return end_; }
+        const_iterator end() const noexcept
+        { return end_; }
+
+        reverse_iterator rbegin() noexcept
+        { return reverse_iterator(end()); }
+        const_reverse_iterator rbegin() const noexcept
+        { return const_reverse_iterator(end()); }
+        reverse_iterator rend() noexcept
+        { return reverse_iterator(begin()); }
+        const_reverse_iterator rend() const noexcept
+        { return const_reverse_iterator(begin()); }
+
+        const_iterator cbegin() const noexcept
+        { return begin(); }
+        const_iterator cend() const noexcept
+        { return end(); }
+        const_reverse_iterator crbegin() const noexcept
+        { return rbegin(); }
+        const_reverse_iterator crend() const noexcept
+        { return rend(); }
+
+        // 容量相关操作
+        bool empty() const noexcept
+        { return begin_ == end_; }
+        size_type size() const noexcept
+        { return static_cast<size_type>(end_ - begin_); }
+        size_type max_size() const noexcept
+        { return alloc_traits::max_size(this->alloc()); }
+        size_type capacity() const noexcept
+        { return static_cast<size_type>(cap_ - begin_); }
+        // 元素是否保存在对象内部
+        bool is_inline() const noexcept
+        { return begin_ == inline_data(); }
+        void reserve(size_type n);
+        void shrink_to_fit();
+
+        // 访问元素相关操作
+        reference operator[](size_type n)
+        {
+            DW_STL_DEBUG(n < size());
+            return *(begin_ + n);
+        }
+        const_reference operator[](size_type n) const
+        {
+            DW_STL_DEBUG(n < size());
+            return *(begin_ + n);
+        }
+        reference at(size_type n)
+        {
+            THROW_OUT_OF_RANGE_IF(!(n < size()), "small_vector<T, N>::at() subscript out of range");
+            return (*this)[n];
+        }
+        const_reference at(size_type n) const
+        {
+            THROW_OUT_OF_RANGE_IF(!(n < size()), "small_vector<T, N>::at() subscript out of range");
+            return (*this)[n];
+        }
+
+        reference front()
+        {
+            DW_STL_DEBUG(!empty());
+            return *begin_;
+        }
+        const_reference front() const
+        {
+            DW_STL_DEBUG(!empty());
+            return *begin_;
+        }
+        reference back()
+        {
+            DW_STL_DEBUG(!empty());
+            return *(end_ - 1);
+        }
+        const_reference back() const
+        {
+            DW_STL_DEBUG(!empty());
+            return *(end_ - 1);
+        }
+
+        pointer data() noexcept { return begin_; }
+        const_pointer data() const noexcept { return begin_; }
+
+        // 修改容器相关操作
+        void assign(size_type n, const value_type& value)
+        { fill_assign(n, value); }
+
+        template <class Iter, typename std::enable_if<
+            dw_stl::is_input_iterator<Iter>::value, int>::type = 0>
+        void assign(Iter first, Iter last)
+        { copy_assign(first, last, iterator_category(first)); }
+
+        void assign(std::initializer_list<value_type> il)
+        { copy_assign(il.begin(), il.end(), dw_stl::forward_iterator_tag{}); }
+
+        template <class... Args>
+        iterator emplace(const_iterator pos, Args&& ...args);
+
+        template <class... Args>
+        void emplace_back(Args&& ...args)
+        {
+            if (end_ != cap_)
+            {
+                alloc_traits::construct(this->alloc(), end_, dw_stl::forward<Args>(args)...);
+                ++end_;
+            }
+            else
+            {
+                emplace(end_, dw_stl::forward<Args>(args)...);
+            }
+        }
+
+        void push_back(const value_type& value)
+        { emplace_back(value); }
+        void push_back(value_type&& value)
+        { emplace_back(dw_stl::move(value)); }
+
+        void pop_back()
+        {
+            DW_STL_DEBUG(!empty());
+            --end_;
+            alloc_traits::destroy(this->alloc(), end_);
+        }
+
+        iterator insert(const_iterator pos, const value_type& value)
+        { return emplace(pos, value); }
+        iterator insert(const_iterator pos, value_type&& value)
+        { return emplace(pos, dw_stl::move(value)); }
+
+        iterator insert(const_iterator pos, size_type n, const value_type& value)
+        {
+            DW_STL_DEBUG(pos >= begin() && pos <= end());
+            return fill_insert(const_cast<iterator>(pos), n, value);
+        }
+
+        template <class Iter, typename std::enable_if<
+            dw_stl::is_input_iterator<Iter>::value, int>::type = 0>
+        iterator insert(const_iterator pos, Iter first, Iter last)
+        {
+            DW_STL_DEBUG(pos >= begin() && pos <= end());
+            return copy_insert(const_cast<iterator>(pos), first, last, iterator_category(first));
+        }
+
+        iterator insert(const_iterator pos, std::initializer_list<value_type> ilist)
+        {
+            DW_STL_DEBUG(pos >= begin() && pos <= end());
+            return copy_insert(const_cast<iterator>(pos), ilist.begin(), ilist.end(),
+                               dw_stl::forward_iterator_tag());
+        }
+
+        iterator erase(const_iterator pos)
+        { return erase(pos, pos + 1); }
+        iterator erase(const_iterator first, const_iterator last);
+        void clear() noexcept
+        {
+            alloc_traits::destroy(this->alloc(), begin_, end_);
+            end_ = begin_;
+        }
+
+        void resize(size_type new_size) { resize(new_size, value_type()); }
+        void resize(size_type new_size, const value_type& value);
+
+        void swap(small_vector& rhs);
+
+    private:
+        T* inline_data() noexcept
+        { return reinterpret_cast<T*>(storage_); }
+        const T* inline_data() const noexcept
+        { return reinterpret_cast<const T*>(storage_); }
+
+        void reset_inline() noexcept
+        {
+            begin_ = end_ = inline_data();
+            cap_ = begin_ + N;
+        }
+
+        // 只释放堆上的空间
+        void deallocate_heap(iterator p, size_type n) noexcept
+        {
+            if (p != inline_data())
+                alloc_traits::deallocate(this->alloc(), p, n);
+        }
+
+        // 把[first, last)迁移到result开始的未初始化空间，原来的元素被析构
+        iterator relocate_range(iterator first, iterator last, iterator result);
+
+        // 接管rhs的元素，调用前*this为空并且使用对象内部的空间
+        void take(small_vector& rhs);
+
+        // 计算至少再容纳add_size个元素的新容量，由扩容策略Growth决定
+        size_type get_new_cap(size_type add_size) const;
+
+        // 把原来的元素迁移到new_begin开始的新空间，在pos对应的位置空出n个单元(调用前已经构造好)，并释放原来的空间
+        void relocate_to(iterator new_begin, size_type new_cap, iterator pos, size_type n);
+
+        void fill_assign(size_type n, const value_type& value);
+        template <class InputIter>
+        void copy_assign(InputIter first, InputIter last, input_iterator_tag);
+        template <class FIter>
+        void copy_assign(FIter first, FIter last, forward_iterator_tag);
+
+        iterator fill_insert(iterator pos, size_type n, const value_type& value);
+        template <class InputIter>
+        iterator copy_insert(iterator pos, InputIter first, InputIter last, input_iterator_tag);
+        template <class FIter>
+        iterator copy_insert(iterator pos, FIter first, FIter last, forward_iterator_tag);
+
+        // 在有足够剩余容量时，把[pos, end_)后移n个单元，再用construct构造空出的n个单元
+        template <class Construct>
+        void insert_in_place(iterator pos, size_type n, Construct construct);
+    };
+
+    /****************************************************************************/
+
+    // 复制赋值运算符
+    template <class T, size_t N, class Alloc, class Growth>
+    small_vector<T, N, Alloc, Growth>& small_vector<T, N, Alloc, Growth>::operator=(const small_vector& rhs)
+    {
+        if (this != &rhs)
+        {
+            // 如果分配器需要传播且两个分配器不相等，堆上的空间只能由原来的分配器释放
+            if (alloc_traits::propagate_on_container_copy_assignment::value &&
+                !dw_stl::alloc_equal(this->alloc(), rhs.alloc()))
+            {
+                clear();
+                deallocate_heap(begin_, capacity());
+                reset_inline();
+            }
+            dw_stl::alloc_on_copy(this->alloc(), rhs.alloc());
+            copy_assign(rhs.begin_, rhs.end_, dw_stl::forward_iterator_tag());
+        }
+        return *this;
+    }
+
+    // 移动赋值运算符
+    template <class T, size_t N, class Alloc, class Growth>
+    small_vector<T, N, Alloc, Growth>& small_vector<T, N, Alloc, Growth>::operator=(small_vector&& rhs)
+        noexcept(std::is_nothrow_move_constructible<T>::value &&
+                 (alloc_traits::propagate_on_container_move_assignment::value ||
+                  alloc_traits::is_always_equal::value))
+    {
+        if (this == &rhs)
+            return *this;
+        clear();
+        if (rhs.is_inline() || alloc_traits::propagate_on_container_move_assignment::value ||
+            dw_stl::alloc_equal(this->alloc(), rhs.alloc()))
+        {
+            deallocate_heap(begin_, capacity());
+            reset_inline();
+            dw_stl::alloc_on_move(this->alloc(), rhs.alloc());
+            take(rhs);
+        }
+        else
+        {
+            // 分配器不相等且不传播，只能用自己的空间逐个移动元素
+            reserve(rhs.size());
+            end_ = dw_stl::uninitialized_move(rhs.begin_, rhs.end_, begin_);
+            rhs.clear();
+        }
+        return *this;
+    }
+
+    // 预留空间，只有超过对象内部的空间与当前容量时才分配
+    template <class T, size_t N, class Alloc, class Growth>
+    void small_vector<T, N, Alloc, Growth>::reserve(size_type n)
+    {
+        if (capacity() < n)
+        {
+            THROW_LENGTH_ERROR_IF(n > max_size(), "n can not larger than max_size() in small_vector<T, N>::reserve(n)");
+            auto tmp = alloc_traits::allocate(this->alloc(), n);
+            relocate_to(tmp, n, end_, 0);
+        }
+    }
+
+    // 放弃多余的容量，元素个数不超过N时移回对象内部
+    template <class T, size_t N, class Alloc, class Growth>
+    void small_vector<T, N, Alloc, Growth>::shrink_to_fit()
+    {
+        if (is_inline() || end_ == cap_)
+            return;
+        if (size() <= N)
+        {
+            relocate_to(inline_data(), N, end_, 0);
+        }
+        else
+        {
+            const size_type n = size();
+            auto tmp = alloc_traits::allocate(this->alloc(), n);
+            relocate_to(tmp, n, end_, 0);
+        }
+    }
+
+    // emplace函数，在pos处就地构造元素
+    template <class T, size_t N, class Alloc, class Growth>
+    template <class ...Args>
+    typename small_vector<T, N, Alloc, Growth>::iterator
+    small_vector<T, N, Alloc, Growth>::emplace(const_iterator pos, Args&& ...args)
+    {
+        DW_STL_DEBUG(pos >= begin() && pos <= end());
+        iterator xpos = const_cast<iterator>(pos);
+        const size_type n = xpos - begin_;
+        if (end_ != cap_ && xpos == end_)
+        {
+            alloc_traits::construct(this->alloc(), end_, dw_stl::forward<Args>(args)...);
+            ++end_;
+        }
+        else if (end_ != cap_ && can_relocate::value)
+        {
+            // 参数可能引用容器内部的元素，先在临时空间构造，再整块挪动后面的元素
+            raw_storage buf;
+            auto tmp = reinterpret_cast<T*>(&buf);
+            alloc_traits::construct(this->alloc(), tmp, dw_stl::forward<Args>(args)...);
+            dw_stl::uninitialized_relocate(xpos, end_, xpos + 1);
+            dw_stl::uninitialized_relocate(tmp, tmp + 1, xpos);
+            ++end_;
+        }
+        else if (end_ != cap_)
+        {
+            value_type value_copy(dw_stl::forward<Args>(args)...);
+            alloc_traits::construct(this->alloc(), end_, dw_stl::move(*(end_ - 1)));
+            ++end_;
+            dw_stl::move_backward(xpos, end_ - 2, end_ - 1);
+            *xpos = dw_stl::move(value_copy);
+        }
+        else
+        {
+            // 先在新空间中构造新元素，失败时原来的元素不受影响
+            const size_type new_cap = get_new_cap(1);
+            auto new_begin = alloc_traits::allocate(this->alloc(), new_cap);
+            try
+            {
+                alloc_traits::construct(this->alloc(), new_begin + n, dw_stl::forward<Args>(args)...);
+            }
+            catch (...)
+            {
+                alloc_traits::deallocate(this->alloc(), new_begin, new_cap);
+                throw;
+            }
+            relocate_to(new_begin, new_cap, xpos, 1);
+        }
+        return begin_ + n;
+    }
+
+    // 删除[first, last)上的元素
+    template <class T, size_t N, class Alloc, class Growth>
+    typename small_vector<T, N, Alloc, Growth>::iterator
+    small_vector<T, N, Alloc, Growth>::erase(const_iterator first, const_iterator last)
+    {
+        DW_STL_DEBUG(first >= begin() && last <= end() && !(last < first));
+        iterator xfirst = const_cast<iterator>(first);
+        iterator xlast = const_cast<iterator>(last);
+        if (xfirst == xlast)
+            return xfirst;
+        if (can_relocate::value)
+        {
+            alloc_traits::destroy(this->alloc(), xfirst, xlast);
+            dw_stl::uninitialized_relocate(xlast, end_, xfirst);
+            end_ -= (xlast - xfirst);
+        }
+        else
+        {
+            auto new_end = dw_stl::move(xlast, end_, xfirst);
+            alloc_traits::destroy(this->alloc(), new_end, end_);
+            end_ = new_end;
+        }
+        return xfirst;
+    }
+
+    // 重置容器大小
+    template <class T, size_t N, class Alloc, class Growth>
+    void small_vector<T, N, Alloc, Growth>::resize(size_type new_size, const value_type& value)
+    {
+        if (new_size < size())
+            erase(begin_ + new_size, end_);
+        else
+            fill_insert(end_, new_size - size(), value);
+    }
+
+    // 交换两个small_vector
+    // 都在堆上时只交换指针，否则需要逐个交换或者移动对象内部的元素
+    template <class T, size_t N, class Alloc, class Growth>
+    void small_vector<T, N, Alloc, Growth>::swap(small_vector& rhs)
+    {
+        if (this == &rhs)
+            return;
+        dw_stl::alloc_on_swap(this->alloc(), rhs.alloc());
+        if (!is_inline() && !rhs.is_inline())
+        {
+            dw_stl::swap(begin_, rhs.begin_);
+            dw_stl::swap(end_, rhs.end_);
+            dw_stl::swap(cap_, rhs.cap_);
+        }
+        else if (is_inline() && rhs.is_inline())
+        {
+            small_vector& longer = size() < rhs.size() ? rhs : *this;
+            small_vector& shorter = size() < rhs.size() ? *this : rhs;
+            const size_type common = shorter.size();
+            for (size_type i = 0; i < common; ++i)
+                dw_stl::swap(shorter.begin_[i], longer.begin_[i]);
+            shorter.end_ = dw_stl::uninitialized_move(longer.begin_ + common, longer.end_, shorter.end_);
+            alloc_traits::destroy(this->alloc(), longer.begin_ + common, longer.end_);
+            longer.end_ = longer.begin_ + common;
+        }
+        else
+        {
+            // 在对象内部的一方先把元素移动到另一方的对象内部，再接管另一方堆上的空间
+            small_vector& in = is_inline() ? *this : rhs;
+            small_vector& heap = is_inline() ? rhs : *this;
+            iterator heap_begin = heap.begin_;
+            iterator heap_end = heap.end_;
+            iterator heap_cap = heap.cap_;
+            heap.reset_inline();
+            try
+            {
+                heap.end_ = in.relocate_range(in.begin_, in.end_, heap.begin_);
+            }
+            catch (...)
+            {
+                heap.begin_ = heap_begin;
+                heap.end_ = heap_end;
+                heap.cap_ = heap_cap;
+                throw;
+            }
+            in.begin_ = heap_begin;
+            in.end_ = heap_end;
+            in.cap_ = heap_cap;
+        }
+    }
+
+    /****************************************************************************/
+    // 下面是实现接口用到的一些辅助函数
+    /****************************************************************************/
+
+    template <class T, size_t N, class Alloc, class Growth>
+    typename small_vector<T, N, Alloc, Growth>::iterator
+    small_vector<T, N, Alloc, Growth>::relocate_range(iterator first, iterator last, iterator result)
+    {
+        if (can_relocate::value)
+            return dw_stl::uninitialized_relocate(first, last, result);
+        auto new_last = dw_stl::uninitialized_move(first, last, result);
+        alloc_traits::destroy(this->alloc(), first, last);
+        return new_last;
+    }
+
+    template <class T, size_t N, class Alloc, class Growth>
+    void small_vector<T, N, Alloc, Growth>::take(small_vector& rhs)
+    {
+        if (!rhs.is_inline())
+        {
+            begin_ = rhs.begin_;
+            end_ = rhs.end_;
+            cap_ = rhs.cap_;
+            rhs.reset_inline();
+        }
+        else
+        {
+            end_ = rhs.relocate_range(rhs.begin_, rhs.end_, begin_);
+            rhs.end_ = rhs.begin_;
+        }
+    }
+
+    template <class T, size_t N, class Alloc, class Growth>
+    typename small_vector<T, N, Alloc, Growth>::size_type
+    small_vector<T, N, Alloc, Growth>::get_new_cap(size_type add_size) const
+    {
+        THROW_LENGTH_ERROR_IF(size() > max_size() - add_size, "small_vector<T, N> size too big");
+        return Growth::grow(capacity(), size() + add_size,
+                            static_cast<size_type>(vector_init_cap<T>::value), max_size());
+    }
+
+    // relocate_to函数，new_begin可以是对象内部的空间(shrink_to_fit)
+    template <class T, size_t N, class Alloc, class Growth>
+    void small_vector<T, N, Alloc, Growth>::relocate_to(iterator new_begin, size_type new_cap, iterator pos, size_type n)
+    {
+        const size_type old_size = size();
+        const size_type before = static_cast<size_type>(pos - begin_);
+        iterator new_pos = new_begin + before;
+        if (can_relocate::value)
+        {
+            dw_stl::uninitialized_relocate(begin_, pos, new_begin);
+            dw_stl::uninitialized_relocate(pos, end_, new_pos + n);
+        }
+        else
+        {
+            try
+            {
+                dw_stl::uninitialized_move(begin_, pos, new_begin);
+                try
+                {
+                    dw_stl::uninitialized_move(pos, end_, new_pos + n);
+                }
+                catch (...)
+                {
+                    alloc_traits::destroy(this->alloc(), new_begin, new_pos);
+                    throw;
+                }
+            }
+            catch (...)
+            {
+                alloc_traits::destroy(this->alloc(), new_pos, new_pos + n);
+                deallocate_heap(new_begin, new_cap);
+                throw;
+            }
+            alloc_traits::destroy(this->alloc(), begin_, end_);
+        }
+        deallocate_heap(begin_, capacity());
+        begin_ = new_begin;
+        end_ = new_begin + old_size + n;
+        cap_ = new_begin + new_cap;
+    }
+
+    // fill_assign函数
+    template <class T, size_t N, class Alloc, class Growth>
+    void small_vector<T, N, Alloc, Growth>::fill_assign(size_type n, const value_type& value)
+    {
+        if (n > capacity())
+        {
+            small_vector tmp(n, value, this->alloc());
+            swap(tmp);
+        }
+        else if (n > size())
+        {
+            const value_type value_copy = value;
+            dw_stl::fill(begin_, end_, value_copy);
+            end_ = dw_stl::uninitialized_fill_n(end_, n - size(), value_copy);
+        }
+        else
+        {
+            erase(dw_stl::fill_n(begin_, n, value), end_);
+        }
+    }
+
+    // copy_assign函数
+    template <class T, size_t N, class Alloc, class Growth>
+    template <class InputIter>
+    void small_vector<T, N, Alloc, Growth>::copy_assign(InputIter first, InputIter last, input_iterator_tag)
+    {
+        auto cur = begin_;
+        for (; first != last && cur != end_; ++first, ++cur)
+            *cur = *first;
+        if (first == last)
+            erase(cur, end_);
+        else
+            copy_insert(end_, first, last, input_iterator_tag());
+    }
+
+    template <class T, size_t N, class Alloc, class Growth>
+    template <class FIter>
+    void small_vector<T, N, Alloc, Growth>::copy_assign(FIter first, FIter last, forward_iterator_tag)
+    {
+        const size_type len = dw_stl::distance(first, last);
+        if (len > capacity())
+        {
+            auto new_begin = alloc_traits::allocate(this->alloc(), len);
+            try
+            {
+                dw_stl::uninitialized_copy(first, last, new_begin);
+            }
+            catch (...)
+            {
+                alloc_traits::deallocate(this->alloc(), new_begin, len);
+                throw;
+            }
+            clear();
+            deallocate_heap(begin_, capacity());
+            begin_ = new_begin;
+            end_ = cap_ = new_begin + len;
+        }
+        else if (size() >= len)
+        {
+            erase(dw_stl::copy(first, last, begin_), end_);
+        }
+        else
+        {
+            auto mid = first;
+            dw_stl::advance(mid, size());
+            dw_stl::copy(first, mid, begin_);
+            end_ = dw_stl::uninitialized_copy(mid, last, end_);
+        }
+    }
+
+    // insert_in_place函数，调用前剩余容量不少于n
+    template <class T, size_t N, class Alloc, class Growth>
+    template <class Construct>
+    void small_vector<T, N, Alloc, Growth>::insert_in_place(iterator pos, size_type n, Construct construct)
+    {
+        if (can_relocate::value)
+        {
+            // 整块后移，构造失败时移回原处
+            dw_stl::uninitialized_relocate(pos, end_, pos + n);
+            try
+            {
+                construct(pos);
+            }
+            catch (...)
+            {
+                dw_stl::uninitialized_relocate(pos + n, end_ + n, pos);
+                throw;
+            }
+            end_ += n;
+        }
+        else
+        {
+            // 先把后面的元素移动到新的位置，再在空出的位置上构造
+            const size_type after = static_cast<size_type>(end_ - pos);
+            const size_type moved = dw_stl::min(after, n);
+            iterator old_end = end_;
+            end_ = dw_stl::uninitialized_move(old_end - moved, old_end, old_end + n - moved);
+            dw_stl::move_backward(pos, old_end - moved, old_end + n - moved);
+            alloc_traits::destroy(this->alloc(), pos, pos + moved);
+            try
+            {
+                construct(pos);
+            }
+            catch (...)
+            {
+                // 空出的位置重新构造为默认值无法保证成功，只能丢弃后面的元素，满足基本异常保证
+                alloc_traits::destroy(this->alloc(), pos + n, end_);
+                end_ = pos;
+                throw;
+            }
+        }
+    }
+
+    // fill_insert函数，在pos处插入n个value
+    template <class T, size_t N, class Alloc, class Growth>
+    typename small_vector<T, N, Alloc, Growth>::iterator
+    small_vector<T, N, Alloc, Growth>::fill_insert(iterator pos, size_type n, const value_type& value)
+    {
+        const size_type off = static_cast<size_type>(pos - begin_);
+        if (n == 0)
+            return pos;
+        if (static_cast<size_type>(cap_ - end_) >= n)
+        {
+            // value可能引用容器内部的元素，先复制一份
+            const value_type value_copy = value;
+            insert_in_place(pos, n, [&](iterator p) { dw_stl::uninitialized_fill_n(p, n, value_copy); });
+        }
+        else
+        {
+            const size_type new_cap = get_new_cap(n);
+            auto new_begin = alloc_traits::allocate(this->alloc(), new_cap);
+            try
+            {
+                dw_stl::uninitialized_fill_n(new_begin + off, n, value);
+            }
+            catch (...)
+            {
+                alloc_traits::deallocate(this->alloc(), new_begin, new_cap);
+                throw;
+            }
+            relocate_to(new_begin, new_cap, pos, n);
+        }
+        return begin_ + off;
+    }
+
+    // copy_insert函数，输入迭代器只能逐个插入
+    template <class T, size_t N, class Alloc, class Growth>
+    template <class InputIter>
+    typename small_vector<T, N, Alloc, Growth>::iterator
+    small_vector<T, N, Alloc, Growth>::copy_insert(iterator pos, InputIter first, InputIter last, input_iterator_tag)
+    {
+        const size_type off = static_cast<size_type>(pos - begin_);
+        for (; first != last; ++first, ++pos)
+            pos = emplace(pos, *first);
+        return begin_ + off;
+    }
+
+    template <class T, size_t N, class Alloc, class Growth>
+    template <class FIter>
+    typename small_vector<T, N, Alloc, Growth>::iterator
+    small_vector<T, N, Alloc, Growth>::copy_insert(iterator pos, FIter first, FIter last, forward_iterator_tag)
+    {
+        const size_type off = static_cast<size_type>(pos - begin_);
+        const size_type n = dw_stl::distance(first, last);
+        if (n == 0)
+            return pos;
+        if (static_cast<size_type>(cap_ - end_) >= n)
+        {
+            insert_in_place(pos, n, [&](iterator p) { dw_stl::uninitialized_copy(first, last, p); });
+        }
+        else
+        {
+            const size_type new_cap = get_new_cap(n);
+            auto new_begin = alloc_traits::allocate(this->alloc(), new_cap);
+            try
+            {
+                dw_stl::uninitialized_copy(first, last, new_begin + off);
+            }
+            catch (...)
+            {
+                alloc_traits::deallocate(this->alloc(), new_begin, new_cap);
+                throw;
+            }
+            relocate_to(new_begin, new_cap, pos, n);
+        }
+        return begin_ + off;
+    }
+
+    /****************************************************************************/
+    // 重载比较操作符
+    template <class T, size_t N, class Alloc, class Growth>
+    bool operator==(const small_vector<T, N, Alloc, Growth>& lhs, const small_vector<T, N, Alloc, Growth>& rhs)
+    {
+        return lhs.size() == rhs.size() &&
+            dw_stl::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+
+    template <class T, size_t N, class Alloc, class Growth>
+    bool operator<(const small_vector<T, N, Alloc, Growth>& lhs, const small_vector<T, N, Alloc, Growth>& rhs)
+    {
+        return dw_stl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+
+    template <class T, size_t N, class Alloc, class Growth>
+    bool operator!=(const small_vector<T, N, Alloc, Growth>& lhs, const small_vector<T, N, Alloc, Growth>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    template <class T, size_t N, class Alloc, class Growth>
+    bool operator>(const small_vector<T, N, Alloc, Growth>& lhs, const small_vector<T, N, Alloc, Growth>& rhs)
+    {
+        return rhs < lhs;
+    }
+
+    template <class T, size_t N, class Alloc, class Growth>
+    bool operator<=(const small_vector<T, N, Alloc, Growth>& lhs, const small_vector<T, N, Alloc, Growth>& rhs)
+    {
+        return !(rhs < lhs);
+    }
+
+    template <class T, size_t N, class Alloc, class Growth>
+    bool operator>=(const small_vector<T, N, Alloc, Growth>& lhs, const small_vector<T, N, Alloc, Growth>& rhs)
+    {
+        return !(lhs < rhs);
+    }
+
+    // 重载dw_stl的swap
+    template <class T, size_t N, class Alloc, class Growth>
+    void swap(small_vector<T, N, Alloc, Growth>& lhs, small_vector<T, N, Alloc, Growth>& rhs)
+    {
+        lhs.swap(rhs);
+    }
+}
+
+#endif
@@ -0,0 +1,726 @@
+#ifndef DW_STL_SOA_VECTOR_H_
+#define DW_STL_SOA_VECTOR_H_
+
+/*
+这个头文件用于实现模板类 soa_vector<Fields...>，按列(struct of arrays)保存元素的 vector
+
+vector<Record> 按行保存，只读取 12 个字段中的 2 个时，每个缓存行中大部分字节都用不到，
+soa_vector 把每个字段保存在各自连续的数组(列)中，扫描某几列时只读取这几列的内存，并且每一列都可以直接交给 SIMD 代码：
+    全部列在一次分配的空间中，每一列的起始地址按 max(DW_STL_CACHELINE_SIZE, alignof(字段)) 对齐
+    扩容策略与 vector 相同，使用 vector.h 中的 Growth，全部列一起扩容，
+    迁移时使用 uninitialized_relocate，满足 is_trivially_relocatable 的列用 memmove 整列迁移
+    value_type 是 std::tuple<Fields...>，reference 是代理类型 std::tuple<Fields&...>，
+    可以用 std::get<I>(v[n]) 读写第 n 个元素的第 I 个字段，或者用 v[n] = std::make_tuple(...) 整行赋值
+    get<I>(n) 直接返回字段的引用，column<I>() 返回第 I 列的 soa_span，data<I>() 返回第 I 列的首地址
+
+迭代器是随机访问迭代器，解引用返回代理类型，没有 operator->
+
+异常保证：
+    dw_stl::soa_vector<Fields...> 满足基本异常保证，并对以下函数做强异常安全保证：
+        emplace_back
+        push_back
+        reserve
+    迁移时移动构造函数可能抛出异常的列先复制，全部复制成功之后才析构原来的元素；这样的列不能复制时只能移动，只满足基本异常保证
+*/
+
+#include <initializer_list>
+#include <tuple>
+
+#include "iterator.h"
+#include "util.h"
+#include "exceptdef.h"
+#include "aligned_alloc.h"
+#include "algorithm.h"
+#include "uninitialized.h"
+#include "vector.h"
+
+namespace dw_stl
+{
+    namespace soa_detail
+    {
+        template <size_t... I>
+        struct index_seq {};
+
+        template <size_t N, size_t... I>
+        struct make_index_seq : make_index_seq<N - 1, N - 1, I...> {};
+
+        template <size_t... I>
+        struct make_index_seq<0, I...> { typedef index_seq<I...> type; };
+
+        // 按顺序对参数包中的每一项求值：(void)expand{0, (expr, 0)...}
+        typedef int expand[];
+
+        constexpr size_t max_of(size_t a) { return a; }
+        template <class... Rest>
+        constexpr size_t max_of(size_t a, size_t b, Rest... rest)
+        { return max_of(a > b ? a : b, rest...); }
+
+        constexpr size_t sum_of() { return 0; }
+        template <class... Rest>
+        constexpr size_t sum_of(size_t a, Rest... rest)
+        { return a + sum_of(rest...); }
+
+        inline size_t round_up(size_t n, size_t align) noexcept
+        { return (n + align - 1) / align * align; }
+
+        // 迁移时不会抛出异常的列
+        template <class T>
+        struct nothrow_relocate
+            : std::integral_constant<bool, is_trivially_relocatable<T>::value ||
+                                           std::is_nothrow_move_constructible<T>::value> {};
+    }
+
+    /*****************************************************************************************/
+    // soa_span
+    // 一列连续元素的视图，不拥有元素
+    /*****************************************************************************************/
+    template <class T>
+    struct soa_span
+    {
+        typedef T         value_type;
+        typedef T*        pointer;
+        typedef T*        iterator;
+        typedef T&        reference;
+        typedef size_t    size_type;
+
+        pointer   ptr;
+        size_type len;
+
+        soa_span() noexcept : ptr(nullptr), len(0) {}
+        soa_span(pointer p, size_type n) noexcept : ptr(p), len(n) {}
+
+        // soa_span<T> 可以转换为 soa_span<const T>
+        template <class U, typename std::enable_if<
+            std::is_convertible<U*, T*>::value, int>::type = 0>
+        soa_span(const soa_span<U>& rhs) noexcept : ptr(rhs.ptr), len(rhs.len) {}
+
+        pointer   data() const noexcept  { return ptr; }
+        size_type size() const noexcept  { return len; }
+        bool      empty() const noexcept { return len == 0; }
+        iterator  begin() const noexcept { return ptr; }
+        iterator  end() const noexcept   { return ptr + len; }
+
+        reference operator[](size_type n) const
+        {
+            DW_STL_DEBUG(n < len);
+            return ptr[n];
+        }
+    };
+
+    /*****************************************************************************************/
+    // soa_vector 的迭代器，Owner 为容器类型(const_iterator 为 const 容器)
+    /*****************************************************************************************/
+    template <class Owner, class Ref>
+    struct soa_vector_iterator
+        : public iterator<random_access_iterator_tag, typename std::remove_const<Owner>::type::value_type,
+                          ptrdiff_t, void, Ref>
+    {
+        typedef soa_vector_iterator                                  self;
+        typedef typename std::remove_const<Owner>::type::value_type  value_type;
+        typedef void                                                 pointer;
+        typedef Ref                                                  reference;
+        typedef size_t                                               size_type;
+        typedef ptrdiff_t                                            difference_type;
+
+        Owner*    vec;      // 所属的容器
+        size_type index;    // 元素的下标
+
+        soa_vector_iterator() noexcept : vec(nullptr), index(0) {}
+        soa_vector_iterator(Owner* v, size_type i) noexcept : vec(v), index(i) {}
+
+        // iterator 可以转换为 const_iterator
+        template <class O, class R, typename std::enable_if<
+            std::is_convertible<O*, Owner*>::value, int>::type = 0>
+        soa_vector_iterator(const soa_vector_iterator<O, R>& rhs) noexcept
+            : vec(rhs.vec), index(rhs.index) {}
+
+        reference operator*() const { return (*vec)[index]; }
+        reference operator[](difference_type n) const { return (*vec)[index + n]; }
+
+        self& operator++() noexcept { ++index; return *this; }
+        self  operator++(int) noexcept { self tmp = *this; ++index; return tmp; }
+        self& operator--() noexcept { --index; return *this; }
+        self  operator--(int) noexcept { self tmp = *this; --index; return tmp; }
+
+        self& operator+=(difference_type n) noexcept { index += n; return *this; }
+        self& operator-=(difference_type n) noexcept { index -= n; return *this; }
+        self  operator+(difference_type n) const noexcept { return self(vec, index + n); }
+        self  operator-(difference_type n) const noexcept { return self(vec, index - n); }
+
+        difference_type operator-(const self& x) const noexcept
+        { return static_cast<difference_type>(index) - static_cast<difference_type>(x.index); }
+
+        // 重载比较操作符
+        bool operator==(const self& rhs) const noexcept { return index == rhs.index; }
+        bool operator< (const self& rhs) const noexcept { return index < rhs.index; }
+        bool operator!=(const self& rhs) const noexcept { return !(*this == rhs); }
+        bool operator> (const self& rhs) const noexcept { return rhs < *this; }
+        bool operator<=(const self& rhs) const noexcept { return !(rhs < *this); }
+        bool operator>=(const self& rhs) const noexcept { return !(*this < rhs); }
+    };
+
+    // 模板类basic_soa_vector
+    // 模板参数Growth代表扩容策略，Fields代表每一列的数据类型
+    // 参数包之后不能有默认模板参数，soa_vector<Fields...>使用vector默认的扩容策略
+    template <class Growth, class... Fields>
+    class basic_soa_vector
+    {
+        static_assert(sizeof...(Fields) > 0, "soa_vector needs at least one field");
+    public:
+        typedef std::tuple<Fields...>                    value_type;
+        typedef std::tuple<Fields&...>                   reference;
+        typedef std::tuple<const Fields&...>             const_reference;
+        typedef size_t                                   size_type;
+        typedef ptrdiff_t                                difference_type;
+
+        typedef soa_vector_iterator<basic_soa_vector, reference>                   iterator;
+        typedef soa_vector_iterator<const basic_soa_vector, const_reference>       const_iterator;
+        typedef dw_stl::reverse_iterator<iterator>                                 reverse_iterator;
+        typedef dw_stl::reverse_iterator<const_iterator>                           const_reverse_iterator;
+
+        // 第I列的数据类型
+        template <size_t I>
+        using field_type = typename std::tuple_element<I, value_type>::type;
+
+        // 列数
+        static constexpr size_type columns = sizeof...(Fields);
+        // 每一列起始地址的对齐字节数
+        static constexpr size_type column_align =
+            soa_detail::max_of(size_t(DW_STL_CACHELINE_SIZE), alignof(Fields)...);
+
+    private:
+        typedef std::tuple<Fields*...>                                     column_pointers;
+        typedef typename soa_detail::make_index_seq<sizeof...(Fields)>::type indices;
+
+        template <size_t I>
+        using index_constant = std::integral_constant<size_t, I>;
+
+        char*           block_;     // 全部列所在的空间
+        column_pointers cols_;      // 每一列的首地址
+        size_type       size_;      // 元素个数
+        size_type       cap_;       // 每一列的容量
+
+    public:
+        // 构造、复制、移动、析构函数
+        basic_soa_vector() noexcept
+            : block_(nullptr), cols_(), size_(0), cap_(0) {}
+
+        explicit basic_soa_vector(size_type n)
+            : basic_soa_vector()
+        { resize(n); }
+
+        basic_soa_vector(size_type n, const value_type& value)
+            : basic_soa_vector()
+        { resize(n, value); }
+
+        basic_soa_vector(std::initializer_list<value_type> ilist)
+            : basic_soa_vector()
+        {
+            reserve(ilist.size());
+            for (auto& value : ilist)
+                push_back(value);
+        }
+
+        // 复制时只分配恰好需要的空间
+        basic_soa_vector(const basic_soa_vector& rhs)
+            : basic_soa_vector()
+        {
+            if (rhs.size_ == 0)
+                return;
+            char* block = allocate_block(rhs.size_);
+            column_pointers cols;
+            set_columns(block, rhs.size_, cols, indices());
+            try
+            {
+                copy_columns(rhs.cols_, cols, rhs.size_, index_constant<0>());
+            }
+            catch (...)
+            {
+                deallocate_block(block);
+                throw;
+            }
+            block_ = block;
+            cols_ = cols;
+            size_ = cap_ = rhs.size_;
+        }
+
+        basic_soa_vector(basic_soa_vector&& rhs) noexcept
+            : block_(rhs.block_), cols_(rhs.cols_), size_(rhs.size_), cap_(rhs.cap_)
+        { rhs.reset_members(); }
+
+        basic_soa_vector& operator=(const basic_soa_vector& rhs)
+        {
+            if (this != &rhs)
+            {
+                basic_soa_vector tmp(rhs);
+                swap(tmp);
+            }
+            return *this;
+        }
+
+        basic_soa_vector& operator=(basic_soa_vector&& rhs) noexcept
+        {
+            if (this != &rhs)
+            {
+                release();
+                block_ = rhs.block_;
+                cols_ = rhs.cols_;
+                size_ = rhs.size_;
+                cap_ = rhs.cap_;
+                rhs.reset_members();
+            }
+            return *this;
+        }
+
+        ~basic_soa_vector()
+        { release(); }
+
+    public:
+        // 迭代器相关操作
+        iterator begin() noexcept
+        { return iterator(this, 0); }
+        const_iterator begin() const noexcept
+        { return const_iterator(this, 0); }
+        iterator end() noexcept
+        { return iterator(this, size_); }
+        const_iterator end() const noexcept
+        { return const_iterator(this, size_); }
+
+        reverse_iterator rbegin() noexcept
+        { return reverse_iterator(end()); }
+        const_reverse_iterator rbegin() const noexcept
+        { return const_reverse_iterator(end()); }
+        reverse_iterator rend() noexcept
+        { return reverse_iterator(begin()); }
+        const_reverse_iterator rend() const noexcept
+        { return const_reverse_iterator(begin()); }
+
+        const_iterator cbegin() const noexcept
+        { return begin(); }
+        const_iterator cend() const noexcept
+        { return end(); }
+
+        // 容量相关操作
+        bool empty() const noexcept
+        { return size_ == 0; }
+        size_type size() const noexcept
+        { return size_; }
+        size_type capacity() const noexcept
+        { return cap_; }
+        // 留出每一列按column_align补齐的空间
+        size_type max_size() const noexcept
+        {
+            return (static_cast<size_type>(-1) - columns * column_align) /
+                soa_detail::sum_of(sizeof(Fields)...);
+        }
+
+        void reserve(size_type n)
+        {
+            THROW_LENGTH_ERROR_IF(n > max_size(), "n can not larger than max_size() in soa_vector<T>::reserve(n)");
+            if (n > cap_)
+                reallocate(n);
+        }
+
+        void shrink_to_fit()
+        {
+            if (size_ == cap_)
+                return;
+            if (size_ == 0)
+            {
+                release();
+                return;
+            }
+            reallocate(size_);
+        }
+
+        // 访问元素相关操作，返回代理类型
+        reference operator[](size_type n)
+        {
+            DW_STL_DEBUG(n < size_);
+            return row(n, indices());
+        }
+        const_reference operator[](size_type n) const
+        {
+            DW_STL_DEBUG(n < size_);
+            return row(n, indices());
+        }
+
+        reference at(size_type n)
+        {
+            THROW_OUT_OF_RANGE_IF(!(n < size_), "soa_vector<T>::at() subscript out of range");
+            return (*this)[n];
+        }
+        const_reference at(size_type n) const
+        {
+            THROW_OUT_OF_RANGE_IF(!(n < size_), "soa_vector<T>::at() subscript out of range");
+            return (*this)[n];
+        }
+
+        reference front()
+        { return (*this)[0]; }
+        const_reference front() const
+        { return (*this)[0]; }
+        reference back()
+        { return (*this)[size_ - 1]; }
+        const_reference back() const
+        { return (*this)[size_ - 1]; }
+
+        // 第n个元素的第I个字段
+        template <size_t I>
+        field_type<I>& get(size_type n)
+        {
+            DW_STL_DEBUG(n < size_);
+            return std::get<I>(cols_)[n];
+        }
+        template <size_t I>
+        const field_type<I>& get(size_type n) const
+        {
+            DW_STL_DEBUG(n < size_);
+            return std::get<I>(cols_)[n];
+        }
+
+        // 第I列的首地址，按column_align对齐
+        template <size_t I>
+        field_type<I>* data() noexcept
+        { return std::get<I>(cols_); }
+        template <size_t I>
+        const field_type<I>* data() const noexcept
+        { return std::get<I>(cols_); }
+
+        // 第I列的全部元素
+        template <size_t I>
+        soa_span<field_type<I>> column() noexcept
+        { return soa_span<field_type<I>>(std::get<I>(cols_), size_); }
+        template <size_t I>
+        soa_span<const field_type<I>> column() const noexcept
+        { return soa_span<const field_type<I>>(std::get<I>(cols_), size_); }
+
+        // 修改容器相关操作
+        // 每个参数构造对应的一列；没有参数时每一列都值初始化
+        template <class... Args>
+        void emplace_back(Args&& ...args)
+        {
+            static_assert(sizeof...(Args) == 0 || sizeof...(Args) == sizeof...(Fields),
+                          "soa_vector<T>::emplace_back needs one argument per field");
+            auto t = std::forward_as_tuple(dw_stl::forward<Args>(args)...);
+            if (size_ < cap_)
+            {
+                construct_row(cols_, size_, t, index_constant<0>());
+                ++size_;
+            }
+            else
+                reallocate_emplace(t);
+        }
+
+        void push_back(const value_type& value)
+        { push_back_aux(value, indices()); }
+        void push_back(value_type&& value)
+        { push_back_aux(dw_stl::move(value), indices()); }
+
+        void pop_back()
+        {
+            DW_STL_DEBUG(!empty());
+            --size_;
+            destroy_row(cols_, size_, indices());
+        }
+
+        void resize(size_type new_size)
+        {
+            if (new_size < size_)
+                erase_to_end(new_size);
+            else
+            {
+                reserve(new_size);
+                while (size_ < new_size)
+                    emplace_back();
+            }
+        }
+        void resize(size_type new_size, const value_type& value)
+        {
+            if (new_size < size_)
+                erase_to_end(new_size);
+            else
+            {
+                reserve(new_size);
+                while (size_ < new_size)
+                    push_back(value);
+            }
+        }
+
+        void clear() noexcept
+        { erase_to_end(0); }
+
+        void swap(basic_soa_vector& rhs) noexcept
+        {
+            if (this != &rhs)
+            {
+                dw_stl::swap(block_, rhs.block_);
+                std::swap(cols_, rhs.cols_);
+                dw_stl::swap(size_, rhs.size_);
+                dw_stl::swap(cap_, rhs.cap_);
+            }
+        }
+
+    private:
+        template <size_t... I>
+        reference row(size_type n, soa_detail::index_seq<I...>) noexcept
+        { return reference(std::get<I>(cols_)[n]...); }
+        template <size_t... I>
+        const_reference row(size_type n, soa_detail::index_seq<I...>) const noexcept
+        { return const_reference(std::get<I>(cols_)[n]...); }
+
+        template <class Tuple, size_t... I>
+        void push_back_aux(Tuple&& value, soa_detail::index_seq<I...>)
+        { emplace_back(std::get<I>(dw_stl::forward<Tuple>(value))...); }
+
+        void reset_members() noexcept
+        {
+            block_ = nullptr;
+            cols_ = column_pointers();
+            size_ = cap_ = 0;
+        }
+
+        // 容量为cap时全部列占用的字节数
+        static size_type block_bytes(size_type cap) noexcept
+        {
+            size_type bytes = 0;
+            (void)soa_detail::expand{0, (bytes += soa_detail::round_up(cap * sizeof(Fields), column_align), 0)...};
+            return bytes;
+        }
+
+        static char* allocate_block(size_type cap)
+        { return static_cast<char*>(aligned_alloc::allocate(block_bytes(cap), column_align)); }
+
+        static void deallocate_block(char* block) noexcept
+        {
+            if (block != nullptr)
+                aligned_alloc::deallocate(block, column_align);
+        }
+
+        // 按容量cap计算每一列在block中的首地址
+        template <size_t... I>
+        static void set_columns(char* block, size_type cap, column_pointers& cols, soa_detail::index_seq<I...>) noexcept
+        {
+            size_type offset = 0;
+            (void)soa_detail::expand{0, (std::get<I>(cols) = reinterpret_cast<Fields*>(block + offset),
+                offset += soa_detail::round_up(cap * sizeof(Fields), column_align), 0)...};
+        }
+
+        // 在每一列的第n个位置构造元素，某一列抛出异常时析构已经构造的列
+        template <class Tuple, size_t I>
+        static void construct_row(const column_pointers& cols, size_type n, Tuple& args, index_constant<I>)
+        {
+            auto p = std::get<I>(cols) + n;
+            construct_field(p, args, index_constant<I>(), std::integral_constant<bool, std::tuple_size<Tuple>::value == 0>());
+            try
+            {
+                construct_row(cols, n, args, index_constant<I + 1>());
+            }
+            catch (...)
+            {
+                dw_stl::destroy(p);
+                throw;
+            }
+        }
+        template <class Tuple>
+        static void construct_row(const column_pointers&, size_type, Tuple&, index_constant<sizeof...(Fields)>) {}
+
+        template <class T, class Tuple, size_t I>
+        static void construct_field(T* p, Tuple&, index_constant<I>, std::true_type)
+        { dw_stl::construct(p); }
+        template <class T, class Tuple, size_t I>
+        static void construct_field(T* p, Tuple& args, index_constant<I>, std::false_type)
+        { dw_stl::construct(p, dw_stl::forward<typename std::tuple_element<I, Tuple>::type>(std::get<I>(args))); }
+
+        // 把前n个元素逐列复制到dst，某一列抛出异常时析构已经复制的列
+        template <size_t I>
+        static void copy_columns(const column_pointers& src, const column_pointers& dst, size_type n, index_constant<I>)
+        {
+            auto s = std::get<I>(src);
+            auto d = std::get<I>(dst);
+            dw_stl::uninitialized_copy(s, s + n, d);
+            try
+            {
+                copy_columns(src, dst, n, index_constant<I + 1>());
+            }
+            catch (...)
+            {
+                dw_stl::destroy(d, d + n);
+                throw;
+            }
+        }
+        static void copy_columns(const column_pointers&, const column_pointers&, size_type, index_constant<sizeof...(Fields)>) {}
+
+        // 迁移的第一步：移动构造可能抛出异常的列先复制到dst
+        // 按 nothrow_relocate 分派，只有需要复制的列才实例化复制构造；
+        // 移动构造可能抛出异常又不能复制的列只能移动，这时 reserve/emplace_back 只满足基本异常保证
+        template <class T>
+        static void copy_unsafe_column(T*, T*, size_type, std::true_type) noexcept {}
+        template <class T>
+        static void copy_unsafe_column(T* s, T* d, size_type n, std::false_type)
+        { copy_or_move_column(s, d, n, std::is_copy_constructible<T>()); }
+        template <class T>
+        static void copy_or_move_column(T* s, T* d, size_type n, std::true_type)
+        { dw_stl::uninitialized_copy(s, s + n, d); }
+        template <class T>
+        static void copy_or_move_column(T* s, T* d, size_type n, std::false_type)
+        { dw_stl::uninitialized_move(s, s + n, d); }
+
+        template <class T>
+        static void destroy_unsafe_column(T*, size_type, std::true_type) noexcept {}
+        template <class T>
+        static void destroy_unsafe_column(T* d, size_type n, std::false_type) noexcept
+        { dw_stl::destroy(d, d + n); }
+
+        template <size_t I>
+        static void copy_unsafe_columns(const column_pointers& src, const column_pointers& dst, size_type n, index_constant<I>)
+        {
+            typedef soa_detail::nothrow_relocate<field_type<I>> relocate;
+            auto d = std::get<I>(dst);
+            copy_unsafe_column(std::get<I>(src), d, n, relocate());
+            try
+            {
+                copy_unsafe_columns(src, dst, n, index_constant<I + 1>());
+            }
+            catch (...)
+            {
+                destroy_unsafe_column(d, n, relocate());
+                throw;
+            }
+        }
+        static void copy_unsafe_columns(const column_pointers&, const column_pointers&, size_type, index_constant<sizeof...(Fields)>) {}
+
+        // 迁移的第二步：其余的列迁移到dst，已经复制的列析构原来的元素，不会抛出异常
+        template <class T>
+        static void finish_column(T* s, T* d, size_type n, std::true_type) noexcept
+        { dw_stl::uninitialized_relocate(s, s + n, d); }
+        template <class T>
+        static void finish_column(T* s, T*, size_type n, std::false_type) noexcept
+        { dw_stl::destroy(s, s + n); }
+
+        template <size_t... I>
+        static void finish_columns(const column_pointers& src, const column_pointers& dst, size_type n,
+                                   soa_detail::index_seq<I...>) noexcept
+        {
+            (void)soa_detail::expand{0, (finish_column(std::get<I>(src), std::get<I>(dst), n,
+                soa_detail::nothrow_relocate<Fields>()), 0)...};
+        }
+
+        // 把全部元素迁移到容量为new_cap的新空间
+        void reallocate(size_type new_cap)
+        {
+            char* block = allocate_block(new_cap);
+            column_pointers cols;
+            set_columns(block, new_cap, cols, indices());
+            try
+            {
+                copy_unsafe_columns(cols_, cols, size_, index_constant<0>());
+            }
+            catch (...)
+            {
+                deallocate_block(block);
+                throw;
+            }
+            finish_columns(cols_, cols, size_, indices());
+            deallocate_block(block_);
+            block_ = block;
+            cols_ = cols;
+            cap_ = new_cap;
+        }
+
+        // 空间已满时先在新空间中构造新元素，参数引用容器中的元素时仍然有效，再迁移原来的元素
+        template <class Tuple>
+        void reallocate_emplace(Tuple& args)
+        {
+            THROW_LENGTH_ERROR_IF(size_ == max_size(), "soa_vector<T> size too big");
+            const size_type new_cap = Growth::grow(cap_, size_ + 1,
+                static_cast<size_type>(vector_init_cap<value_type>::value), max_size());
+            char* block = allocate_block(new_cap);
+            column_pointers cols;
+            set_columns(block, new_cap, cols, indices());
+            try
+            {
+                construct_row(cols, size_, args, index_constant<0>());
+                try
+                {
+                    copy_unsafe_columns(cols_, cols, size_, index_constant<0>());
+                }
+                catch (...)
+                {
+                    destroy_row(cols, size_, indices());
+                    throw;
+                }
+            }
+            catch (...)
+            {
+                deallocate_block(block);
+                throw;
+            }
+            finish_columns(cols_, cols, size_, indices());
+            deallocate_block(block_);
+            block_ = block;
+            cols_ = cols;
+            cap_ = new_cap;
+            ++size_;
+        }
+
+        template <size_t... I>
+        static void destroy_row(const column_pointers& cols, size_type n, soa_detail::index_seq<I...>) noexcept
+        { (void)soa_detail::expand{0, (dw_stl::destroy(std::get<I>(cols) + n), 0)...}; }
+
+        template <size_t... I>
+        void destroy_range(size_type first, size_type last, soa_detail::index_seq<I...>) noexcept
+        { (void)soa_detail::expand{0, (dw_stl::destroy(std::get<I>(cols_) + first, std::get<I>(cols_) + last), 0)...}; }
+
+        void erase_to_end(size_type n) noexcept
+        {
+            destroy_range(n, size_, indices());
+            size_ = n;
+        }
+
+        void release() noexcept
+        {
+            erase_to_end(0);
+            deallocate_block(block_);
+            reset_members();
+        }
+    };
+
+    template <class Growth, class... Fields>
+    constexpr typename basic_soa_vector<Growth, Fields...>::size_type basic_soa_vector<Growth, Fields...>::columns;
+
+    template <class Growth, class... Fields>
+    constexpr typename basic_soa_vector<Growth, Fields...>::size_type basic_soa_vector<Growth, Fields...>::column_align;
+
+    // 使用vector默认扩容策略的soa_vector
+    template <class... Fields>
+    using soa_vector = basic_soa_vector<DW_STL_VECTOR_DEFAULT_GROWTH, Fields...>;
+
+    /****************************************************************************/
+    // 重载比较操作符
+    template <class Growth, class... Fields>
+    bool operator==(const basic_soa_vector<Growth, Fields...>& lhs, const basic_soa_vector<Growth, Fields...>& rhs)
+    {
+        return lhs.size() == rhs.size() &&
+            dw_stl::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+
+    template <class Growth, class... Fields>
+    bool operator!=(const basic_soa_vector<Growth, Fields...>& lhs, const basic_soa_vector<Growth, Fields...>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    // 重载dw_stl的swap
+    template <class Growth, class... Fields>
+    void swap(basic_soa_vector<Growth, Fields...>& lhs, basic_soa_vector<Growth, Fields...>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+
+    // basic_soa_vector只保存指向空间的指针，可以按字节移动
+    template <class Growth, class... Fields>
+    struct is_trivially_relocatable<basic_soa_vector<Growth, Fields...>> : std::true_type {};
+}
+
+#endif
@@ -5,6 +5,7 @@
 // 默认使用deque来实现
 
 #include "deque.h"
+#include "allocator_traits.h"
 
 namespace dw_stl
 {
@@ -13,6 +14,7 @@ namespace dw_stl
     模板类堆栈stack
     参数一代表数据类型
     参数二代表底层容器类型，默认使用dw_stl::deque作为底层容器
+    如果底层容器使用自定义的分配器，可以通过带分配器的构造函数把分配器转发给底层容器
     */
     template <class T, class Sequence = dw_stl::deque<T>>
     class stack
@@ -56,6 +58,27 @@ namespace dw_stl
         stack(stack &&rhs) noexcept(std::is_nothrow_move_constructible<Sequence>::value)
             : c(dw_stl::move(rhs.c)) {}
 
+        // 带分配器的构造函数，分配器会被转发给底层容器
+        template <class Alloc, typename std::enable_if<
+            dw_stl::uses_allocator<Sequence, Alloc>::value, int>::type = 0>
+        explicit stack(const Alloc &alloc) : c(alloc) {}
+
+        template <class Alloc, typename std::enable_if<
+            dw_stl::uses_allocator<Sequence, Alloc>::value, int>::type = 0>
+        stack(const Sequence &c_, const Alloc &alloc) : c(c_, alloc) {}
+
+        template <class Alloc, typename std::enable_if<
+            dw_stl::uses_allocator<Sequence, Alloc>::value, int>::type = 0>
+        stack(Sequence &&c_, const Alloc &alloc) : c(dw_stl::move(c_), alloc) {}
+
+        template <class Alloc, typename std::enable_if<
+            dw_stl::uses_allocator<Sequence, Alloc>::value, int>::type = 0>
+        stack(const stack &rhs, const Alloc &alloc) : c(rhs.c, alloc) {}
+
+        template <class Alloc, typename std::enable_if<
+            dw_stl::uses_allocator<Sequence, Alloc>::value, int>::type = 0>
+        stack(stack &&rhs, const Alloc &alloc) : c(dw_stl::move(rhs.c), alloc) {}
+
         // 左值引用
         stack &operator=(const stack &rhs)
         {
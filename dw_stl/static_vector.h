@@ -0,0 +1,661 @@
+#ifndef DW_STL_STATIC_VECTOR_H_
+#define DW_STL_STATIC_VECTOR_H_
+
+/*
+这个头文件用于实现模板类 static_vector<T, N>
+
+static_vector 的元素全部保存在对象内部，容量固定为 N，不使用分配器，任何操作都不会申请内存：
+    接口与 vector 相同，元素个数超过 N 时抛出 std::length_error
+    try_push_back / try_emplace_back 在已满时返回 nullptr 而不抛出异常，适合不允许异常的热路径
+    T 可以平凡复制时 static_vector 本身也可以平凡复制，可以直接 memcpy 或者放在共享内存中
+    capacity()、max_size() 是 constexpr 函数
+
+元素用 construct.h 与 uninitialized.h 中的函数构造、析构与迁移
+注意：移动构造与移动赋值只移动每个元素，rhs 保留原来的元素个数，元素处于被移动之后的状态
+
+异常保证：
+    dw_stl::static_vector<T, N> 满足基本异常保证，并对以下函数做强异常安全保证：
+        emplace_back
+        push_back
+        元素可以按字节迁移时的 emplace、insert
+*/
+
+#include <initializer_list>
+
+#include "iterator.h"
+#include "util.h"
+#include "exceptdef.h"
+#include "construct.h"
+#include "algorithm.h"
+#include "uninitialized.h"
+
+namespace dw_stl
+{
+    // static_vector_base保存元素的空间，元素可以平凡复制时使用默认的复制、移动与析构函数，
+    // 这样static_vector本身也可以平凡复制
+    template <class T, size_t N, bool = std::is_trivially_copyable<T>::value>
+    class static_vector_base
+    {
+    protected:
+        typedef typename std::aligned_storage<sizeof(T), alignof(T)>::type raw_storage;
+
+        raw_storage storage_[N == 0 ? 1 : N];   // 元素的空间
+        size_t      size_;                      // 元素个数
+
+        static_vector_base() noexcept : size_(0) {}
+
+        T* data_ptr() noexcept
+        { return reinterpret_cast<T*>(storage_); }
+        const T* data_ptr() const noexcept
+        { return reinterpret_cast<const T*>(storage_); }
+    };
+
+    template <class T, size_t N>
+    class static_vector_base<T, N, false>
+    {
+    protected:
+        typedef typename std::aligned_storage<sizeof(T), alignof(T)>::type raw_storage;
+
+        raw_storage storage_[N == 0 ? 1 : N];   // 元素的空间
+        size_t      size_;                      // 元素个数
+
+        static_vector_base() noexcept : size_(0) {}
+
+        static_vector_base(const static_vector_base& rhs) : size_(0)
+        {
+            dw_stl::uninitialized_copy(rhs.data_ptr(), rhs.data_ptr() + rhs.size_, data_ptr());
+            size_ = rhs.size_;
+        }
+
+        static_vector_base(static_vector_base&& rhs) noexcept(std::is_nothrow_move_constructible<T>::value)
+            : size_(0)
+        {
+            dw_stl::uninitialized_move(rhs.data_ptr(), rhs.data_ptr() + rhs.size_, data_ptr());
+            size_ = rhs.size_;
+        }
+
+        static_vector_base& operator=(const static_vector_base& rhs)
+        {
+            if (this != &rhs)
+                assign_from(rhs.data_ptr(), rhs.size_, [](T& dst, const T& src) { dst = src; },
+                            [](const T* first, const T* last, T* result) { return dw_stl::uninitialized_copy(first, last, result); });
+            return *this;
+        }
+
+        static_vector_base& operator=(static_vector_base&& rhs)
+            noexcept(std::is_nothrow_move_constructible<T>::value && std::is_nothrow_move_assignable<T>::value)
+        {
+            if (this != &rhs)
+                assign_from(rhs.data_ptr(), rhs.size_, [](T& dst, T& src) { dst = dw_stl::move(src); },
+                            [](T* first, T* last, T* result) { return dw_stl::uninitialized_move(first, last, result); });
+            return *this;
+        }
+
+        ~static_vector_base()
+        {
+            dw_stl::destroy(data_ptr(), data_ptr() + size_);
+        }
+
+        T* data_ptr() noexcept
+        { return reinterpret_cast<T*>(storage_); }
+        const T* data_ptr() const noexcept
+        { return reinterpret_cast<const T*>(storage_); }
+
+    private:
+        // 前面共同的部分逐个赋值，多出的部分构造或者析构
+        template <class Ptr, class Assign, class Construct>
+        void assign_from(Ptr src, size_t n, Assign assign, Construct construct)
+        {
+            T* dst = data_ptr();
+            const size_t common = size_ < n ? size_ : n;
+            for (size_t i = 0; i < common; ++i)
+                assign(dst[i], src[i]);
+            if (n > size_)
+            {
+                construct(src + size_, src + n, dst + size_);
+            }
+            else
+            {
+                dw_stl::destroy(dst + n, dst + size_);
+            }
+            size_ = n;
+        }
+    };
+
+    // static_vector模板类
+    // 模板参数T代表数据类型，N代表容量
+    template <class T, size_t N>
+    class static_vector : private static_vector_base<T, N>
+    {
+        static_assert(!std::is_same<bool, T>::value, "static_vector<bool> is abandoned");
+    public:
+        typedef T                                        value_type;
+        typedef T*                                       pointer;
+        typedef const T*                                 const_pointer;
+        typedef value_type&                              reference;
+        typedef const value_type&                        const_reference;
+        typedef size_t                                   size_type;
+        typedef ptrdiff_t                                difference_type;
+
+        typedef value_type*                              iterator;
+        typedef const value_type*                        const_iterator;
+
+        typedef dw_stl::reverse_iterator<iterator>        reverse_iterator;
+        typedef dw_stl::reverse_iterator<const_iterator>  const_reverse_iterator;
+
+    private:
+        typedef static_vector_base<T, N>                 base;
+        typedef typename base::raw_storage               raw_storage;
+
+        // 元素可以按字节迁移时，插入、删除都整块挪动元素，不需要逐个移动构造和析构
+        typedef dw_stl::is_trivially_relocatable<T>      can_relocate;
+
+        using base::size_;
+        using base::data_ptr;
+
+    public:
+        // 构造函数，复制、移动、析构函数由static_vector_base决定
+        static_vector() noexcept {}
+
+        explicit static_vector(size_type n)
+        { fill_insert(end(), n, value_type()); }
+
+        static_vector(size_type n, const value_type& value)
+        { fill_insert(end(), n, value); }
+
+        template <class Iter, typename std::enable_if<
+            dw_stl::is_input_iterator<Iter>::value, int>::type = 0>
+        static_vector(Iter first, Iter last)
+        { copy_insert(end(), first, last, iterator_category(first)); }
+
+        static_vector(std::initializer_list<value_type> ilist)
+        { copy_insert(end(), ilist.begin(), ilist.end(), dw_stl::forward_iterator_tag()); }
+
+        static_vector& operator=(std::initializer_list<value_type> ilist)
+        {
+            copy_assign(ilist.begin(), ilist.end(), dw_stl::forward_iterator_tag());
+            return *this;
+        }
+
+    public:
+        // 迭代器相关操作
+        iterator begin() noexcept
+        { return data_ptr(); }
+        const_iterator begin() const noexcept
+        { return data_ptr(); }
+        iterator end() noexcept
+        { return data_ptr() + size_; }
+        const_iterator end() const noexcept
+        { return data_ptr() + size_; }
+
+        reverse_iterator rbegin() noexcept
+        { return reverse_iterator(end()); }
+        const_reverse_iterator rbegin() const noexcept
+        { return const_reverse_iterator(end()); }
+        reverse_iterator rend() noexcept
+        { return reverse_iterator(begin()); }
+        const_reverse_iterator rend() const noexcept
+        { return const_reverse_iterator(begin()); }
+
+        const_iterator cbegin() const noexcept
+        { return begin(); }
+        const_iterator cend() const noexcept
+        { return end(); }
+        const_reverse_iterator crbegin() const noexcept
+        { return rbegin(); }
+        const_reverse_iterator crend() const noexcept
+        { return rend(); }
+
+        // 容量相关操作
+        bool empty() const noexcept
+        { return size_ == 0; }
+        bool full() const noexcept
+        { return size_ == N; }
+        size_type size() const noexcept
+        { return size_; }
+        static constexpr size_type max_size() noexcept
+        { return N; }
+        static constexpr size_type capacity() noexcept
+        { return N; }
+        // 容量固定，只检查n是否超过容量
+        void reserve(size_type n)
+        { THROW_LENGTH_ERROR_IF(n > N, "n can not larger than capacity() in static_vector<T, N>::reserve(n)"); }
+        void shrink_to_fit() noexcept {}
+
+        // 访问元素相关操作
+        reference operator[](size_type n)
+        {
+            DW_STL_DEBUG(n < size());
+            return data_ptr()[n];
+        }
+        const_reference operator[](size_type n) const
+        {
+            DW_STL_DEBUG(n < size());
+            return data_ptr()[n];
+        }
+        reference at(size_type n)
+        {
+            THROW_OUT_OF_RANGE_IF(!(n < size()), "static_vector<T, N>::at() subscript out of range");
+            return (*this)[n];
+        }
+        const_reference at(size_type n) const
+        {
+            THROW_OUT_OF_RANGE_IF(!(n < size()), "static_vector<T, N>::at() subscript out of range");
+            return (*this)[n];
+        }
+
+        reference front()
+        {
+            DW_STL_DEBUG(!empty());
+            return *begin();
+        }
+        const_reference front() const
+        {
+            DW_STL_DEBUG(!empty());
+            return *begin();
+        }
+        reference back()
+        {
+            DW_STL_DEBUG(!empty());
+            return *(end() - 1);
+        }
+        const_reference back() const
+        {
+            DW_STL_DEBUG(!empty());
+            return *(end() - 1);
+        }
+
+        pointer data() noexcept { return data_ptr(); }
+        const_pointer data() const noexcept { return data_ptr(); }
+
+        // 修改容器相关操作
+        void assign(size_type n, const value_type& value)
+        { fill_assign(n, value); }
+
+        template <class Iter, typename std::enable_if<
+            dw_stl::is_input_iterator<Iter>::value, int>::type = 0>
+        void assign(Iter first, Iter last)
+        { copy_assign(first, last, iterator_category(first)); }
+
+        void assign(std::initializer_list<value_type> il)
+        { copy_assign(il.begin(), il.end(), dw_stl::forward_iterator_tag{}); }
+
+        template <class... Args>
+        iterator emplace(const_iterator pos, Args&& ...args);
+
+        template <class... Args>
+        reference emplace_back(Args&& ...args)
+        {
+            THROW_LENGTH_ERROR_IF(full(), "static_vector<T, N> is full");
+            dw_stl::construct(end(), dw_stl::forward<Args>(args)...);
+            ++size_;
+            return back();
+        }
+
+        // 已满时返回nullptr，否则返回新元素的地址
+        template <class... Args>
+        pointer try_emplace_back(Args&& ...args)
+        {
+            if (full())
+                return nullptr;
+            dw_stl::construct(end(), dw_stl::forward<Args>(args)...);
+            ++size_;
+            return end() - 1;
+        }
+
+        void push_back(const value_type& value)
+        { emplace_back(value); }
+        void push_back(value_type&& value)
+        { emplace_back(dw_stl::move(value)); }
+
+        pointer try_push_back(const value_type& value)
+        { return try_emplace_back(value); }
+        pointer try_push_back(value_type&& value)
+        { return try_emplace_back(dw_stl::move(value)); }
+
+        void pop_back()
+        {
+            DW_STL_DEBUG(!empty());
+            --size_;
+            dw_stl::destroy(end());
+        }
+
+        iterator insert(const_iterator pos, const value_type& value)
+        { return emplace(pos, value); }
+        iterator insert(const_iterator pos, value_type&& value)
+        { return emplace(pos, dw_stl::move(value)); }
+
+        iterator insert(const_iterator pos, size_type n, const value_type& value)
+        {
+            DW_STL_DEBUG(pos >= begin() && pos <= end());
+            return fill_insert(const_cast<iterator>(pos), n, value);
+        }
+
+        template <class Iter, typename std::enable_if<
+            dw_stl::is_input_iterator<Iter>::value, int>::type = 0>
+        iterator insert(const_iterator pos, Iter first, Iter last)
+        {
+            DW_STL_DEBUG(pos >= begin() && pos <= end());
+            return copy_insert(const_cast<iterator>(pos), first, last, iterator_category(first));
+        }
+
+        iterator insert(const_iterator pos, std::initializer_list<value_type> ilist)
+        {
+            DW_STL_DEBUG(pos >= begin() && pos <= end());
+            return copy_insert(const_cast<iterator>(pos), ilist.begin(), ilist.end(),
+                               dw_stl::forward_iterator_tag());
+        }
+
+        iterator erase(const_iterator pos)
+        { return erase(pos, pos + 1); }
+        iterator erase(const_iterator first, const_iterator last);
+        void clear() noexcept
+        {
+            dw_stl::destroy(begin(), end());
+            size_ = 0;
+        }
+
+        void resize(size_type new_size) { resize(new_size, value_type()); }
+        void resize(size_type new_size, const value_type& value);
+
+        void swap(static_vector& rhs);
+
+    private:
+        void fill_assign(size_type n, const value_type& value);
+        template <class InputIter>
+        void copy_assign(InputIter first, InputIter last, input_iterator_tag);
+        template <class FIter>
+        void copy_assign(FIter first, FIter last, forward_iterator_tag);
+
+        iterator fill_insert(iterator pos, size_type n, const value_type& value);
+        template <class InputIter>
+        iterator copy_insert(iterator pos, InputIter first, InputIter last, input_iterator_tag);
+        template <class FIter>
+        iterator copy_insert(iterator pos, FIter first, FIter last, forward_iterator_tag);
+
+        // 把[pos, end())后移n个单元，再用construct构造空出的n个单元，调用前已经检查过容量
+        template <class Construct>
+        void insert_in_place(iterator pos, size_type n, Construct construct);
+    };
+
+    /****************************************************************************/
+
+    // emplace函数，在pos处就地构造元素
+    template <class T, size_t N>
+    template <class ...Args>
+    typename static_vector<T, N>::iterator
+    static_vector<T, N>::emplace(const_iterator pos, Args&& ...args)
+    {
+        DW_STL_DEBUG(pos >= begin() && pos <= end());
+        THROW_LENGTH_ERROR_IF(full(), "static_vector<T, N> is full");
+        iterator xpos = const_cast<iterator>(pos);
+        if (xpos == end())
+        {
+            dw_stl::construct(xpos, dw_stl::forward<Args>(args)...);
+            ++size_;
+        }
+        else if (can_relocate::value)
+        {
+            // 参数可能引用容器内部的元素，先在临时空间构造，再整块挪动后面的元素
+            raw_storage buf;
+            auto tmp = reinterpret_cast<T*>(&buf);
+            dw_stl::construct(tmp, dw_stl::forward<Args>(args)...);
+            dw_stl::uninitialized_relocate(xpos, end(), xpos + 1);
+            dw_stl::uninitialized_relocate(tmp, tmp + 1, xpos);
+            ++size_;
+        }
+        else
+        {
+            value_type value_copy(dw_stl::forward<Args>(args)...);
+            iterator old_end = end();
+            dw_stl::construct(old_end, dw_stl::move(*(old_end - 1)));
+            ++size_;
+            dw_stl::move_backward(xpos, old_end - 1, old_end);
+            *xpos = dw_stl::move(value_copy);
+        }
+        return xpos;
+    }
+
+    // 删除[first, last)上的元素
+    template <class T, size_t N>
+    typename static_vector<T, N>::iterator
+    static_vector<T, N>::erase(const_iterator first, const_iterator last)
+    {
+        DW_STL_DEBUG(first >= begin() && last <= end() && !(last < first));
+        iterator xfirst = const_cast<iterator>(first);
+        iterator xlast = const_cast<iterator>(last);
+        if (xfirst == xlast)
+            return xfirst;
+        if (can_relocate::value)
+        {
+            dw_stl::destroy(xfirst, xlast);
+            dw_stl::uninitialized_relocate(xlast, end(), xfirst);
+        }
+        else
+        {
+            auto new_end = dw_stl::move(xlast, end(), xfirst);
+            dw_stl::destroy(new_end, end());
+        }
+        size_ -= static_cast<size_type>(xlast - xfirst);
+        return xfirst;
+    }
+
+    // 重置容器大小
+    template <class T, size_t N>
+    void static_vector<T, N>::resize(size_type new_size, const value_type& value)
+    {
+        if (new_size < size())
+            erase(begin() + new_size, end());
+        else
+            fill_insert(end(), new_size - size(), value);
+    }
+
+    // 交换两个static_vector，前面共同的部分逐个交换，多出的部分移动到较短的一方
+    template <class T, size_t N>
+    void static_vector<T, N>::swap(static_vector& rhs)
+    {
+        if (this == &rhs)
+            return;
+        static_vector& longer = size() < rhs.size() ? rhs : *this;
+        static_vector& shorter = size() < rhs.size() ? *this : rhs;
+        const size_type common = shorter.size();
+        for (size_type i = 0; i < common; ++i)
+            dw_stl::swap(shorter[i], longer[i]);
+        dw_stl::uninitialized_move(longer.begin() + common, longer.end(), shorter.end());
+        shorter.size_ = longer.size_;
+        dw_stl::destroy(longer.begin() + common, longer.end());
+        longer.size_ = common;
+    }
+
+    /****************************************************************************/
+    // 下面是实现接口用到的一些辅助函数
+    /****************************************************************************/
+
+    // fill_assign函数
+    template <class T, size_t N>
+    void static_vector<T, N>::fill_assign(size_type n, const value_type& value)
+    {
+        THROW_LENGTH_ERROR_IF(n > N, "static_vector<T, N> size too big");
+        if (n > size())
+        {
+            const value_type value_copy = value;
+            dw_stl::fill(begin(), end(), value_copy);
+            dw_stl::uninitialized_fill_n(end(), n - size(), value_copy);
+            size_ = n;
+        }
+        else
+        {
+            erase(dw_stl::fill_n(begin(), n, value), end());
+        }
+    }
+
+    // copy_assign函数
+    template <class T, size_t N>
+    template <class InputIter>
+    void static_vector<T, N>::copy_assign(InputIter first, InputIter last, input_iterator_tag)
+    {
+        auto cur = begin();
+        for (; first != last && cur != end(); ++first, ++cur)
+            *cur = *first;
+        if (first == last)
+            erase(cur, end());
+        else
+            copy_insert(end(), first, last, input_iterator_tag());
+    }
+
+    template <class T, size_t N>
+    template <class FIter>
+    void static_vector<T, N>::copy_assign(FIter first, FIter last, forward_iterator_tag)
+    {
+        const size_type len = dw_stl::distance(first, last);
+        THROW_LENGTH_ERROR_IF(len > N, "static_vector<T, N> size too big");
+        if (size() >= len)
+        {
+            erase(dw_stl::copy(first, last, begin()), end());
+        }
+        else
+        {
+            auto mid = first;
+            dw_stl::advance(mid, size());
+            dw_stl::copy(first, mid, begin());
+            dw_stl::uninitialized_copy(mid, last, end());
+            size_ = len;
+        }
+    }
+
+    // insert_in_place函数
+    template <class T, size_t N>
+    template <class Construct>
+    void static_vector<T, N>::insert_in_place(iterator pos, size_type n, Construct construct)
+    {
+        iterator old_end = end();
+        if (can_relocate::value)
+        {
+            // 整块后移，构造失败时移回原处
+            dw_stl::uninitialized_relocate(pos, old_end, pos + n);
+            try
+            {
+                construct(pos);
+            }
+            catch (...)
+            {
+                dw_stl::uninitialized_relocate(pos + n, old_end + n, pos);
+                throw;
+            }
+            size_ += n;
+        }
+        else
+        {
+            // 先把后面的元素移动到新的位置，再在空出的位置上构造
+            const size_type after = static_cast<size_type>(old_end - pos);
+            const size_type moved = dw_stl::min(after, n);
+            dw_stl::uninitialized_move(old_end - moved, old_end, old_end + n - moved);
+            size_ += n;
+            dw_stl::move_backward(pos, old_end - moved, old_end + n - moved);
+            dw_stl::destroy(pos, pos + moved);
+            try
+            {
+                construct(pos);
+            }
+            catch (...)
+            {
+                // 只能丢弃后面的元素，满足基本异常保证
+                dw_stl::destroy(pos + n, end());
+                size_ = static_cast<size_type>(pos - begin());
+                throw;
+            }
+        }
+    }
+
+    // fill_insert函数，在pos处插入n个value
+    template <class T, size_t N>
+    typename static_vector<T, N>::iterator
+    static_vector<T, N>::fill_insert(iterator pos, size_type n, const value_type& value)
+    {
+        if (n == 0)
+            return pos;
+        THROW_LENGTH_ERROR_IF(n > N - size(), "static_vector<T, N> size too big");
+        // value可能引用容器内部的元素，先复制一份
+        const value_type value_copy = value;
+        insert_in_place(pos, n, [&](iterator p) { dw_stl::uninitialized_fill_n(p, n, value_copy); });
+        return pos;
+    }
+
+    // copy_insert函数，输入迭代器只能逐个插入
+    template <class T, size_t N>
+    template <class InputIter>
+    typename static_vector<T, N>::iterator
+    static_vector<T, N>::copy_insert(iterator pos, InputIter first, InputIter last, input_iterator_tag)
+    {
+        const iterator result = pos;
+        for (; first != last; ++first, ++pos)
+            pos = emplace(pos, *first);
+        return result;
+    }
+
+    template <class T, size_t N>
+    template <class FIter>
+    typename static_vector<T, N>::iterator
+    static_vector<T, N>::copy_insert(iterator pos, FIter first, FIter last, forward_iterator_tag)
+    {
+        const size_type n = dw_stl::distance(first, last);
+        if (n == 0)
+            return pos;
+        THROW_LENGTH_ERROR_IF(n > N - size(), "static_vector<T, N> size too big");
+        insert_in_place(pos, n, [&](iterator p) { dw_stl::uninitialized_copy(first, last, p); });
+        return pos;
+    }
+
+    /****************************************************************************/
+    // 重载比较操作符
+    template <class T, size_t N>
+    bool operator==(const static_vector<T, N>& lhs, const static_vector<T, N>& rhs)
+    {
+        return lhs.size() == rhs.size() &&
+            dw_stl::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+
+    template <class T, size_t N>
+    bool operator<(const static_vector<T, N>& lhs, const static_vector<T, N>& rhs)
+    {
+        return dw_stl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+
+    template <class T, size_t N>
+    bool operator!=(const static_vector<T, N>& lhs, const static_vector<T, N>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    template <class T, size_t N>
+    bool operator>(const static_vector<T, N>& lhs, const static_vector<T, N>& rhs)
+    {
+        return rhs < lhs;
+    }
+
+    template <class T, size_t N>
+    bool operator<=(const static_vector<T, N>& lhs, const static_vector<T, N>& rhs)
+    {
+        return !(rhs < lhs);
+    }
+
+    template <class T, size_t N>
+    bool operator>=(const static_vector<T, N>& lhs, const static_vector<T, N>& rhs)
+    {
+        return !(lhs < rhs);
+    }
+
+    // 重载dw_stl的swap
+    template <class T, size_t N>
+    void swap(static_vector<T, N>& lhs, static_vector<T, N>& rhs)
+    {
+        lhs.swap(rhs);
+    }
+
+    // 元素可以按字节迁移时，static_vector也可以按字节迁移
+    template <class T, size_t N>
+    struct is_trivially_relocatable<static_vector<T, N>>
+        : std::integral_constant<bool, is_trivially_relocatable<T>::value> {};
+}
+
+#endif
@@ -21,6 +21,40 @@ namespace dw_stl
     typedef _bool_constant<true> _true_type;
     typedef _bool_constant<false> _false_type;
 
+    // void_t，用于SFINAE检测某个类型或者表达式是否合法(C++11中没有std::void_t)
+    template <class...>
+    struct make_void { typedef void type; };
+
+    template <class... Ts>
+    using void_t = typename make_void<Ts...>::type;
+
+    // is_trivially_relocatable，判断对象能否按字节迁移：把对象按字节复制到新的地址并且不再析构原来的对象，
+    // 效果与"移动构造到新地址再析构原来的对象"相同。可平凡复制的类型总是满足；
+    // 只保存指针或句柄的类型(例如 vector、unique_ptr)通常也满足，可以为这些类型特化为 true
+    template <class T>
+    struct is_trivially_relocatable : std::integral_constant<bool, std::is_trivially_copyable<T>::value> {};
+
+    // is_zero_initializable，判断全零字节是否就是类型的零值，这样的类型可以直接使用清零的内存而不必逐个构造
+    // 算术类型、枚举和指针满足；成员指针的空值在常见的 ABI 中不是全零，不包括在内
+    template <class T>
+    struct is_zero_initializable : std::integral_constant<bool,
+        std::is_arithmetic<T>::value || std::is_enum<T>::value || std::is_pointer<T>::value> {};
+
+    // is_sized_range，判断区间类型是否提供begin()、end()以及size()，
+    // 容器的append_range/insert_range对这样的区间先按size()预留空间
+    template <class R, class = void>
+    struct is_range : std::false_type {};
+
+    template <class R>
+    struct is_range<R, void_t<decltype(std::declval<const R&>().begin()),
+                              decltype(std::declval<const R&>().end())>> : std::true_type {};
+
+    template <class R, class = void>
+    struct is_sized_range : std::false_type {};
+
+    template <class R>
+    struct is_sized_range<R, void_t<decltype(std::declval<const R&>().size())>> : is_range<R> {};
+
     // type traits，用于萃取判断是否是pair类型
     
     template <class T1, class T2>
@@ -9,10 +9,15 @@ uninitialized_copy(first, last, result)
 uninitialized_copy_n(first, n, result)
 uninitialized_fill(first, last, value)
 uninitialized_fill_n(first, n, value)
+uninitialized_default_construct_n(first, n)
 uninitialized_move(first, last, result)
 uninitialized_move_n(first, n, result)
+uninitialized_relocate(first, last, result)
+uninitialized_relocate_n(first, n, result)
 */
 
+#include <cstring>
+
 #include "construct.h"
 #include "iterator.h"
 #include "type_traits.h"
@@ -54,7 +59,9 @@ namespace dw_stl
         {
             for (; result != cur; ++result)
                 dw_stl::destroy(&*result);
+            throw;
         }
+        return cur;
     }
 
     template <class InputIter, class FrowardIter>
@@ -77,7 +84,7 @@ namespace dw_stl
     template <class InputIter, class Size, class ForwardIter>
     ForwardIter uninitialized_copy_n_dispatch(InputIter first, Size n, ForwardIter result, std::true_type)
     {
-        return dw_stl::copy_n(first, n, first).second;
+        return dw_stl::copy_n(first, n, result).second;
     }
 
     // 类的构造
@@ -169,14 +176,16 @@ namespace dw_stl
         try
         {
             for (; n > 0; --n, ++cur)
-                dw_stl::construct(&*first, value);
+                dw_stl::construct(&*cur, value);
         }
         catch (...)
         {
             // 如果发生异常，销毁对象，提供强异常保证
             for (; first != cur; ++first)
                 dw_stl::destroy(&*first);
+            throw;
         }
+        return cur;
     }
 
     // 是否是POD类型的，即是否有赋值运算符
@@ -188,6 +197,49 @@ namespace dw_stl
                                                 typename iterator_traits<ForwardIter>::value_type>{});
     }
 
+    /******************************************************************
+    uninitialized_default_construct_n函数
+    args:
+        first, n
+    功能：
+        负责在[first, first + n)上默认初始化n个对象(不是值初始化)
+        元素可以平凡默认构造时什么也不做，内容保持未定义，省去一次清零的内存遍历；
+        否则逐个调用默认构造函数
+    *****************************************************************************/
+    template <class ForwardIter, class Size>
+    ForwardIter uninitialized_default_construct_n_dispatch(ForwardIter first, Size n, std::true_type)
+    {
+        dw_stl::advance(first, n);
+        return first;
+    }
+
+    template <class ForwardIter, class Size>
+    ForwardIter uninitialized_default_construct_n_dispatch(ForwardIter first, Size n, std::false_type)
+    {
+        typedef typename iterator_traits<ForwardIter>::value_type value_type;
+        auto cur = first;
+        try
+        {
+            for (; n > 0; --n, ++cur)
+                ::new ((void*)&*cur) value_type;
+        }
+        catch (...)
+        {
+            for (; first != cur; ++first)
+                dw_stl::destroy(&*first);
+            throw;
+        }
+        return cur;
+    }
+
+    template <class ForwardIter, class Size>
+    ForwardIter uninitialized_default_construct_n(ForwardIter first, Size n)
+    {
+        return dw_stl::uninitialized_default_construct_n_dispatch(first, n,
+                                                std::is_trivially_default_constructible<
+                                                typename iterator_traits<ForwardIter>::value_type>{});
+    }
+
     /******************************************************************
     uninitialized_move函数
     args:
@@ -216,6 +268,7 @@ namespace dw_stl
         {
             for(; result != cur; ++result)
                 dw_stl::destroy(&*result);
+            throw;
         }
 
         return cur;
@@ -257,6 +310,7 @@ namespace dw_stl
         {
             for (; result != cur; ++result)
                 dw_stl::destroy(&*result);
+            throw;
         }
 
         return cur;
@@ -270,6 +324,64 @@ namespace dw_stl
                                                std::is_trivially_copy_assignable<
                                                typename iterator_traits<ForwardIter>::value_type>{});
     }
+
+    /******************************************************************
+    uninitialized_relocate函数
+    args:
+        first, last, result
+    功能：
+        负责将[first, last)上的对象迁移到以 result 为起始的空间，返回迁移结束的位置
+        迁移之后[first, last)上的对象已经不存在，不需要再析构
+        元素满足 is_trivially_relocatable 并且都是指针时，使用 memmove 整块复制，允许两个区间重叠；
+        否则逐个移动构造之后再析构原来的对象，两个区间不能重叠
+    *****************************************************************************/
+    // 能否按字节迁移：两个迭代器是同一种元素的指针，并且元素满足 is_trivially_relocatable
+    template <class InputIter, class ForwardIter>
+    struct relocate_bitwise : std::false_type {};
+
+    template <class T>
+    struct relocate_bitwise<T*, T*>
+        : std::integral_constant<bool, !std::is_const<T>::value && is_trivially_relocatable<T>::value> {};
+
+    template <class T>
+    T* uninitialized_relocate_dispatch(T* first, T* last, T* result, std::true_type)
+    {
+        const auto n = static_cast<size_t>(last - first);
+        if (n != 0)
+            std::memmove(static_cast<void*>(result), static_cast<const void*>(first), n * sizeof(T));
+        return result + n;
+    }
+
+    template <class InputIter, class ForwardIter>
+    ForwardIter uninitialized_relocate_dispatch(InputIter first, InputIter last, ForwardIter result, std::false_type)
+    {
+        // 全部移动成功之后才析构原来的对象，移动构造抛出异常时原来的对象保持不变
+        auto cur = dw_stl::uninitialized_move(first, last, result);
+        dw_stl::destroy(first, last);
+        return cur;
+    }
+
+    template <class InputIter, class ForwardIter>
+    ForwardIter uninitialized_relocate(InputIter first, InputIter last, ForwardIter result)
+    {
+        return dw_stl::uninitialized_relocate_dispatch(first, last, result,
+                                                       relocate_bitwise<InputIter, ForwardIter>{});
+    }
+
+    /******************************************************************
+    uninitialized_relocate_n函数
+    args:
+        first, n, result
+    功能：
+        负责将[first, first + n)上的对象迁移到以 result 为起始的空间
+    *****************************************************************************/
+    template <class InputIter, class Size, class ForwardIter>
+    ForwardIter uninitialized_relocate_n(InputIter first, Size n, ForwardIter result)
+    {
+        auto last = first;
+        dw_stl::advance(last, n);
+        return dw_stl::uninitialized_relocate(first, last, result);
+    }
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -297,6 +297,12 @@ namespace dw_stl
     {
         return pair<Ty1, Ty2>(dw_stl::forward<Ty1>(first), dw_stl::forward<Ty2>(second));
     }
+
+    // 两个成员都可以按字节迁移时，pair也可以
+    template <class Ty1, class Ty2>
+    struct is_trivially_relocatable<pair<Ty1, Ty2>>
+        : std::integral_constant<bool, is_trivially_relocatable<Ty1>::value &&
+                                       is_trivially_relocatable<Ty2>::value> {};
 }
 
-#endif 
\ No newline at end of file
+#endif
@@ -20,14 +20,34 @@
         reserve
         resize
         insert
+
+空间分配：
+    默认构造以及用空区间构造的vector不分配空间，第一次插入元素时才分配，
+    第一次分配的大小至少为vector_init_cap<T>::value(约DW_STL_VECTOR_INIT_BYTES字节)
+    用n个元素或者一个区间构造时只分配恰好需要的空间
+    用n个零值的算术类型、枚举或者指针构造时不再逐个填充，而是向分配器要清零的内存(allocate_zeroed)：
+    malloc_allocator使用calloc，DW_STL_USE_LARGE_ALLOC时的大块内存使用mmap新映射的页面，
+    这两种情况下内存在第一次访问之前几乎没有开销
+    resize_default_init/resize_uninitialized/append_uninitialized新增元素时不做值初始化，
+    元素是平凡类型时不会先把整块空间清零，适合随后被完整写入的I/O缓冲区
+
+扩容策略：
+    第三个模板参数Growth决定空间不足时新的容量，默认为DW_STL_VECTOR_DEFAULT_GROWTH(growth_1_5x)
+        growth_1_5x             : 按1.5倍扩容
+        growth_2x               : 按2倍扩容，重新分配的次数更少，但是平均浪费的空间更多
+        growth_exact            : 只分配恰好需要的空间，适合已经知道最终大小、只追加少量元素的情况
+        growth_usable_size<G>   : 按G计算容量之后，再取分配器实际分配的大小(例如malloc_usable_size、内存池的大小等级)，
+                                  多出来的空间也计入capacity()，不会浪费
 */
 
 #include <initializer_list>
+#include <cstring>
 #include "iterator.h"
 #include "memory.h"
 #include "util.h"
 #include "exceptdef.h"
 #include "allocator.h"
+#include "allocator_traits.h"
 #include "uninitialized.h"
 #include "algorithm.h"
 #include "algo.h"
@@ -44,24 +64,92 @@ namespace dw_stl
     #undef min
     #endif
 
-    // vector模板类
-    // 模板参数为T
+    // vector第一次分配空间的大致字节数
+    #ifndef DW_STL_VECTOR_INIT_BYTES
+    #define DW_STL_VECTOR_INIT_BYTES 64
+    #endif
+
+    // vector第一次分配的最少元素个数，较大的元素至少分配4个
     template <class T>
-    class vector
+    struct vector_init_cap
+    {
+        static constexpr size_t value = sizeof(T) * 4 < DW_STL_VECTOR_INIT_BYTES
+            ? DW_STL_VECTOR_INIT_BYTES / sizeof(T) : 4;
+    };
+
+    /*****************************************************************************************/
+    // vector的扩容策略
+    // grow(cap, need, init, max)返回新的容量，cap为当前容量，need为至少需要的容量，
+    // init为第一次分配的最少元素个数，max为max_size()，调用前保证need <= max
+    // round_to_usable表示分配之后是否取分配器实际分配的大小
+    /*****************************************************************************************/
+    struct growth_1_5x
+    {
+        typedef std::false_type round_to_usable;
+
+        static size_t grow(size_t cap, size_t need, size_t init, size_t max) noexcept
+        {
+            if (cap == 0)
+                return dw_stl::max(need, init);
+            const size_t new_cap = cap > max - cap / 2 ? max : cap + cap / 2;
+            return dw_stl::max(new_cap, need);
+        }
+    };
+
+    struct growth_2x
+    {
+        typedef std::false_type round_to_usable;
+
+        static size_t grow(size_t cap, size_t need, size_t init, size_t max) noexcept
+        {
+            if (cap == 0)
+                return dw_stl::max(need, init);
+            const size_t new_cap = cap > max - cap ? max : cap * 2;
+            return dw_stl::max(new_cap, need);
+        }
+    };
+
+    struct growth_exact
+    {
+        typedef std::false_type round_to_usable;
+
+        static size_t grow(size_t, size_t need, size_t, size_t) noexcept
+        { return need; }
+    };
+
+    template <class Base = growth_1_5x>
+    struct growth_usable_size : Base
+    {
+        typedef std::true_type round_to_usable;
+    };
+
+    // vector默认的扩容策略
+    #ifndef DW_STL_VECTOR_DEFAULT_GROWTH
+    #define DW_STL_VECTOR_DEFAULT_GROWTH dw_stl::growth_1_5x
+    #endif
+
+    // vector模板类
+    // 模板参数T代表数据类型，Alloc代表分配器类型，默认使用dw_stl::allocator<T>，Growth代表扩容策略
+    // vector私有继承allocator_holder保存分配器，空分配器不会增加vector的大小
+    template <class T, class Alloc = dw_stl::allocator<T>, class Growth = DW_STL_VECTOR_DEFAULT_GROWTH>
+    class vector : private dw_stl::allocator_holder<Alloc>
     {
-        static_assert(!std::is_same<bool, T>::value, "vector<bool> is abandoned in DW_STL");
+        static_assert(!std::is_same<bool, T>::value, "vector<bool> is abandoned in DW_STL, use dynamic_bitset instead");
+        static_assert(std::is_same<T, typename Alloc::value_type>::value,
+                      "The value_type of Alloc should be same with T");
     public:
         // vector 的嵌套型别定义
-        typedef dw_stl::allocator<T>                      allocator_type;
-        typedef dw_stl::allocator<T>                      data_allocator;
-
-        typedef typename allocator_type::value_type      value_type;
-        typedef typename allocator_type::pointer         pointer;
-        typedef typename allocator_type::const_pointer   const_pointer;
-        typedef typename allocator_type::reference       reference;
-        typedef typename allocator_type::const_reference const_reference;
-        typedef typename allocator_type::size_type       size_type;
-        typedef typename allocator_type::difference_type difference_type;
+        typedef Alloc                                    allocator_type;
+        typedef dw_stl::allocator_traits<Alloc>          alloc_traits;
+        typedef Growth                                   growth_policy;
+
+        typedef T                                        value_type;
+        typedef typename alloc_traits::pointer           pointer;
+        typedef typename alloc_traits::const_pointer     const_pointer;
+        typedef value_type&                              reference;
+        typedef const value_type&                        const_reference;
+        typedef typename alloc_traits::size_type         size_type;
+        typedef typename alloc_traits::difference_type   difference_type;
 
         // vector底层迭代器使用的是数据指针，因此需要为指针特定萃取器版本
         typedef value_type*                              iterator;
@@ -70,39 +158,73 @@ namespace dw_stl
         typedef dw_stl::reverse_iterator<iterator>        reverse_iterator;
         typedef dw_stl::reverse_iterator<const_iterator>  const_reverse_iterator;
 
-        allocator_type get_allocator() { return data_allocator(); }
+        allocator_type get_allocator() const { return this->alloc(); }
 
     private:
-        iterator begin_;  // 表示目前使用空间的头部
-        iterator end_;    // 表示目前使用空间的尾部
-        iterator cap_;    // 表示目前储存空间的尾部
+        typedef dw_stl::allocator_holder<Alloc>          holder_base;
+
+        // 元素可以按字节迁移时，扩容、插入、删除都整块复制元素，不需要逐个移动构造和析构
+        typedef dw_stl::is_trivially_relocatable<T>      can_relocate;
+
+        // 元素可以按字节迁移并且分配器提供了reallocate时，扩容交给分配器完成(例如realloc、mremap)
+        // reallocate不返回实际可以使用的单元数，扩容策略要求取实际分配的大小时不使用，
+        // 否则容量会因为走了哪条路径而不同
+        typedef std::integral_constant<bool, can_relocate::value &&
+                                       alloc_traits::can_reallocate::value &&
+                                       !Growth::round_to_usable::value> can_expand;
+
+        // 按字节迁移时用来临时存放新元素的未初始化空间
+        typedef typename std::aligned_storage<sizeof(T), alignof(T)>::type raw_storage;
+
+        iterator begin_ = nullptr;  // 表示目前使用空间的头部
+        iterator end_ = nullptr;    // 表示目前使用空间的尾部
+        iterator cap_ = nullptr;    // 表示目前储存空间的尾部
 
     public:
         // 构造、复制、移动、析构函数
+        // 空的vector不分配空间
         vector() noexcept
-        { try_init(); }
+        {
+        }
 
-        explicit vector(size_type n)
+        explicit vector(const allocator_type& alloc) noexcept
+            :holder_base(alloc)
+        {
+        }
+
+        explicit vector(size_type n, const allocator_type& alloc = allocator_type())
+            :holder_base(alloc)
         { fill_init(n, value_type()); }
 
-        vector(size_type n, const value_type& value)
+        vector(size_type n, const value_type& value, const allocator_type& alloc = allocator_type())
+            :holder_base(alloc)
         { fill_init(n, value); }
 
         template <class Iter, typename std::enable_if<
             dw_stl::is_input_iterator<Iter>::value, int>::type = 0>
-        vector(Iter first, Iter last)
+        vector(Iter first, Iter last, const allocator_type& alloc = allocator_type())
+            :holder_base(alloc)
         {
-            DW_STL_DEBUG(!(last < first));
-            range_init(first, last);
+            range_init(first, last, iterator_category(first));
         }
 
+        // 拷贝构造时由分配器决定新容器使用的分配器
         vector(const vector& rhs)
+            :holder_base(alloc_traits::select_on_container_copy_construction(rhs.alloc()))
+        {
+            range_init(rhs.begin_, rhs.end_, dw_stl::forward_iterator_tag());
+        }
+
+        vector(const vector& rhs, const allocator_type& alloc)
+            :holder_base(alloc)
         {
-            range_init(rhs.begin_, rhs.end_);
+            range_init(rhs.begin_, rhs.end_, dw_stl::forward_iterator_tag());
         }
 
+        // 移动构造时分配器随之移动
         vector(vector&& rhs) noexcept
-            :begin_(rhs.begin_),
+            :holder_base(dw_stl::move(rhs.alloc())),
+            begin_(rhs.begin_),
             end_(rhs.end_),
             cap_(rhs.cap_)
         {
@@ -111,17 +233,24 @@ namespace dw_stl
             rhs.cap_ = nullptr;
         }
 
-        vector(std::initializer_list<value_type> ilist)
+        // 如果两个分配器不相等，不能直接接管rhs的空间，只能逐个移动元素
+        vector(vector&& rhs, const allocator_type& alloc);
+
+        vector(std::initializer_list<value_type> ilist, const allocator_type& alloc = allocator_type())
+            :holder_base(alloc)
         {
-            range_init(ilist.begin(), ilist.end());
+            range_init(ilist.begin(), ilist.end(), dw_stl::forward_iterator_tag());
         }
 
         vector& operator=(const vector& rhs);
-        vector& operator=(vector&& rhs) noexcept;
+        // 分配器不传播且不总是相等时可能要重新分配空间，不能保证不抛出异常
+        vector& operator=(vector&& rhs)
+            noexcept(alloc_traits::propagate_on_container_move_assignment::value ||
+                     alloc_traits::is_always_equal::value);
 
         vector& operator=(std::initializer_list<value_type> ilist)
         {
-            vector tmp(ilist.begin(), ilist.end());
+            vector tmp(ilist.begin(), ilist.end(), this->alloc());
             swap(tmp);
             return *this;
         }
@@ -169,7 +298,7 @@ namespace dw_stl
         size_type size() const noexcept
         { return static_cast<size_type>(end_ - begin_); }
         size_type max_size() const noexcept
-        { return static_cast<size_type>(-1) / sizeof(T); }
+        { return alloc_traits::max_size(this->alloc()); }
         size_type capacity() const noexcept
         { return static_cast<size_type>(cap_ - begin_); }
         void reserve(size_type n);
@@ -188,12 +317,12 @@ namespace dw_stl
         }
         reference at(size_type n)
         {
-            THROW_OUT_OF_RANGE_IF(!(n < size()), "vector<T>::at() subscript out of range");
+            THROW_OUT_OF_RANGE_IF(!(n < size()), "vector<T, Alloc, Growth>::at() subscript out of range");
             return (*this)[n];
         }
         const_reference at(size_type n) const
         {
-            THROW_OUT_OF_RANGE_IF(!(n < size()), "vector<T>::at() subscript out of range");
+            THROW_OUT_OF_RANGE_IF(!(n < size()), "vector<T, Alloc, Growth>::at() subscript out of range");
             return (*this)[n];
         }
 
@@ -228,10 +357,7 @@ namespace dw_stl
         template <class Iter, typename std::enable_if<
             dw_stl::is_input_iterator<Iter>::value, int>::type = 0>
         void assign(Iter first, Iter last)
-        {
-            DW_STL_DEBUG(!(last < first));
-            copy_assign(first, last, iterator_category(first));
-        }
+        { copy_assign(first, last, iterator_category(first)); }
 
         void assign(std::initializer_list<value_type> il)
         { copy_assign(il.begin(), il.end(), dw_stl::forward_iterator_tag{}); }
@@ -267,11 +393,50 @@ namespace dw_stl
         template <class Iter, typename std::enable_if<
             dw_stl::is_input_iterator<Iter>::value, int>::type = 0>
         void insert(const_iterator pos, Iter first, Iter last)
+        { insert_range(pos, first, last); }
+
+        // 批量插入[first, last)，最多重新分配一次空间
+        // 前向迭代器先求出元素个数，元素可以平凡复制并且来源是指针时整块复制；
+        // 输入迭代器先追加到尾部(每次填满剩余的容量)，再旋转到pos处
+        template <class Iter, typename std::enable_if<
+            dw_stl::is_input_iterator<Iter>::value, int>::type = 0>
+        iterator insert_range(const_iterator pos, Iter first, Iter last)
+        {
+            DW_STL_DEBUG(pos >= begin() && pos <= end());
+            return range_insert(const_cast<iterator>(pos), first, last, iterator_category(first));
+        }
+
+        // 提供size()的区间先按size()预留空间
+        template <class Range, typename std::enable_if<
+            dw_stl::is_range<Range>::value, int>::type = 0>
+        iterator insert_range(const_iterator pos, const Range& r)
+        {
+            DW_STL_DEBUG(pos >= begin() && pos <= end());
+            const size_type off = static_cast<size_type>(pos - begin_);
+            reserve_hint(r, dw_stl::is_sized_range<Range>{});
+            return insert_range(begin_ + off, r.begin(), r.end());
+        }
+
+        // 在尾部追加[first, last)
+        template <class Iter, typename std::enable_if<
+            dw_stl::is_input_iterator<Iter>::value, int>::type = 0>
+        void append_range(Iter first, Iter last)
+        { range_insert(end_, first, last, iterator_category(first)); }
+
+        // size_hint为输入区间元素个数的估计，先按它预留空间，估计准确时不会再重新分配
+        template <class Iter, typename std::enable_if<
+            dw_stl::is_input_iterator<Iter>::value, int>::type = 0>
+        void append_range(Iter first, Iter last, size_type size_hint)
         {
-            DW_STL_DEBUG(pos >= begin() && pos <= end() && !(last < first));
-            copy_insert(const_cast<iterator>(pos), first, last);
+            reserve_extra(size_hint);
+            range_insert(end_, first, last, iterator_category(first));
         }
 
+        template <class Range, typename std::enable_if<
+            dw_stl::is_range<Range>::value, int>::type = 0>
+        void append_range(const Range& r)
+        { insert_range(end_, r); }
+
         // erase和clear函数
         iterator erase(const_iterator pos);
         iterator erase(const_iterator first, const_iterator last);
@@ -280,6 +445,25 @@ namespace dw_stl
         // resize和reverse函数
         void resize(size_type new_size) { return resize(new_size, value_type()); }
         void resize(size_type new_size, const value_type& value);
+        // 新增的元素默认初始化而不是值初始化，元素可以平凡默认构造时不会先清零
+        void resize_default_init(size_type new_size);
+        // 只用于平凡类型，新增的元素内容未定义，用于随后由read()、解码器等直接写满的缓冲区
+        void resize_uninitialized(size_type new_size)
+        {
+            static_assert(std::is_trivial<T>::value,
+                          "vector<T>::resize_uninitialized requires a trivial value_type");
+            resize_default_init(new_size);
+        }
+        // 只用于平凡类型，在尾部追加n个内容未定义的元素，返回指向第一个新元素的指针
+        pointer append_uninitialized(size_type n)
+        {
+            static_assert(std::is_trivial<T>::value,
+                          "vector<T>::append_uninitialized requires a trivial value_type");
+            reserve_extra(n);
+            auto p = end_;
+            end_ += n;
+            return p;
+        }
 
         void reverse() { dw_stl::reverse(begin(), end()); }
 
@@ -288,19 +472,42 @@ namespace dw_stl
 
     private:
         // initialize和destroy函数
-        void try_init() noexcept;
 
         void init_space(size_type size, size_type cap);
 
         void fill_init(size_type n, const value_type& value);
-        template <class Iter>
-        void range_init(Iter first, Iter last);
+        void zero_init(size_type n);
+        template <class InputIter>
+        void range_init(InputIter first, InputIter last, input_iterator_tag);
+        template <class FIter>
+        void range_init(FIter first, FIter last, forward_iterator_tag);
 
         void destroy_and_recover(iterator first, iterator last, size_type n);
 
         // 计算增加的容量
         size_type get_new_cap(size_type add_size);
 
+        // 保证剩余容量不少于n，按扩容策略增长
+        void reserve_extra(size_type n)
+        {
+            if (static_cast<size_type>(cap_ - end_) < n)
+                reserve(get_new_cap(n));
+        }
+
+        template <class Range>
+        void reserve_hint(const Range& r, std::true_type)
+        { reserve_extra(static_cast<size_type>(r.size())); }
+        template <class Range>
+        void reserve_hint(const Range&, std::false_type) {}
+
+        // 分配扩容用的新空间，扩容策略要求时把n改为分配器实际可以使用的单元数
+        iterator allocate_cap(size_type& n)
+        {
+            return Growth::round_to_usable::value
+                ? alloc_traits::allocate_at_least(this->alloc(), n)
+                : alloc_traits::allocate(this->alloc(), n);
+        }
+
         // assign
 
         void fill_assign(size_type n, const value_type& value);
@@ -317,29 +524,81 @@ namespace dw_stl
         void reallocate_emplace(iterator pos, Args&& ...args);
         void reallocate_insert(iterator pos, const value_type& value);
 
+        // 由分配器直接改变空间大小
+        bool expand_storage(size_type new_cap, std::true_type);
+        bool expand_storage(size_type, std::false_type) { return false; }
+
+        template <class... Args>
+        bool expand_emplace(std::true_type, iterator pos, Args&& ...args);
+        template <class... Args>
+        bool expand_emplace(std::false_type, iterator, Args&& ...) { return false; }
+
+        // 把原来的元素迁移到new_begin开始的新空间，在pos对应的位置空出n个单元(调用前已经构造好)，并释放原来的空间
+        void relocate_to(iterator new_begin, size_type new_cap, iterator pos, size_type n);
+
         // insert
 
         iterator fill_insert(iterator pos, size_type n, const value_type& value);
+        template <class FIter>
+        void copy_insert(iterator pos, FIter first, FIter last);
+
+        // 输入迭代器只能遍历一次，每次填满剩余的容量，不够时再按扩容策略扩容
         template <class InputIter>
-        void copy_insert(iterator pos, InputIter first, InputIter last);
+        void append_input(InputIter first, InputIter last);
+
+        template <class InputIter>
+        iterator range_insert(iterator pos, InputIter first, InputIter last, input_iterator_tag);
+        template <class FIter>
+        iterator range_insert(iterator pos, FIter first, FIter last, forward_iterator_tag);
 
         // shrink_to_fit
 
         void reinsert(size_type size);
     };
 
+    // 带分配器的移动构造函数
+    template <class T, class Alloc, class Growth>
+    vector<T, Alloc, Growth>::vector(vector&& rhs, const allocator_type& alloc)
+        :holder_base(alloc)
+    {
+        if (dw_stl::alloc_equal(this->alloc(), rhs.alloc()))
+        {
+            begin_ = rhs.begin_;
+            end_ = rhs.end_;
+            cap_ = rhs.cap_;
+            rhs.begin_ = nullptr;
+            rhs.end_ = nullptr;
+            rhs.cap_ = nullptr;
+        }
+        else
+        {
+            const size_type len = rhs.size();
+            init_space(len, len);
+            dw_stl::uninitialized_move(rhs.begin_, rhs.end_, begin_);
+        }
+    }
+
     // vector复制赋值运算符
-    template <class T>
-    vector<T>& vector<T>::operator=(const vector& rhs)
+    template <class T, class Alloc, class Growth>
+    vector<T, Alloc, Growth>& vector<T, Alloc, Growth>::operator=(const vector& rhs)
     {
         if (this != &rhs)
         {
+            // 如果分配器需要传播且两个分配器不相等，原来的空间只能由原来的分配器释放
+            if (alloc_traits::propagate_on_container_copy_assignment::value &&
+                !dw_stl::alloc_equal(this->alloc(), rhs.alloc()))
+            {
+                destroy_and_recover(begin_, end_, cap_ - begin_);
+                begin_ = end_ = cap_ = nullptr;
+            }
+            dw_stl::alloc_on_copy(this->alloc(), rhs.alloc());
+
             const auto len = rhs.size();
             // 如果等号右边的向量长度大于当前的容量,
             if (len > capacity())
             {
                 // 首先创建一个新的临时变量，然后将其与当前的vector进行交换，临时变量会被销毁，同时也就是销毁旧的vector
-                vector tmp(rhs.begin(), rhs.end());
+                vector tmp(rhs.begin(), rhs.end(), this->alloc());
                 // swap函数交换的实际是begin_, end_和cap_
                 swap(tmp);
             }
@@ -349,7 +608,7 @@ namespace dw_stl
                 // i是一个迭代器
                 auto i = dw_stl::copy(rhs.begin(), rhs.end(), begin());
                 // 删除i到end_的所有元素
-                data_allocator::destroy(i, end_);
+                alloc_traits::destroy(this->alloc(), i, end_);
                 end_ = begin_ + len;
             }
             else
@@ -357,41 +616,65 @@ namespace dw_stl
                 dw_stl::copy(rhs.begin(), rhs.begin() + size(), begin_);
                 // end_之后的需要使用未初始化的拷贝
                 dw_stl::uninitialized_copy(rhs.begin() + size(), rhs.end(), end_);
-                cap_ = end_ = begin_ + len;
+                end_ = begin_ + len;
             }
         }
         return *this;
     }
 
     // 移动赋值操作符, 直接将右边的东西移动到左边，然后将右边的东西销毁掉
-    template <class T>
-    vector<T>& vector<T>::operator=(vector&& rhs) noexcept
+    template <class T, class Alloc, class Growth>
+    vector<T, Alloc, Growth>& vector<T, Alloc, Growth>::operator=(vector&& rhs)
+        noexcept(alloc_traits::propagate_on_container_move_assignment::value ||
+                 alloc_traits::is_always_equal::value)
     {
+        if (this == &rhs)
+            return *this;
         // 首先调用destroy函数析构已经构造的对象
         destroy_and_recover(begin_, end_, cap_ - begin_);
-        // 然后将等号右边的begin_和end_赋给当前vector
-        begin_ = rhs.begin_;
-        end_ = rhs.end_;
-        cap_ = rhs.cap_;
-        rhs.begin_ = nullptr;
-        rhs.end_ = nullptr;
-        rhs.cap_ = nullptr;
+        begin_ = end_ = cap_ = nullptr;
+        if (alloc_traits::propagate_on_container_move_assignment::value ||
+            dw_stl::alloc_equal(this->alloc(), rhs.alloc()))
+        {
+            dw_stl::alloc_on_move(this->alloc(), rhs.alloc());
+            // 然后将等号右边的begin_和end_赋给当前vector
+            begin_ = rhs.begin_;
+            end_ = rhs.end_;
+            cap_ = rhs.cap_;
+            rhs.begin_ = nullptr;
+            rhs.end_ = nullptr;
+            rhs.cap_ = nullptr;
+        }
+        else
+        {
+            // 分配器不相等且不传播，只能用自己的分配器重新分配空间并逐个移动元素
+            const size_type len = rhs.size();
+            init_space(len, len);
+            dw_stl::uninitialized_move(rhs.begin_, rhs.end_, begin_);
+        }
         return *this;
     }
 
     // 预留空间大小，当原容量小于要求大小时，才会重新分配
-    template <class T>
-    void vector<T>::reserve(size_type n)
+    template <class T, class Alloc, class Growth>
+    void vector<T, Alloc, Growth>::reserve(size_type n)
     {
         if (capacity() < n)
         {
             // 重新分配内存
-            THROW_LENGTH_ERROR_IF(n > max_size(), "n can not larger than max_size() in vector<T>::reserve(n)");
+            THROW_LENGTH_ERROR_IF(n > max_size(), "n can not larger than max_size() in vector<T, Alloc, Growth>::reserve(n)");
+            if (expand_storage(n, can_expand{}))
+                return;
             const auto old_size = size();
-            auto tmp = data_allocator::allocate(n);
+            auto tmp = allocate_cap(n);
+            if (can_relocate::value)
+            {
+                relocate_to(tmp, n, end_, 0);
+                return;
+            }
             // 移动数据
             dw_stl::uninitialized_move(begin_, end_, tmp);
-            data_allocator::deallocate(begin_, cap_ - begin_);
+            destroy_and_recover(begin_, end_, cap_ - begin_);
             begin_ = tmp;
             end_ = tmp + old_size;
             cap_ = begin_ + n;
@@ -399,17 +682,17 @@ namespace dw_stl
     }
 
     // 放弃多余的容量
-    template <class T>
-    void vector<T>::shrink_to_fit()
+    template <class T, class Alloc, class Growth>
+    void vector<T, Alloc, Growth>::shrink_to_fit()
     {
-        if (end_ < cap_)
+        if (end_ < cap_ && !(end_ != begin_ && expand_storage(size(), can_expand{})))
             reinsert(size());
     }
 
     // emplace函数，在pos处位置就地构造元素，避免额外的赋值或者移动开销
-    template <class T>
+    template <class T, class Alloc, class Growth>
     template <class ...Args>
-    typename vector<T>::iterator vector<T>::emplace(const_iterator pos, Args&&... args)
+    typename vector<T, Alloc, Growth>::iterator vector<T, Alloc, Growth>::emplace(const_iterator pos, Args&&... args)
     {
         DW_STL_DEBUG(pos >= begin() && pos <= end());
         iterator xpos = const_cast<iterator>(pos);
@@ -418,19 +701,31 @@ namespace dw_stl
         if (end_ != cap_ && xpos == end_)
         {
             // 在pos处就地构造元素，避免额外的赋值和移动开销
-            data_allocator::construct(dw_stl::address_of(*end_), dw_stl::forward<Args>(args)...);
+            alloc_traits::construct(this->alloc(), dw_stl::address_of(*end_), dw_stl::forward<Args>(args)...);
+            ++end_;
+        }
+        // 如果pos不在尾部，元素可以按字节迁移
+        else if (end_ != cap_ && can_relocate::value)
+        {
+            // 参数可能引用vector内部的元素，先在临时空间构造，再整块挪动后面的元素并把新元素迁移到xpos处
+            raw_storage buf;
+            auto tmp = reinterpret_cast<T*>(&buf);
+            alloc_traits::construct(this->alloc(), tmp, dw_stl::forward<Args>(args)...);
+            dw_stl::uninitialized_relocate(xpos, end_, xpos + 1);
+            dw_stl::uninitialized_relocate(tmp, tmp + 1, xpos);
             ++end_;
         }
         // 如果pos不在尾部
         else if (end_ != cap_)
         {
             auto new_end = end_;
-            data_allocator::construct(dw_stl::address_of(*end_), *(end_ - 1));
+            // 参数可能引用vector内部的元素，先构造出新元素再挪动
+            value_type value_copy(dw_stl::forward<Args>(args)...);
+            alloc_traits::construct(this->alloc(), dw_stl::address_of(*end_), dw_stl::move(*(end_ - 1)));
             ++new_end;
             // 将xpos之后的数据都往后移动一位
-            dw_stl::copy_backward(xpos, end_ - 1, end_);
-            // 在xpos处构造
-            *xpos = value_type(dw_stl::forward<Args>(args)...);
+            dw_stl::move_backward(xpos, end_ - 1, end_);
+            *xpos = dw_stl::move(value_copy);
             end_ = new_end;
         }
         // 超出当前容量限制
@@ -443,14 +738,14 @@ namespace dw_stl
     }
 
     // emplace_back函数，在尾部就地构造元素，避免造成额外的赋值或者移动开销
-    template <class T>
+    template <class T, class Alloc, class Growth>
     template <class ...Args>
-    void vector<T>::emplace_back(Args&& ...args)
+    void vector<T, Alloc, Growth>::emplace_back(Args&& ...args)
     {
         if (end_ < cap_)
         {
             // 传入参数进行构造，不会再次调用拷贝构造函数
-            data_allocator::construct(dw_stl::address_of(*end_), dw_stl::forward<Args>(args)...);
+            alloc_traits::construct(this->alloc(), dw_stl::address_of(*end_), dw_stl::forward<Args>(args)...);
             ++end_;
         }
         else
@@ -460,13 +755,13 @@ namespace dw_stl
     }
 
     // 在尾部插入元素
-    template <class T>
-    void vector<T>::push_back(const value_type& value)
+    template <class T, class Alloc, class Growth>
+    void vector<T, Alloc, Growth>::push_back(const value_type& value)
     {
         if (end_ != cap_)
         {
             // 调用构造函数造成开销
-            data_allocator::construct(dw_stl::address_of(*end_), value);
+            alloc_traits::construct(this->alloc(), dw_stl::address_of(*end_), value);
             ++end_;
         }
         else 
@@ -476,17 +771,17 @@ namespace dw_stl
     }
 
     // 弹出尾部元素
-    template <class T>
-    void vector<T>::pop_back()
+    template <class T, class Alloc, class Growth>
+    void vector<T, Alloc, Growth>::pop_back()
     {
         DW_STL_DEBUG(!empty());
-        data_allocator::destroy(end_ - 1);
+        alloc_traits::destroy(this->alloc(), end_ - 1);
         --end_;
     }
 
     // 在pos处插入元素
-    template <class T>
-    typename vector<T>::iterator vector<T>::insert(const_iterator pos, const value_type& value)
+    template <class T, class Alloc, class Growth>
+    typename vector<T, Alloc, Growth>::iterator vector<T, Alloc, Growth>::insert(const_iterator pos, const value_type& value)
     {
         DW_STL_DEBUG(pos >= begin() && pos <= end());
         iterator xpos = const_cast<iterator>(pos);
@@ -494,14 +789,24 @@ namespace dw_stl
         // 未超出容量且插入位置在end处
         if (end_ != cap_ && xpos == end_)
         {
-            data_allocator::construct(dw_stl::address_of(*end_), value);
+            alloc_traits::construct(this->alloc(), dw_stl::address_of(*end_), value);
+            ++end_;
+        }
+        // 插入位置不在end处，元素可以按字节迁移
+        else if (end_ != cap_ && can_relocate::value)
+        {
+            raw_storage buf;
+            auto tmp = reinterpret_cast<T*>(&buf);
+            alloc_traits::construct(this->alloc(), tmp, value);
+            dw_stl::uninitialized_relocate(xpos, end_, xpos + 1);
+            dw_stl::uninitialized_relocate(tmp, tmp + 1, xpos);
             ++end_;
         }
         // 插入位置不在end处
         else if(end_ != cap_)
         {
             auto new_end = end_;
-            data_allocator::construct(dw_stl::address_of(*end_), *(end_ - 1));
+            alloc_traits::construct(this->alloc(), dw_stl::address_of(*end_), *(end_ - 1));
             ++new_end;
             auto value_copy = value;    // 避免元素因为下面的复制被改变
             dw_stl::copy_backward(xpos, end_ - 1, end_);
@@ -517,33 +822,52 @@ namespace dw_stl
     }
 
     // 删除pos位置上的元素
-    template <class T>
-    typename vector<T>::iterator vector<T>::erase(const_iterator pos)
+    template <class T, class Alloc, class Growth>
+    typename vector<T, Alloc, Growth>::iterator vector<T, Alloc, Growth>::erase(const_iterator pos)
     {
         DW_STL_DEBUG(pos >= begin() && pos < end());
         iterator xpos = begin_ + (pos - begin());
-        dw_stl::move(xpos + 1, end_, xpos);
-        data_allocator::destroy(end_ - 1);
+        if (can_relocate::value)
+        {
+            // 析构被删除的元素，后面的元素整块前移
+            alloc_traits::destroy(this->alloc(), xpos);
+            dw_stl::uninitialized_relocate(xpos + 1, end_, xpos);
+        }
+        else
+        {
+            dw_stl::move(xpos + 1, end_, xpos);
+            alloc_traits::destroy(this->alloc(), end_ - 1);
+        }
         --end_;
         return xpos;
     }
 
     // 删除[first, last)上的元素
-    template <class T>
-    typename vector<T>::iterator vector<T>::erase(const_iterator first, const_iterator last)
+    template <class T, class Alloc, class Growth>
+    typename vector<T, Alloc, Growth>::iterator vector<T, Alloc, Growth>::erase(const_iterator first, const_iterator last)
     {
         DW_STL_DEBUG(first >= begin() && last <= end() && !(last < first));
         const auto n = first - begin();
+        if (first == last)
+            return begin_ + n;
         iterator r = begin_ + (first - begin());
-        // 只是元素的析构，空间还是存在的
-        data_allocator::destroy(dw_stl::move(r + (last - first), end_, r), end_);
+        if (can_relocate::value)
+        {
+            alloc_traits::destroy(this->alloc(), r, r + (last - first));
+            dw_stl::uninitialized_relocate(r + (last - first), end_, r);
+        }
+        else
+        {
+            // 只是元素的析构，空间还是存在的
+            alloc_traits::destroy(this->alloc(), dw_stl::move(r + (last - first), end_, r), end_);
+        }
         end_ = end_ - (last - first);
         return begin_ + n;
     }
 
     // 重载容器大小
-    template <class T>
-    void vector<T>::resize(size_type new_size, const value_type& value)
+    template <class T, class Alloc, class Growth>
+    void vector<T, Alloc, Growth>::resize(size_type new_size, const value_type& value)
     {
         if (new_size < size())
         {
@@ -555,14 +879,29 @@ namespace dw_stl
         }
     }
 
+    // 重载容器大小，新增的元素默认初始化
+    template <class T, class Alloc, class Growth>
+    void vector<T, Alloc, Growth>::resize_default_init(size_type new_size)
+    {
+        if (new_size < size())
+        {
+            erase(begin() + new_size, end());
+            return;
+        }
+        const auto n = new_size - size();
+        reserve_extra(n);
+        end_ = dw_stl::uninitialized_default_construct_n(end_, n);
+    }
+
     // 与另一个vector进行交换
-    template <class T>
-    void vector<T>::swap(vector<T>& rhs) noexcept
+    template <class T, class Alloc, class Growth>
+    void vector<T, Alloc, Growth>::swap(vector& rhs) noexcept
     {
         // 将两个容器的迭代器相互交换
         if (this != &rhs)
         {
-            // 交换指针即可
+            // 交换指针即可, 分配器按照传播规则交换
+            dw_stl::alloc_on_swap(this->alloc(), rhs.alloc());
             dw_stl::swap(begin_, rhs.begin_);
             dw_stl::swap(end_, rhs.end_);
             dw_stl::swap(cap_, rhs.cap_);
@@ -573,33 +912,19 @@ namespace dw_stl
     // 下面是实现接口用到的一些辅助函数
     /****************************************************************************/
 
-    // try_init函数，如果分配失败则忽略，不抛出异常
-    template <class T>
-    void vector<T>::try_init() noexcept
+    // init_space函数，cap为0时不分配空间
+    template <class T, class Alloc, class Growth>
+    void vector<T, Alloc, Growth>::init_space(size_type size, size_type cap)
     {
-        try
+        if (cap == 0)
         {
-            begin_ = data_allocator::allocate(16);
-            end_ = begin_;
-            cap_ = begin_ + 16;
-        }
-        catch (...)
-        {
-            begin_ = nullptr;
-            end_ = nullptr;
-            cap_ = nullptr;
-            // 在当前函数捕获，不抛出异常
+            begin_ = end_ = cap_ = nullptr;
+            return;
         }
-    }
-
-    // init_space函数
-    template <class T>
-    void vector<T>::init_space(size_type size, size_type cap)
-    {
         try 
         {
             // 分配空间
-            begin_ = data_allocator::allocate(cap);
+            begin_ = alloc_traits::allocate(this->alloc(), cap);
             end_ = begin_ + size;
             cap_ = begin_ + cap;
         }
@@ -612,65 +937,106 @@ namespace dw_stl
         }
     }
 
-    // fill_init函数
+    // value的每个字节都为零时可以直接使用清零的内存(-0.0等非零位模式除外)
+    template <class T>
+    bool is_zero_bits(const T& value, std::true_type) noexcept
+    {
+        const unsigned char* p = reinterpret_cast<const unsigned char*>(&value);
+        for (size_t i = 0; i < sizeof(T); ++i)
+        {
+            if (p[i] != 0)
+                return false;
+        }
+        return true;
+    }
+
     template <class T>
-    void vector<T>::fill_init(size_type n, const value_type& value)
+    bool is_zero_bits(const T&, std::false_type) noexcept
+    {
+        return false;
+    }
+
+    // fill_init函数
+    template <class T, class Alloc, class Growth>
+    void vector<T, Alloc, Growth>::fill_init(size_type n, const value_type& value)
     {
-        const size_type init_size = dw_stl::max(static_cast<size_type>(16), n);
-        // 首先分配空间
-        init_space(n, init_size);
+        if (dw_stl::is_zero_bits(value, dw_stl::is_zero_initializable<T>{}))
+        {
+            zero_init(n);
+            return;
+        }
+        // 首先分配恰好n个元素的空间
+        init_space(n, n);
         // 调用函数对未初始化空间进行填充
         dw_stl::uninitialized_fill_n(begin_, n, value);
     }
 
+    // zero_init函数，由分配器直接提供清零的内存(calloc或者新映射的页面)，不再逐个填充
+    template <class T, class Alloc, class Growth>
+    void vector<T, Alloc, Growth>::zero_init(size_type n)
+    {
+        begin_ = end_ = cap_ = nullptr;
+        if (n == 0)
+            return;
+        begin_ = alloc_traits::allocate_zeroed(this->alloc(), n);
+        end_ = cap_ = begin_ + n;
+    }
+
     // range_init函数
-    template <class T>
-    template <class Iter>
-    void vector<T>::range_init(Iter first, Iter last)
+    template <class T, class Alloc, class Growth>
+    template <class InputIter>
+    void vector<T, Alloc, Growth>::range_init(InputIter first, InputIter last, input_iterator_tag)
+    {
+        try
+        {
+            append_input(first, last);
+        }
+        catch (...)
+        {
+            destroy_and_recover(begin_, end_, capacity());
+            throw;
+        }
+    }
+
+    template <class T, class Alloc, class Growth>
+    template <class FIter>
+    void vector<T, Alloc, Growth>::range_init(FIter first, FIter last, forward_iterator_tag)
     {
-        const size_type init_size = dw_stl::max(static_cast<size_type>(last - first),
-                                                static_cast<size_type>(16));
-        init_space(static_cast<size_type>(last - first), init_size);
+        const size_type n = static_cast<size_type>(dw_stl::distance(first, last));
+        init_space(n, n);
         // 调用未初始化函数对未初始化空间进行拷贝
         dw_stl::uninitialized_copy(first, last, begin_);
     }
 
     // destroy_and_recover函数
-    template <class T>
-    void vector<T>::destroy_and_recover(iterator first, iterator last, size_type n)
+    template <class T, class Alloc, class Growth>
+    void vector<T, Alloc, Growth>::destroy_and_recover(iterator first, iterator last, size_type n)
     {
+        if (first == nullptr)
+            return;
         // 首先调用析构函数, 如果不调用析构函数，那么申请的一些区域无法被释放
-        data_allocator::destroy(first, last);
+        alloc_traits::destroy(this->alloc(), first, last);
         // 然后撤销分配的空间, 从first开始的n个区域
-        data_allocator::deallocate(first, n);
+        alloc_traits::deallocate(this->alloc(), first, n);
     }
 
-    // get_new_cap函数
-    template <class T>
-    typename vector<T>::size_type vector<T>::get_new_cap(size_type add_size)
+    // get_new_cap函数，新的容量由扩容策略决定，第一次分配至少vector_init_cap<T>::value个元素
+    template <class T, class Alloc, class Growth>
+    typename vector<T, Alloc, Growth>::size_type vector<T, Alloc, Growth>::get_new_cap(size_type add_size)
     {
-        const auto old_size = capacity();
-        THROW_LENGTH_ERROR_IF(old_size > max_size() - add_size, "vector<T> size too big");
-        if (old_size > max_size() - old_size / 2)
-        {
-            return old_size + add_size > max_size() - 16
-                ? old_size + add_size : old_size + add_size + 16;
-        }
-        // 以1.5倍扩容方式进行扩容
-        const size_type new_size = old_size == 0
-            ? dw_stl::max(add_size, static_cast<size_type>(16))
-            : dw_stl::max(old_size + old_size / 2, old_size + add_size);
-        return new_size;
+        THROW_LENGTH_ERROR_IF(size() > max_size() - add_size, "vector<T> size too big");
+        return Growth::grow(capacity(), size() + add_size,
+                            static_cast<size_type>(vector_init_cap<T>::value), max_size());
     }
 
     // fill_assign函数
-    template <class T>
-    void vector<T>::fill_assign(size_type n, const value_type& value)
+    template <class T, class Alloc, class Growth>
+    void vector<T, Alloc, Growth>::fill_assign(size_type n, const value_type& value)
     {
         // 如果插入的数量超过了容器容量
         if (n > capacity())
         {
-            vector tmp(n, value);
+            vector tmp(n, value, this->alloc());
             swap(tmp);
         }
         // 如果插入的数量超过当前容器的元素数量
@@ -686,9 +1052,9 @@ namespace dw_stl
     }
 
     // copy_assign函数
-    template <class T>
+    template <class T, class Alloc, class Growth>
     template <class InputIter>
-    void vector<T>::copy_assign(InputIter first, InputIter last, input_iterator_tag)
+    void vector<T, Alloc, Growth>::copy_assign(InputIter first, InputIter last, input_iterator_tag)
     {
         auto cur = begin_;
         // 首先将first -> end的数据复制完
@@ -697,27 +1063,27 @@ namespace dw_stl
         if (first == last)
             erase(cur, end_);
         else
-            // 再从end_处开始插入, 插入的元素从[first, last)
-            insert(end_, first, last);
+            // 再从end_处追加剩下的元素
+            append_input(first, last);
     }
 
     // 使用[first, last)为容器赋值
-    template <class T>
+    template <class T, class Alloc, class Growth>
     template <class ForwardIter>
-    void vector<T>::copy_assign(ForwardIter first, ForwardIter last, forward_iterator_tag)
+    void vector<T, Alloc, Growth>::copy_assign(ForwardIter first, ForwardIter last, forward_iterator_tag)
     {
         const size_type len = dw_stl::distance(first, last);
         // 如果大于当前容量
         if(len > capacity())
         {
-            vector tmp(first, last);
+            vector tmp(first, last, this->alloc());
             swap(tmp);
         }
         else if(size() >= len)
         {
             // 需要将多余的部分删去
             auto new_end = dw_stl::copy(first, last, begin_);
-            data_allocator::destroy(new_end, end_);
+            alloc_traits::destroy(this->alloc(), new_end, end_);
             end_ = new_end;
         }
         else 
@@ -732,28 +1098,47 @@ namespace dw_stl
     }
 
     // 重新分配空间，并在pos处就地构造元素
-    template <class T>
+    template <class T, class Alloc, class Growth>
     template <class ...Args>
-    void vector<T>::reallocate_emplace(iterator pos, Args&& ...args)
+    void vector<T, Alloc, Growth>::reallocate_emplace(iterator pos, Args&& ...args)
     {
+        // 元素可以平凡复制时，先尝试由分配器直接扩容
+        if (expand_emplace(can_expand{}, pos, dw_stl::forward<Args>(args)...))
+            return;
         // 重新分配的空间大小
-        const auto new_size = get_new_cap(1);
+        auto new_size = get_new_cap(1);
         // allocate分配空间
-        auto new_begin = data_allocator::allocate(new_size);
+        auto new_begin = allocate_cap(new_size);
+        if (can_relocate::value)
+        {
+            // 先在新空间构造新元素(参数可能引用原来的元素)，再整块迁移原来的元素
+            try
+            {
+                alloc_traits::construct(this->alloc(), new_begin + (pos - begin_), dw_stl::forward<Args>(args)...);
+            }
+            catch (...)
+            {
+                alloc_traits::deallocate(this->alloc(), new_begin, new_size);
+                throw;
+            }
+            relocate_to(new_begin, new_size, pos, 1);
+            return;
+        }
         auto new_end = new_begin;
         try 
         {
             // 将原来元素移动到新空间中
             new_end = dw_stl::uninitialized_move(begin_, pos, new_begin);
             // 在pos处构造元素
-            data_allocator::construct(dw_stl::address_of(*new_end), dw_stl::forward<Args>(args)...);
+            alloc_traits::construct(this->alloc(), dw_stl::address_of(*new_end), dw_stl::forward<Args>(args)...);
             ++new_end;
             // pos之后的元素移动
             new_end = dw_stl::uninitialized_move(pos, end_, new_end);
         }
         catch (...)
         {
-            data_allocator::deallocate(new_begin, new_size);
+            alloc_traits::deallocate(this->alloc(), new_begin, new_size);
+            throw;
         }
         // 将原来空间的元素销毁
         destroy_and_recover(begin_, end_, cap_ - begin_);
@@ -764,11 +1149,27 @@ namespace dw_stl
     }
 
     // 重新分配空间并在pos处插入元素
-    template <class T>
-    void vector<T>::reallocate_insert(iterator pos, const value_type& value)
+    template <class T, class Alloc, class Growth>
+    void vector<T, Alloc, Growth>::reallocate_insert(iterator pos, const value_type& value)
     {
-        const auto new_size = get_new_cap(1);
-        auto new_begin = data_allocator::allocate(new_size);
+        if (expand_emplace(can_expand{}, pos, value))
+            return;
+        auto new_size = get_new_cap(1);
+        auto new_begin = allocate_cap(new_size);
+        if (can_relocate::value)
+        {
+            try
+            {
+                alloc_traits::construct(this->alloc(), new_begin + (pos - begin_), value);
+            }
+            catch (...)
+            {
+                alloc_traits::deallocate(this->alloc(), new_begin, new_size);
+                throw;
+            }
+            relocate_to(new_begin, new_size, pos, 1);
+            return;
+        }
         auto new_end = new_begin;
         const value_type& value_copy = value;
         try 
@@ -776,14 +1177,14 @@ namespace dw_stl
             // 将原来begin_到pos处的元素移动到new_begin开始的内存
             new_end = dw_stl::uninitialized_move(begin_, pos, new_begin);
             // 在pos处构造元素
-            data_allocator::construct(dw_stl::address_of(*new_end), value_copy);
+            alloc_traits::construct(this->alloc(), dw_stl::address_of(*new_end), value_copy);
             ++new_end;
             // 将pos到end_的元素移动到新区域
             new_end = dw_stl::uninitialized_move(pos, end_, new_end);
         }
         catch (...)
         {
-            data_allocator::deallocate(new_begin, new_size);
+            alloc_traits::deallocate(this->alloc(), new_begin, new_size);
             throw;
         }
         destroy_and_recover(begin_, end_, cap_ - begin_);
@@ -792,28 +1193,113 @@ namespace dw_stl
         cap_ = new_begin + new_size;
     }
 
+    // expand_storage函数, 由分配器把空间改为new_cap个单元，元素按字节保留
+    template <class T, class Alloc, class Growth>
+    bool vector<T, Alloc, Growth>::expand_storage(size_type new_cap, std::true_type)
+    {
+        if (begin_ == nullptr)
+            return false;
+        const size_type old_size = size();
+        auto new_begin = alloc_traits::reallocate(this->alloc(), begin_, capacity(), new_cap);
+        if (new_begin == nullptr)
+            return false;
+        begin_ = new_begin;
+        end_ = new_begin + old_size;
+        cap_ = new_begin + new_cap;
+        return true;
+    }
+
+    // expand_emplace函数, 扩容之后在pos处构造元素
+    // 先由分配器原地扩充(realloc/mremap)，失败时重新分配空间并整块迁移，不逐个移动元素
+    template <class T, class Alloc, class Growth>
+    template <class ...Args>
+    bool vector<T, Alloc, Growth>::expand_emplace(std::true_type, iterator pos, Args&& ...args)
+    {
+        if (begin_ == nullptr)
+            return false;
+        // get_new_cap可能抛出异常，在构造临时元素之前计算
+        auto new_size = get_new_cap(1);
+        // 参数可能引用vector内部的元素，扩容之后会失效，因此先在临时空间构造新元素
+        raw_storage buf;
+        auto tmp = reinterpret_cast<T*>(&buf);
+        alloc_traits::construct(this->alloc(), tmp, dw_stl::forward<Args>(args)...);
+        const size_type xpos = pos - begin_;
+        if (expand_storage(new_size, std::true_type{}))
+        {
+            dw_stl::uninitialized_relocate(begin_ + xpos, end_, begin_ + xpos + 1);
+            ++end_;
+        }
+        else
+        {
+            iterator new_begin = nullptr;
+            try
+            {
+                new_begin = allocate_cap(new_size);
+            }
+            catch (...)
+            {
+                alloc_traits::destroy(this->alloc(), tmp);
+                throw;
+            }
+            relocate_to(new_begin, new_size, begin_ + xpos, 1);
+        }
+        dw_stl::uninitialized_relocate(tmp, tmp + 1, begin_ + xpos);
+        return true;
+    }
+
+    // relocate_to函数, 按字节迁移元素到新空间，原来的元素不需要析构
+    template <class T, class Alloc, class Growth>
+    void vector<T, Alloc, Growth>::relocate_to(iterator new_begin, size_type new_cap, iterator pos, size_type n)
+    {
+        const size_type xpos = pos - begin_;
+        const size_type old_size = size();
+        dw_stl::uninitialized_relocate(begin_, pos, new_begin);
+        dw_stl::uninitialized_relocate(pos, end_, new_begin + xpos + n);
+        if (begin_ != nullptr)
+            alloc_traits::deallocate(this->alloc(), begin_, cap_ - begin_);
+        begin_ = new_begin;
+        end_ = new_begin + old_size + n;
+        cap_ = new_begin + new_cap;
+    }
+
     // fill_insert函数, 从pos处开始插入n个数
-    template <class T>
-    typename vector<T>::iterator vector<T>::fill_insert(iterator pos, size_type n, const value_type& value)
+    template <class T, class Alloc, class Growth>
+    typename vector<T, Alloc, Growth>::iterator vector<T, Alloc, Growth>::fill_insert(iterator pos, size_type n, const value_type& value)
     {
         if (n == 0)
             return pos;
         const size_type xpos = pos - begin_;
         const value_type value_copy = value;
+        // 空闲空间足够并且元素可以按字节迁移，后面的元素整块后移
+        if (static_cast<size_type>(cap_ - end_) >= n && can_relocate::value)
+        {
+            dw_stl::uninitialized_relocate(pos, end_, pos + n);
+            try
+            {
+                dw_stl::uninitialized_fill_n(pos, n, value_copy);
+            }
+            catch (...)
+            {
+                dw_stl::uninitialized_relocate(pos + n, end_ + n, pos);
+                throw;
+            }
+            end_ += n;
+        }
         // 如果空闲空间足够放下n个元素
-        if (static_cast<size_type>(cap_ - end_) >= n)
+        else if (static_cast<size_type>(cap_ - end_) >= n)
         {
             const size_type after_elems = end_ - pos;
             auto old_end = end_;
             // 如果从当前到end_处足够放下新增元素
             if (after_elems > n)
             {
-                // 将end_ - n到end_的元素拷贝到从end_开始的位置
-                dw_stl::uninitialized_copy(end_ - n, end_, end_);
+                // 将end_ - n到end_的元素移动到从end_开始的位置
+                dw_stl::uninitialized_move(end_ - n, end_, end_);
                 end_ += n;
                 // 将pos到old_end - n处的元素移动到以old_end结尾的位置
                 dw_stl::move_backward(pos, old_end - n, old_end);
-                dw_stl::uninitialized_fill_n(pos, n, value_copy);
+                // [pos, pos + n)上的元素已经被移走但是仍然存在，只能赋值
+                dw_stl::fill_n(pos, n, value_copy);
             }
             // 如果从pos到end_的空间不够放下新增元素
             else
@@ -822,15 +1308,32 @@ namespace dw_stl
                 end_ = dw_stl::uninitialized_fill_n(end_, n - after_elems, value_copy);
                 // 然后将从pos到ols_end的元素移动到从新的end_位置开始的区域
                 end_ = dw_stl::uninitialized_move(pos, old_end, end_);
-                dw_stl::uninitialized_fill_n(pos, after_elems, value_copy);
+                dw_stl::fill_n(pos, after_elems, value_copy);
             }
         }
         else 
         {
             // 空闲空间不足
             // 扩容
-            const auto new_size = get_new_cap(n);
-            auto new_begin = data_allocator::allocate(new_size);
+            auto new_size = get_new_cap(n);
+            // 由分配器原地扩充成功之后，空闲空间已经足够
+            if (expand_storage(new_size, can_expand{}))
+                return fill_insert(begin_ + xpos, n, value_copy);
+            auto new_begin = allocate_cap(new_size);
+            if (can_relocate::value)
+            {
+                try
+                {
+                    dw_stl::uninitialized_fill_n(new_begin + xpos, n, value_copy);
+                }
+                catch (...)
+                {
+                    alloc_traits::deallocate(this->alloc(), new_begin, new_size);
+                    throw;
+                }
+                relocate_to(new_begin, new_size, pos, n);
+                return begin_ + xpos;
+            }
             auto new_end = new_begin;
             try 
             {
@@ -843,7 +1346,7 @@ namespace dw_stl
                 destroy_and_recover(new_begin, new_end, new_size);
                 throw;
             }
-            data_allocator::deallocate(begin_, cap_ - begin_);
+            destroy_and_recover(begin_, end_, cap_ - begin_);
             begin_ = new_begin;
             end_ = new_end;
             cap_ = begin_ + new_size;
@@ -853,23 +1356,39 @@ namespace dw_stl
     }
 
     // copy_insert函数, 将[first, last)的值拷贝到pos开始的内存区域
-    template <class T>
-    template <class InputIter>
-    void vector<T>::copy_insert(iterator pos, InputIter first, InputIter last)
+    template <class T, class Alloc, class Growth>
+    template <class FIter>
+    void vector<T, Alloc, Growth>::copy_insert(iterator pos, FIter first, FIter last)
     {
         if (first == last)
             return;
         const auto n = dw_stl::distance(first, last);
-        if ((cap_ - end_) >= n)
+        if ((cap_ - end_) >= n && can_relocate::value)
+        {
+            // 元素可以按字节迁移，后面的元素整块后移
+            dw_stl::uninitialized_relocate(pos, end_, pos + n);
+            try
+            {
+                dw_stl::uninitialized_copy(first, last, pos);
+            }
+            catch (...)
+            {
+                dw_stl::uninitialized_relocate(pos + n, end_ + n, pos);
+                throw;
+            }
+            end_ += n;
+        }
+        else if ((cap_ - end_) >= n)
         {
             // 如果备用空间大小足够
             const auto after_elems = end_ -  pos;
             auto old_end = end_;
             if (after_elems > n)
             {
-                end_ = dw_stl::uninitialized_copy(end_ - n, end_, end_);
+                end_ = dw_stl::uninitialized_move(end_ - n, end_, end_);
                 dw_stl::move_backward(pos, old_end - n, old_end);
-                dw_stl::uninitialized_copy(first, last, pos);
+                // [pos, pos + n)上的元素已经被移走但是仍然存在，只能赋值
+                dw_stl::copy(first, last, pos);
             }
             else 
             {
@@ -877,14 +1396,34 @@ namespace dw_stl
                 dw_stl::advance(mid, after_elems);
                 end_ = dw_stl::uninitialized_copy(mid, last, end_);
                 end_ = dw_stl::uninitialized_move(pos, old_end, end_);
-                dw_stl::uninitialized_copy(first, mid, pos);
+                dw_stl::copy(first, mid, pos);
             }
         }
         else 
         {
             // 备用空间不足
-            const auto new_size = get_new_cap();
-            auto new_begin = data_allocator::allocate(new_size);
+            auto new_size = get_new_cap(static_cast<size_type>(n));
+            const auto xpos = pos - begin_;
+            if (expand_storage(new_size, can_expand{}))
+            {
+                copy_insert(begin_ + xpos, first, last);
+                return;
+            }
+            auto new_begin = allocate_cap(new_size);
+            if (can_relocate::value)
+            {
+                try
+                {
+                    dw_stl::uninitialized_copy(first, last, new_begin + xpos);
+                }
+                catch (...)
+                {
+                    alloc_traits::deallocate(this->alloc(), new_begin, new_size);
+                    throw;
+                }
+                relocate_to(new_begin, new_size, pos, static_cast<size_type>(n));
+                return;
+            }
             auto new_end = new_begin;
             try 
             {
@@ -897,28 +1436,82 @@ namespace dw_stl
                 destroy_and_recover(new_begin, new_end, new_size);
                 throw;
             }
-            data_allocator::deallocate(begin_, cap_ - begin_);
+            destroy_and_recover(begin_, end_, cap_ - begin_);
             begin_ = new_begin;
             end_ = new_end;
             cap_ = begin_ + new_size;
         }
     }
 
+    // append_input函数
+    template <class T, class Alloc, class Growth>
+    template <class InputIter>
+    void vector<T, Alloc, Growth>::append_input(InputIter first, InputIter last)
+    {
+        while (first != last)
+        {
+            if (end_ == cap_)
+                reserve(get_new_cap(1));
+            // 这一段不再检查容量，只检查区间是否结束
+            for (; first != last && end_ != cap_; ++first, ++end_)
+                alloc_traits::construct(this->alloc(), end_, *first);
+        }
+    }
+
+    // range_insert函数，输入迭代器的版本
+    template <class T, class Alloc, class Growth>
+    template <class InputIter>
+    typename vector<T, Alloc, Growth>::iterator
+    vector<T, Alloc, Growth>::range_insert(iterator pos, InputIter first, InputIter last, input_iterator_tag)
+    {
+        const size_type off = static_cast<size_type>(pos - begin_);
+        const size_type old_size = size();
+        try
+        {
+            append_input(first, last);
+        }
+        catch (...)
+        {
+            // 删除已经追加的元素，原来的元素不变
+            erase(begin_ + old_size, end_);
+            throw;
+        }
+        if (off != old_size)
+            dw_stl::rotate(begin_ + off, begin_ + old_size, end_);
+        return begin_ + off;
+    }
+
+    // range_insert函数，前向迭代器的版本，最多重新分配一次
+    template <class T, class Alloc, class Growth>
+    template <class FIter>
+    typename vector<T, Alloc, Growth>::iterator
+    vector<T, Alloc, Growth>::range_insert(iterator pos, FIter first, FIter last, forward_iterator_tag)
+    {
+        const size_type off = static_cast<size_type>(pos - begin_);
+        copy_insert(pos, first, last);
+        return begin_ + off;
+    }
+
     // reinsert函数
-    template <class T>
-    void vector<T>::reinsert(size_type size)
+    template <class T, class Alloc, class Growth>
+    void vector<T, Alloc, Growth>::reinsert(size_type size)
     {
-        auto new_begin = data_allocator::allocate(size);
+        auto new_begin = alloc_traits::allocate(this->alloc(), size);
+        if (can_relocate::value)
+        {
+            relocate_to(new_begin, size, end_, 0);
+            return;
+        }
         try
         {
             dw_stl::uninitialized_move(begin_, end_, new_begin);
         }
         catch (...)
         {
-            data_allocator::deallocate(new_begin, size);
+            alloc_traits::deallocate(this->alloc(), new_begin, size);
             throw;
         }
-        data_allocator::deallocate(begin_, cap_ - begin_);
+        destroy_and_recover(begin_, end_, cap_ - begin_);
         begin_ = new_begin;
         end_ = begin_ + size;
         cap_ = begin_ + size;
@@ -926,49 +1519,53 @@ namespace dw_stl
 
     /**********************************************************************/
     // 重载比较操作符
-    template <class T>
-    bool operator==(const vector<T>& lhs, const vector<T>& rhs)
+    template <class T, class Alloc, class Growth>
+    bool operator==(const vector<T, Alloc, Growth>& lhs, const vector<T, Alloc, Growth>& rhs)
     {
         return lhs.size() == rhs.size() &&
             dw_stl::equal(lhs.begin(), lhs.end(), rhs.begin());
     }
 
-    template <class T>
-    bool operator<(const vector<T>& lhs, const vector<T>& rhs)
+    template <class T, class Alloc, class Growth>
+    bool operator<(const vector<T, Alloc, Growth>& lhs, const vector<T, Alloc, Growth>& rhs)
     {
         return dw_stl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
     }
 
-    template <class T>
-    bool operator!=(const vector<T>& lhs, const vector<T>& rhs)
+    template <class T, class Alloc, class Growth>
+    bool operator!=(const vector<T, Alloc, Growth>& lhs, const vector<T, Alloc, Growth>& rhs)
     {
         return !(lhs == rhs);
     }
 
-    template <class T>
-    bool operator>(const vector<T>& lhs, const vector<T>& rhs)
+    template <class T, class Alloc, class Growth>
+    bool operator>(const vector<T, Alloc, Growth>& lhs, const vector<T, Alloc, Growth>& rhs)
     {
         return rhs < lhs;
     }
 
-    template <class T>
-    bool operator<=(const vector<T>& lhs, const vector<T>& rhs)
+    template <class T, class Alloc, class Growth>
+    bool operator<=(const vector<T, Alloc, Growth>& lhs, const vector<T, Alloc, Growth>& rhs)
     {
         return !(rhs < lhs);
     }
 
-    template <class T>
-    bool operator>=(const vector<T>& lhs, const vector<T>& rhs)
+    template <class T, class Alloc, class Growth>
+    bool operator>=(const vector<T, Alloc, Growth>& lhs, const vector<T, Alloc, Growth>& rhs)
     {
         return !(lhs < rhs);
     }
 
     // 重载swap
-    template <class T>
-    void swap(vector<T>& lhs, vector<T>& rhs)
+    template <class T, class Alloc, class Growth>
+    void swap(vector<T, Alloc, Growth>& lhs, vector<T, Alloc, Growth>& rhs)
     {
         lhs.swap(rhs);
     }
+
+    // vector只保存指向堆空间的指针，分配器可以按字节迁移时vector也可以
+    template <class T, class Alloc, class Growth>
+    struct is_trivially_relocatable<vector<T, Alloc, Growth>> : is_trivially_relocatable<Alloc> {};
 }
 
-#endif
\ No newline at end of file
+#endif